@@ -154,6 +154,14 @@ class abstract_actor : public abstract_channel {
    */
   virtual std::set<std::string> message_types() const;
 
+  /**
+   * Returns an approximation of the number of messages waiting in the
+   * mailbox of this actor or 0 if this actor does not have a mailbox.
+   * @note The result is a hint for load balancing and may be outdated
+   *       by the time the caller inspects it.
+   */
+  virtual size_t mailbox_size_hint() const;
+
   /**
    * Returns the execution unit currently used by this actor.
    * @warning not thread safe
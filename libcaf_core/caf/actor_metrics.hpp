@@ -0,0 +1,104 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_ACTOR_METRICS_HPP
+#define CAF_ACTOR_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/fwd.hpp"
+
+namespace caf {
+
+/**
+ * A snapshot of the runtime metrics of a single actor.
+ */
+struct actor_metrics {
+  /**
+   * Identifies the actor.
+   */
+  actor_id id;
+
+  /**
+   * Approximates the number of messages waiting in the mailbox,
+   * not including messages the actor has skipped.
+   */
+  size_t mailbox_size;
+
+  /**
+   * Counts the messages consumed by the actor so far.
+   */
+  uint64_t processed_messages;
+
+  /**
+   * Counts how often the actor skipped a message and moved it to its cache.
+   */
+  uint64_t skipped_messages;
+
+  /**
+   * Stores the time spent in message handlers so far.
+   */
+  std::chrono::nanoseconds processing_time;
+};
+
+/**
+ * Enables or disables collecting metrics for actors launched afterwards.
+ * Metrics are disabled by default, since recording them causes a small
+ * overhead for each processed message.
+ * @relates actor_metrics
+ */
+void set_actor_metrics_enabled(bool value);
+
+/**
+ * Returns whether newly launched actors collect metrics.
+ * @relates actor_metrics
+ */
+bool actor_metrics_enabled();
+
+/**
+ * Returns the metrics of all running actors collecting metrics.
+ * @relates actor_metrics
+ */
+std::vector<actor_metrics> actor_metrics_snapshot();
+
+/**
+ * Converts `xs` to a table with one line per actor,
+ * sorted by mailbox size in descending order.
+ * @relates actor_metrics
+ */
+std::string to_string(const std::vector<actor_metrics>& xs);
+
+namespace detail {
+
+// counters stored in each actor collecting metrics; only the actor
+// itself writes to the counters but all threads may read them
+struct actor_metrics_counters {
+  std::atomic<uint64_t> processed_messages{0};
+  std::atomic<uint64_t> skipped_messages{0};
+  std::atomic<uint64_t> processing_time{0}; // in nanoseconds
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_ACTOR_METRICS_HPP
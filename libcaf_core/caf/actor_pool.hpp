@@ -27,6 +27,7 @@
 
 #include "caf/locks.hpp"
 #include "caf/actor.hpp"
+#include "caf/duration.hpp"
 #include "caf/abstract_actor.hpp"
 #include "caf/mailbox_element.hpp"
 
@@ -55,6 +56,12 @@ namespace caf {
  * during the enqueue operation. Any user-defined policy thus has to dispatch
  * messages with as little overhead as possible, because the dispatching
  * runs in the context of the sender.
+ *
+ * An *elastic* pool, i.e., a pool created with an `elasticity` setting,
+ * spawns new workers from its factory whenever the workers fall behind
+ * and retires idle workers after a cool-down period. Elastic pools
+ * periodically send messages to themselves and thus must be terminated
+ * explicitly by sending an exit message.
  */
 class actor_pool : public abstract_actor {
  public:
@@ -101,6 +108,89 @@ class actor_pool : public abstract_actor {
     std::random_device m_rd;
   };
 
+  /**
+   * Policy class implementing load-aware dispatching that selects the
+   * worker with the smallest number of queued messages. Ties are broken
+   * by rotating the starting position of the scan.
+   * @note The load of a worker is approximated via
+   *       `abstract_actor::mailbox_size_hint`.
+   */
+  class least_loaded {
+   public:
+    least_loaded();
+    least_loaded(const least_loaded&);
+    void operator()(uplock&, const actor_vec&,
+                    mailbox_element_ptr&, execution_unit*);
+
+   private:
+    std::atomic<size_t> m_pos;
+  };
+
+  /**
+   * Policy class implementing the "power of two random choices" strategy,
+   * i.e., it selects two workers at random and dispatches to the one
+   * with the smaller number of queued messages. This policy scales to large
+   * pools while still avoiding to pile up messages at a single worker.
+   */
+  class power_of_two_choices {
+   public:
+    power_of_two_choices();
+    power_of_two_choices(const power_of_two_choices&);
+    void operator()(uplock&, const actor_vec&,
+                    mailbox_element_ptr&, execution_unit*);
+
+   private:
+    // returns a pseudo-random number without requiring exclusive access
+    size_t next_random();
+
+    std::atomic<uint64_t> m_seed;
+  };
+
+  /**
+   * Policy class implementing affinity-based dispatching. Messages
+   * with the same key, as computed by a user-defined function, always
+   * go to the same worker as long as the set of workers does not change.
+   * Adding or removing a worker only remaps keys of that worker
+   * (rendezvous hashing).
+   */
+  class consistent_hash {
+   public:
+    using key_function = std::function<size_t (const message&)>;
+    consistent_hash(key_function fun);
+    void operator()(uplock&, const actor_vec&,
+                    mailbox_element_ptr&, execution_unit*);
+
+   private:
+    key_function m_key;
+  };
+
+  /**
+   * Configures the worker management of an elastic actor pool.
+   */
+  struct elasticity {
+    /**
+     * Minimum number of workers, must be at least 1.
+     */
+    size_t min_workers;
+
+    /**
+     * Maximum number of workers.
+     */
+    size_t max_workers;
+
+    /**
+     * Spawns a new worker whenever the average number of queued
+     * messages per worker exceeds this threshold.
+     */
+    size_t grow_threshold;
+
+    /**
+     * Retires one idle worker per cool-down period if the
+     * pool did not need to grow in the meantime. Must be positive.
+     */
+    duration cooldown;
+  };
+
   ~actor_pool();
 
   /**
@@ -114,6 +204,13 @@ class actor_pool : public abstract_actor {
    */
   static actor make(size_t n, factory fac, policy pol);
 
+  /**
+   * Returns an elastic actor pool starting with `cfg.min_workers` workers
+   * created by the factory function `fac` using the dispatch policy `pol`.
+   * @throws std::invalid_argument if `cfg` is not a valid configuration
+   */
+  static actor make(elasticity cfg, factory fac, policy pol);
+
   void enqueue(const actor_addr& sender, message_id mid,
                message content, execution_unit* host) override;
 
@@ -128,10 +225,27 @@ class actor_pool : public abstract_actor {
   // call without m_mtx held
   void quit();
 
+  // spawns a new worker if the pool is elastic and its workers fall behind;
+  // call without m_mtx held
+  void grow();
+
+  // retires an idle worker if the pool is elastic and did not grow since
+  // the last call; call with m_mtx held
+  void shrink(upgrade_lock<detail::shared_spinlock>& guard);
+
+  void request_tick();
+
   detail::shared_spinlock m_mtx;
   std::vector<actor> m_workers;
   policy m_policy;
   uint32_t m_planned_reason;
+
+  // only used by elastic pools
+  factory m_factory;
+  elasticity m_elasticity;
+  std::atomic<size_t> m_dispatched;
+  std::atomic<bool> m_growing;
+  std::atomic<bool> m_has_grown;
 };
 
 } // namespace caf
@@ -46,6 +46,8 @@
 #include "caf/to_string.hpp"
 #include "caf/actor_addr.hpp"
 #include "caf/actor_pool.hpp"
+#include "caf/actor_metrics.hpp"
+#include "caf/message_tracing.hpp"
 #include "caf/attachable.hpp"
 #include "caf/message_id.hpp"
 #include "caf/replies_to.hpp"
@@ -132,6 +132,12 @@ class behavior {
     return m_impl;
   }
 
+  // runs this handler on a message the caller discards after a match,
+  // i.e., handlers may move its elements into rvalue reference parameters
+  inline optional<message> consume(message& arg) {
+    return (m_impl) ? m_impl->invoke(arg, true) : none;
+  }
+
   inline behavior(impl_ptr ptr) : m_impl(std::move(ptr)) {
     // nop
   }
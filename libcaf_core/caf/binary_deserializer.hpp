@@ -56,6 +56,11 @@ class binary_deserializer : public deserializer {
    */
   void set_rdbuf(const void* begin, const void* m_end);
 
+  /**
+   * Returns the number of bytes left in the read buffer.
+   */
+  size_t remaining() const;
+
  private:
 
   const void* m_pos;
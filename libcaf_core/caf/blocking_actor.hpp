@@ -21,6 +21,7 @@
 #define CAF_BLOCKING_ACTOR_HPP
 
 #include <mutex>
+#include <memory>
 #include <condition_variable>
 
 #include "caf/none.hpp"
@@ -188,6 +189,8 @@ class blocking_actor
 
   /**
    * Blocks this actor until all other actors are done.
+   * @warning Blocks the worker thread of actors spawned
+   *          using the `context_switching` flag.
    */
   void await_all_other_actors_done();
 
@@ -202,6 +205,13 @@ class blocking_actor
 
   void dequeue(behavior& bhvr, message_id mid = invalid_message_id);
 
+  // calls act() and cleans up the actor afterwards
+  void act_and_cleanup();
+
+  // switches to the fiber of this actor and returns as soon as the actor
+  // either blocks, exceeds `max_throughput`, or finishes execution
+  resume_result resume_fiber(size_t max_throughput);
+
   /** @endcond */
 
  protected:
@@ -209,6 +219,20 @@ class blocking_actor
   std::function<void(behavior&)> make_dequeue_callback() {
     return [=](behavior& bhvr) { dequeue(bhvr); };
   }
+
+  // suspends the fiber of context-switching actors instead of blocking
+  void await_data() override;
+
+ private:
+  struct fiber_state;
+
+  static void fiber_main(void* ptr);
+
+  // yields control back to the worker running this actor
+  void yield(resume_result result);
+
+  // only used by context-switching actors
+  std::unique_ptr<fiber_state> m_fiber;
 };
 
 class blocking_actor::functor_based : public blocking_actor {
@@ -24,9 +24,11 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <vector>
 #include <cstdint>
 #include <condition_variable>
 
+#include "caf/actor_metrics.hpp"
 #include "caf/abstract_actor.hpp"
 #include "caf/detail/shared_spinlock.hpp"
 
@@ -75,6 +77,20 @@ class actor_registry : public singleton_mixin<actor_registry> {
   // blocks the caller until running-actors-count becomes `expected`
   void await_running_count_equal(size_t expected);
 
+  // returns whether actors collect metrics when launched
+  bool metrics_enabled() const;
+
+  void metrics_enabled(bool value);
+
+  // adds an actor to the set of actors included in metrics()
+  void add_metrics_source(const local_actor* ptr);
+
+  // removes an actor from the set of actors included in metrics()
+  void remove_metrics_source(actor_id key);
+
+  // returns a snapshot of the metrics of all registered sources
+  std::vector<actor_metrics> metrics() const;
+
  private:
   using entries = std::map<actor_id, value_type>;
 
@@ -88,6 +104,14 @@ class actor_registry : public singleton_mixin<actor_registry> {
 
   mutable detail::shared_spinlock m_instances_mtx;
   entries m_entries;
+
+  // set via metrics_enabled(bool), read without locking m_metrics_mtx
+  std::atomic<bool> m_metrics_enabled;
+
+  // guards m_metrics_sources and prevents actors from
+  // being destroyed while taking a metrics snapshot
+  mutable std::mutex m_metrics_mtx;
+  std::map<actor_id, const local_actor*> m_metrics_sources;
 };
 
 } // namespace detail
@@ -21,6 +21,8 @@
 #define CAF_DETAIL_BEHAVIOR_IMPL_HPP
 
 #include <tuple>
+#include <vector>
+#include <utility>
 #include <type_traits>
 
 #include "caf/none.hpp"
@@ -70,13 +72,21 @@ class behavior_impl : public ref_counted {
 
   behavior_impl(duration tout = duration{});
 
-  virtual bhvr_invoke_result invoke(message&);
+  inline bhvr_invoke_result invoke(message& arg) {
+    return invoke(arg, false);
+  }
 
   inline bhvr_invoke_result invoke(message&& arg) {
     message tmp(std::move(arg));
-    return invoke(tmp);
+    return invoke(tmp, true);
   }
 
+  /**
+   * Invokes the first matching case for `msg`. Allows moving elements of
+   * `msg` into rvalue reference parameters if `consume` is `true`.
+   */
+  virtual bhvr_invoke_result invoke(message& msg, bool consume);
+
   virtual void handle_timeout();
 
   inline const duration& timeout() const {
@@ -87,10 +97,63 @@ class behavior_impl : public ref_counted {
 
   pointer or_else(const pointer& other);
 
+  /**
+   * Minimum number of cases for building a dispatch index.
+   * Smaller behaviors use a linear scan, which is faster in this case.
+   */
+  static constexpr size_t min_indexed_cases = 8;
+
  protected:
+  // builds an index from type tokens and leading atom
+  // constants to candidate cases for [m_begin, m_end)
+  void init_dispatch_index();
+
   duration m_timeout;
   match_case_info* m_begin;
   match_case_info* m_end;
+
+ private:
+  // denotes the range [first, last) of m_candidates
+  struct candidate_list {
+    uint32_t first;
+    uint32_t last;
+  };
+
+  // candidates for messages starting with a particular atom
+  struct atom_entry {
+    atom_value atom;
+    candidate_list cases;
+  };
+
+  // candidates for a type token; messages starting with an atom listed in
+  // [atoms_first, atoms_last) of m_atom_dispatch use the atom's candidates
+  struct token_entry {
+    uint32_t type_token;
+    candidate_list cases;
+    uint32_t atoms_first;
+    uint32_t atoms_last;
+  };
+
+  template <class Predicate>
+  candidate_list add_candidates(Predicate p);
+
+  token_entry make_token_entry(bool any_token, uint32_t type_token);
+
+  candidate_list candidates(const message& msg) const;
+
+  // set if the behavior has enough cases for using the index
+  bool m_indexed;
+  // set if at least one case expects an atom constant as first element
+  bool m_has_atom_cases;
+  // sorted by type token
+  std::vector<token_entry> m_dispatch;
+  // sorted by atom value within each token entry
+  std::vector<atom_entry> m_atom_dispatch;
+  // stores candidates in their original order to preserve
+  // first-match semantics
+  std::vector<match_case_info*> m_candidates;
+  // candidates for type tokens without an entry, i.e., wildcard cases
+  token_entry m_fallback;
 };
 
 template <size_t Pos, size_t Size>
@@ -101,6 +164,9 @@ struct defaut_bhvr_impl_init {
     x.ptr = &std::get<Pos>(tup);
     x.has_wildcard = x.ptr->has_wildcard();
     x.type_token = x.ptr->type_token();
+    auto& la = x.ptr->leading_atom();
+    x.has_leading_atom = static_cast<bool>(la);
+    x.leading_atom = la ? *la : static_cast<atom_value>(0);
     defaut_bhvr_impl_init<Pos + 1, Size>::init(arr, tup);
   }
 };
@@ -145,6 +211,7 @@ class default_behavior_impl : public behavior_impl {
     defaut_bhvr_impl_init<0, num_cases>::init(m_arr, m_cases);
     m_begin = m_arr.data();
     m_end = m_begin + m_arr.size();
+    init_dispatch_index();
   }
 
   Tuple m_cases;
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_DETACHED_THREAD_POOL_HPP
+#define CAF_DETAIL_DETACHED_THREAD_POOL_HPP
+
+#include <memory>
+#include <cstddef>
+#include <functional>
+
+namespace caf {
+namespace detail {
+
+class singletons;
+
+/**
+ * Caches OS threads for running detached actors. A thread that finished
+ * its job waits up to ten seconds for a new one before terminating.
+ * The pool never keeps more than `max_idle_threads` idle threads around,
+ * but it does not limit the number of concurrently running threads.
+ */
+class detached_thread_pool {
+ public:
+  friend class singletons;
+
+  using job = std::function<void ()>;
+
+  /**
+   * Accumulates usage statistics of the pool.
+   */
+  struct statistics {
+    /**
+     * Number of jobs that were executed by a cached thread.
+     */
+    size_t hits;
+
+    /**
+     * Number of jobs that required a new thread.
+     */
+    size_t misses;
+
+    /**
+     * Number of threads currently waiting for a job.
+     */
+    size_t idle_threads;
+  };
+
+  static constexpr size_t default_max_idle_threads = 64;
+
+  /**
+   * Uses the default stack size of the platform.
+   */
+  static constexpr size_t default_stack_size = 0;
+
+  /**
+   * Creates a pool keeping up to `max_idle_threads` idle threads,
+   * using `stack_size` bytes of stack for each new thread.
+   */
+  detached_thread_pool(size_t max_idle_threads = default_max_idle_threads,
+                       size_t stack_size = default_stack_size);
+
+  ~detached_thread_pool();
+
+  /**
+   * Runs `f` in a cached thread or starts a new thread
+   * if no idle thread is available.
+   */
+  void run(job f);
+
+  /**
+   * Returns the current usage statistics of the pool.
+   */
+  statistics stats() const;
+
+  /** @cond PRIVATE */
+
+  // runs the job stored in `ptr` and then waits for new jobs;
+  // `ptr` is an owning pointer to a `launch_data` object
+  static void run_loop(void* ptr);
+
+  /** @endcond */
+
+ private:
+  struct state;
+
+  struct launch_data;
+
+  static detached_thread_pool* create_singleton();
+
+  void initialize();
+
+  // releases all idle threads and stops caching threads
+  void stop();
+
+  inline void dispose() {
+    delete this;
+  }
+
+  void start_thread(job f);
+
+  // the state is shared with all threads, because threads can still run
+  // actors after the pool itself has been disposed
+  std::shared_ptr<state> m_state;
+  size_t m_stack_size;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_DETACHED_THREAD_POOL_HPP
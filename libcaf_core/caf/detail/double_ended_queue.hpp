@@ -109,7 +109,7 @@ class double_ended_queue {
   static_assert(sizeof(node*) < CAF_CACHE_LINE_SIZE,
                 "sizeof(node*) >= CAF_CACHE_LINE_SIZE");
 
-  double_ended_queue() {
+  double_ended_queue() : m_taken(0), m_added(0) {
     m_head_lock.clear();
     m_tail_lock.clear();
     auto ptr = new node(nullptr);
@@ -133,6 +133,7 @@ class double_ended_queue {
     // publish & swing last forward
     m_tail.load()->next = tmp;
     m_tail = tmp;
+    inc(m_added);
   }
 
   // acquires both locks
@@ -157,6 +158,7 @@ class double_ended_queue {
       tmp->next = next;
     }
     first->next = tmp;
+    inc(m_added);
   }
 
   // acquires only one lock, returns nullptr on failure
@@ -176,6 +178,7 @@ class double_ended_queue {
       result = next->value;
       next->value = nullptr;
       m_head = next;
+      inc(m_taken);
     }
     return result;
   }
@@ -197,6 +200,7 @@ class double_ended_queue {
       m_tail = find_predecessor(last.get());
       CAF_REQUIRE(m_tail != nullptr);
       m_tail.load()->next = nullptr;
+      inc(m_taken);
     }
     return result;
   }
@@ -207,7 +211,19 @@ class double_ended_queue {
     return m_head == m_tail;
   }
 
+  // does not lock, returns an approximation of the number of elements
+  size_type size_hint() const {
+    auto taken = m_taken.load(std::memory_order_relaxed);
+    auto added = m_added.load(std::memory_order_relaxed);
+    return added > taken ? added - taken : 0;
+  }
+
  private:
+  // precondition: lock guarding x acquired
+  static void inc(std::atomic<size_type>& x) {
+    x.store(x.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
   // precondition: *both* locks acquired
   node* find_predecessor(node* what) {
     for (auto i = m_head.load(); i != nullptr; i = i->next) {
@@ -220,10 +236,12 @@ class double_ended_queue {
 
   // guarded by m_head_lock
   std::atomic<node*> m_head;
-  char m_pad1[CAF_CACHE_LINE_SIZE - sizeof(node*)];
+  std::atomic<size_type> m_taken;
+  char m_pad1[CAF_CACHE_LINE_SIZE - sizeof(node*) - sizeof(size_type)];
   // guarded by m_tail_lock
   std::atomic<node*> m_tail;
-  char m_pad2[CAF_CACHE_LINE_SIZE - sizeof(node*)];
+  std::atomic<size_type> m_added;
+  char m_pad2[CAF_CACHE_LINE_SIZE - sizeof(node*) - sizeof(size_type)];
   // enforce exclusive access
   std::atomic_flag m_head_lock;
   std::atomic_flag m_tail_lock;
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_FIBER_HPP
+#define CAF_DETAIL_FIBER_HPP
+
+#include <memory>
+#include <cstddef>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/**
+ * A user-space execution context with its own stack. Fibers allow
+ * blocking actors to run on the workers of the cooperative scheduler,
+ * since a blocking receive then suspends only the fiber.
+ */
+class fiber {
+ public:
+  using entry_point = void (*)(void*);
+
+  static constexpr size_t default_stack_size = 256 * 1024;
+
+  /**
+   * Returns whether fibers are available on this platform.
+   */
+  static constexpr bool is_supported() {
+#   ifdef CAF_POSIX
+    return true;
+#   else
+    return false;
+#   endif
+  }
+
+  /**
+   * Creates a fiber for storing the context of the calling thread
+   * when switching to another fiber.
+   */
+  fiber();
+
+  /**
+   * Creates a fiber that calls `fun(arg)` on its first activation.
+   * The function `fun` must never return.
+   * A guard page below the stack turns stack overflows into segfaults.
+   */
+  fiber(entry_point fun, void* arg, size_t stack_size = default_stack_size);
+
+  ~fiber();
+
+  fiber(const fiber&) = delete;
+  fiber& operator=(const fiber&) = delete;
+
+  /**
+   * Stores the current context in `from` and activates `to`.
+   */
+  static void swap(fiber& from, fiber& to);
+
+ private:
+  struct impl;
+  std::unique_ptr<impl> m_impl;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_FIBER_HPP
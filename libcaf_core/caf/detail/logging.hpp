@@ -20,8 +20,10 @@
 #ifndef CAF_LOGGING_HPP
 #define CAF_LOGGING_HPP
 
+#include <atomic>
 #include <cstring>
 #include <sstream>
+#include <ostream>
 #include <iostream>
 #include <type_traits>
 
@@ -41,10 +43,22 @@
  * 3: + debug
  * 4: + trace (prints for each logged method entry and exit message)
  *
+ * CAF_LOG_LEVEL only sets the maximum level compiled into the binary.
+ * The level can be lowered at runtime using `logging::level(int)` or by
+ * setting the environment variable CAF_LOG_LEVEL to a level name or number.
+ * Messages are checked against the runtime level before formatting them.
+ *
  * Note: this logger emits log4j style XML output; logs are best viewed
  *       using a log4j viewer, e.g., http://code.google.com/p/otroslogviewer/
  *
  */
+
+#define CAF_ERROR 0
+#define CAF_WARNING 1
+#define CAF_INFO 2
+#define CAF_DEBUG 3
+#define CAF_TRACE 4
+
 namespace caf {
 namespace detail {
 
@@ -60,23 +74,67 @@ class logging {
   // returns the previously set actor id
   actor_id set_aid(actor_id aid);
 
-  virtual void log(const char* level, const char* class_name,
-           const char* function_name, const char* file_name,
-           int line_num, const std::string& msg) = 0;
+  /**
+   * Returns whether messages of level `lvl` pass the runtime filter.
+   */
+  static inline bool accepts(int lvl) {
+    return lvl <= s_level.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the current runtime log level.
+   */
+  static int level();
+
+  /**
+   * Sets the runtime log level, whereas the level cannot
+   * exceed the level defined at compile time.
+   */
+  static void level(int new_level);
+
+  /**
+   * Returns a thread-local stream with a fixed-size buffer for formatting
+   * the next message of the calling thread. Messages exceeding the
+   * buffer are truncated.
+   */
+  static std::ostream& stream();
+
+  /**
+   * Enqueues the message formatted via `stream()`. The strings passed
+   * to this function must have static storage duration, because they
+   * are accessed after this function returns.
+   */
+  virtual void log(int level, const char* class_name,
+                   const char* function_name, const char* file_name,
+                   int line_num) = 0;
 
   class trace_helper {
 
    public:
 
-    trace_helper(std::string class_name, const char* fun_name,
-           const char* file_name, int line_num,
-           const std::string& msg);
+    template <class F>
+    trace_helper(const char* class_name, const char* fun_name,
+                 const char* file_name, int line_num, F msg)
+        : m_enabled(accepts(CAF_TRACE)),
+          m_class(class_name),
+          m_fun_name(fun_name),
+          m_file_name(file_name),
+          m_line_num(line_num) {
+      if (m_enabled) {
+        // creating the logger writes to stream(), i.e., the
+        // logger must exist before formatting the message
+        auto logger = singletons::get_logger();
+        msg(stream() << "ENTRY ");
+        logger->log(CAF_TRACE, m_class, m_fun_name, m_file_name, m_line_num);
+      }
+    }
 
     ~trace_helper();
 
    private:
 
-    std::string m_class;
+    bool m_enabled;
+    const char* m_class;
     const char* m_fun_name;
     const char* m_file_name;
     int m_line_num;
@@ -95,38 +153,12 @@ class logging {
 
   inline void dispose() { delete this; }
 
-};
-
-struct oss_wr {
-
-  inline oss_wr() { }
+ private:
 
-  inline oss_wr(oss_wr&& other) : m_str(std::move(other.m_str)) {}
-
-  std::string m_str;
-
-  inline std::string str() { return std::move(m_str); }
+  static std::atomic<int> s_level;
 
 };
 
-inline oss_wr operator<<(oss_wr&& lhs, std::string str) {
-  lhs.m_str += std::move(str);
-  return std::move(lhs);
-}
-
-inline oss_wr operator<<(oss_wr&& lhs, const char* str) {
-  lhs.m_str += str;
-  return std::move(lhs);
-}
-
-template <class T>
-oss_wr operator<<(oss_wr&& lhs, T rhs) {
-  std::ostringstream oss;
-  oss << rhs;
-  lhs.m_str += oss.str();
-  return std::move(lhs);
-}
-
 } // namespace detail
 } // namespace caf
 
@@ -134,12 +166,6 @@ oss_wr operator<<(oss_wr&& lhs, T rhs) {
 
 #define CAF_CAT(a, b) a##b
 
-#define CAF_ERROR 0
-#define CAF_WARNING 1
-#define CAF_INFO 2
-#define CAF_DEBUG 3
-#define CAF_TRACE 4
-
 #define CAF_LVL_NAME0() "ERROR"
 #define CAF_LVL_NAME1() "WARN "
 #define CAF_LVL_NAME2() "INFO "
@@ -159,21 +185,23 @@ oss_wr operator<<(oss_wr&& lhs, T rhs) {
 
 #ifndef CAF_LOG_LEVEL
 inline caf::actor_id caf_set_aid_dummy() { return 0; }
-#define CAF_LOG_IMPL(lvlname, classname, funname, message)                     \
+#define CAF_LOG_IMPL(level, lvlname, classname, funname, message)              \
   CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message)
 #define CAF_PUSH_AID(unused) static_cast<void>(0)
 #define CAF_PUSH_AID_FROM_PTR(unused) static_cast<void>(0)
 #define CAF_SET_AID(unused) caf_set_aid_dummy()
 #else
-#define CAF_LOG_IMPL(lvlname, classname, funname, message)                     \
-  if (strcmp(lvlname, "ERROR") == 0) {                                         \
-    CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message);                \
+#define CAF_LOG_IMPL(level, lvlname, classname, funname, message)              \
+  if (caf::detail::logging::accepts(level)) {                                  \
+    if (level == CAF_ERROR) {                                                  \
+      CAF_PRINT_ERROR_IMPL(lvlname, classname, funname, message);              \
+    }                                                                          \
+    auto CAF_UNIFYN(caf_logger) = caf::detail::singletons::get_logger();       \
+    caf::detail::logging::stream() << message;                                 \
+    CAF_UNIFYN(caf_logger)->log(level, classname, funname, __FILE__,           \
+                                __LINE__);                                     \
   }                                                                            \
-  caf::detail::singletons::get_logger()->log(lvlname, classname, funname,      \
-                                             __FILE__, __LINE__,               \
-                                             (caf::detail::oss_wr{}            \
-                                              << std::boolalpha                \
-                                              << message).str())
+  CAF_VOID_STMT
 #define CAF_PUSH_AID(aid_arg)                                                  \
   auto CAF_UNIFYN(caf_aid_tmp)                                                 \
     = caf::detail::singletons::get_logger()->set_aid(aid_arg);                 \
@@ -187,49 +215,49 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
   caf::detail::singletons::get_logger()->set_aid(aid_arg)
 #endif
 
-#define CAF_PRINT0(lvlname, classname, funname, msg)                           \
-  CAF_LOG_IMPL(lvlname, classname, funname, msg)
+#define CAF_PRINT0(level, lvlname, classname, funname, msg)                    \
+  CAF_LOG_IMPL(level, lvlname, classname, funname, msg)
 
-#define CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)                  \
+#define CAF_PRINT_IF0(stmt, level, lvlname, classname, funname, msg)           \
   if (stmt) {                                                                  \
-    CAF_LOG_IMPL(lvlname, classname, funname, msg);                            \
+    CAF_LOG_IMPL(level, lvlname, classname, funname, msg);                     \
   }                                                                            \
   CAF_VOID_STMT
 
-#define CAF_PRINT1(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
+#define CAF_PRINT1(level, lvlname, classname, funname, msg)                    \
+  CAF_PRINT0(level, lvlname, classname, funname, msg)
 
-#define CAF_PRINT_IF1(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+#define CAF_PRINT_IF1(stmt, level, lvlname, classname, funname, msg)           \
+  CAF_PRINT_IF0(stmt, level, lvlname, classname, funname, msg)
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_TRACE
-#define CAF_PRINT4(arg0, arg1, arg2, arg3)
+#define CAF_PRINT4(arg0, arg1, arg2, arg3, arg4)
 #else
-#define CAF_PRINT4(lvlname, classname, funname, msg)                           \
+#define CAF_PRINT4(level, lvlname, classname, funname, msg)                    \
   caf::detail::logging::trace_helper CAF_UNIFYN(caf_log_trace_)  {             \
     classname, funname, __FILE__, __LINE__,                                    \
-      (caf::detail::oss_wr{} << msg).str()                                     \
+      [&](std::ostream& caf_log_out) { caf_log_out << msg; }                   \
   }
 #endif
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_DEBUG
-#define CAF_PRINT3(arg0, arg1, arg2, arg3)
-#define CAF_PRINT_IF3(arg0, arg1, arg2, arg3, arg4)
+#define CAF_PRINT3(arg0, arg1, arg2, arg3, arg4)
+#define CAF_PRINT_IF3(arg0, arg1, arg2, arg3, arg4, arg5)
 #else
-#define CAF_PRINT3(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
-#define CAF_PRINT_IF3(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+#define CAF_PRINT3(level, lvlname, classname, funname, msg)                    \
+  CAF_PRINT0(level, lvlname, classname, funname, msg)
+#define CAF_PRINT_IF3(stmt, level, lvlname, classname, funname, msg)           \
+  CAF_PRINT_IF0(stmt, level, lvlname, classname, funname, msg)
 #endif
 
 #if !defined(CAF_LOG_LEVEL) || CAF_LOG_LEVEL < CAF_INFO
-#define CAF_PRINT2(arg0, arg1, arg2, arg3)
-#define CAF_PRINT_IF2(arg0, arg1, arg2, arg3, arg4)
+#define CAF_PRINT2(arg0, arg1, arg2, arg3, arg4)
+#define CAF_PRINT_IF2(arg0, arg1, arg2, arg3, arg4, arg5)
 #else
-#define CAF_PRINT2(lvlname, classname, funname, msg)                           \
-  CAF_PRINT0(lvlname, classname, funname, msg)
-#define CAF_PRINT_IF2(stmt, lvlname, classname, funname, msg)                  \
-  CAF_PRINT_IF0(stmt, lvlname, classname, funname, msg)
+#define CAF_PRINT2(level, lvlname, classname, funname, msg)                    \
+  CAF_PRINT0(level, lvlname, classname, funname, msg)
+#define CAF_PRINT_IF2(stmt, level, lvlname, classname, funname, msg)           \
+  CAF_PRINT_IF0(stmt, level, lvlname, classname, funname, msg)
 #endif
 
 #define CAF_EVAL(what) what
@@ -239,7 +267,7 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
  * Logs a message with custom class and function names.
  */
 #define CAF_LOGC(level, classname, funname, msg)                               \
-  CAF_CAT(CAF_PRINT, level)(CAF_CAT(CAF_LVL_NAME, level)(), classname,         \
+  CAF_CAT(CAF_PRINT, level)(level, CAF_CAT(CAF_LVL_NAME, level)(), classname,  \
                             funname, msg)
 
 /**
@@ -260,7 +288,7 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
  * Logs a message with custom class and function names.
  */
 #define CAF_LOGC_IF(stmt, level, classname, funname, msg)                      \
-  CAF_CAT(CAF_PRINT_IF, level)(stmt, CAF_CAT(CAF_LVL_NAME, level)(),           \
+  CAF_CAT(CAF_PRINT_IF, level)(stmt, level, CAF_CAT(CAF_LVL_NAME, level)(),    \
                                classname, funname, msg)
 
 /**
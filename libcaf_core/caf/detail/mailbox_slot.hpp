@@ -0,0 +1,142 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_MAILBOX_SLOT_HPP
+#define CAF_DETAIL_MAILBOX_SLOT_HPP
+
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#include "caf/ref_counted.hpp"
+#include "caf/intrusive_ptr.hpp"
+
+#include "caf/detail/message_arena.hpp"
+
+namespace caf {
+namespace detail {
+
+/**
+ * Number of bytes reserved for a mailbox element next to message contents.
+ * Checked against `sizeof(embedded<mailbox_element>)` in `mailbox_element.hpp`.
+ */
+constexpr size_t mailbox_slot_size = 96;
+
+/**
+ * Selects constructors that reserve memory for a mailbox element.
+ */
+struct mailbox_slot_t {
+  constexpr mailbox_slot_t() {
+    // nop
+  }
+};
+
+constexpr mailbox_slot_t mailbox_slot = mailbox_slot_t{};
+
+// Places message contents and the storage for a mailbox element on one
+// memory block. Other than `pair_storage`, the mailbox element is constructed
+// on demand by `mailbox_element::make` when enqueueing the message. Both objects
+// keep the block alive, i.e., the mailbox element can outlive the message
+// contents and vice versa.
+//
+//     +--------------------------------------+
+//     |                                      |
+//     |     +------------+                   | intrusive_ptr
+//     v     v            |                   |
+// +------------+--------------------+---------------------+
+// |  refcount  |  with_mailbox_slot |  (mailbox_element)  |
+// +------------+--------------------+---------------------+
+template <class Base>
+class with_mailbox_slot final : public Base {
+ public:
+  template <class... Ts>
+  with_mailbox_slot(intrusive_ptr<ref_counted> storage, void* slot, Ts&&... xs)
+      : Base(std::forward<Ts>(xs)...),
+        m_storage(std::move(storage)),
+        m_slot(slot) {
+    // nop
+  }
+
+  ~with_mailbox_slot() {
+    // nop
+  }
+
+  void* claim_mailbox_slot(intrusive_ptr<ref_counted>& storage) override {
+    auto result = m_slot;
+    if (result) {
+      m_slot = nullptr;
+      storage = m_storage;
+    }
+    return result;
+  }
+
+  void request_deletion() override {
+    intrusive_ptr<ref_counted> guard;
+    guard.swap(m_storage);
+    // this object lives inside a union of mailbox_slot_storage
+    this->~with_mailbox_slot();
+  }
+
+ private:
+  intrusive_ptr<ref_counted> m_storage;
+  void* m_slot;
+};
+
+template <class Base>
+class mailbox_slot_storage : public ref_counted {
+ public:
+  mailbox_slot_storage() {
+    // nop
+  }
+
+  ~mailbox_slot_storage() {
+    // nop
+  }
+
+  static inline void* operator new(size_t size) {
+    return message_arena::allocate(size);
+  }
+
+  static inline void operator delete(void* ptr, size_t size) {
+    message_arena::deallocate(ptr, size);
+  }
+
+  union { with_mailbox_slot<Base> instance; };
+
+  typename std::aligned_storage<mailbox_slot_size>::type slot;
+};
+
+/**
+ * Creates a new instance of `T` with storage for a mailbox element.
+ * The new instance has a reference count of 1.
+ */
+template <class T, class... Ts>
+T* make_with_mailbox_slot(Ts&&... xs) {
+  auto ptr = new mailbox_slot_storage<T>;
+  // the storage starts with a reference count of 1, which we pass to instance
+  intrusive_ptr<ref_counted> storage{ptr, false};
+  new (&ptr->instance) with_mailbox_slot<T>(std::move(storage), &ptr->slot,
+                                            std::forward<Ts>(xs)...);
+  return &ptr->instance;
+}
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_MAILBOX_SLOT_HPP
@@ -0,0 +1,112 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_MESSAGE_ARENA_HPP
+#define CAF_DETAIL_MESSAGE_ARENA_HPP
+
+#include <cstddef>
+
+namespace caf {
+namespace detail {
+
+/**
+ * A bump allocator for the type-erased wrappers of deserialized messages.
+ * While a `message_arena::scope` is active on a thread, message contents
+ * and `uniform_value` instances are allocated from chunks of the arena
+ * instead of the heap. Each object keeps its chunk alive, i.e., a chunk is
+ * released once all messages allocated from it have been destroyed.
+ * Chunks are kept small, because a single long-lived message pins its
+ * whole chunk. Objects can be destroyed by any thread.
+ */
+class message_arena {
+ public:
+  /**
+   * Size of a single chunk in bytes.
+   */
+  static constexpr size_t chunk_size = 4 * 1024;
+
+  /**
+   * Objects exceeding this size are always allocated on the heap.
+   */
+  static constexpr size_t max_object_size = chunk_size / 8;
+
+  message_arena();
+
+  message_arena(message_arena&& other);
+
+  message_arena& operator=(message_arena&& other);
+
+  message_arena(const message_arena&) = delete;
+
+  message_arena& operator=(const message_arena&) = delete;
+
+  ~message_arena();
+
+  /**
+   * Makes `arena` the active arena of the calling thread
+   * until this object goes out of scope.
+   */
+  class scope {
+   public:
+    explicit scope(message_arena& arena);
+
+    ~scope();
+
+    scope(const scope&) = delete;
+
+    scope& operator=(const scope&) = delete;
+
+   private:
+    message_arena* m_prev;
+  };
+
+  /**
+   * Makes `arena` the active arena of the calling thread
+   * and returns the previously active arena.
+   */
+  static message_arena* exchange_active(message_arena* arena);
+
+  /**
+   * Allocates `size` bytes from the active arena of the calling thread
+   * or from the heap if no arena is active.
+   */
+  static void* allocate(size_t size);
+
+  /**
+   * Releases memory obtained by `allocate(size)`.
+   */
+  static void deallocate(void* ptr, size_t size);
+
+  /**
+   * Returns the number of chunks currently allocated by all arenas.
+   */
+  static size_t num_chunks();
+
+ private:
+  struct chunk;
+
+  void* allocate_impl(size_t size);
+
+  chunk* m_chunk;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_MESSAGE_ARENA_HPP
@@ -47,6 +47,13 @@ class message_data : public ref_counted {
 
   virtual void* mutable_at(size_t pos) = 0;
 
+  /**
+   * Returns memory for constructing a mailbox element next to this object
+   * and sets `storage` to the owner of this memory or returns `nullptr` if
+   * no such memory is available. Each slot can be claimed only once.
+   */
+  virtual void* claim_mailbox_slot(intrusive_ptr<ref_counted>& storage);
+
   /****************************************************************************
    *                                observers                                 *
    ****************************************************************************/
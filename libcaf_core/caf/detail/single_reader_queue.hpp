@@ -26,6 +26,8 @@
 #include <atomic>
 #include <memory>
 #include <limits>
+#include <thread>
+#include <algorithm>
 #include <condition_variable> // std::cv_status
 
 #include "caf/config.hpp"
@@ -84,10 +86,14 @@ class single_reader_queue {
    */
   enqueue_result enqueue(pointer new_element) {
     CAF_REQUIRE(new_element != nullptr);
+    // increment before publishing the element to make sure the reader
+    // never decrements the counter below zero
+    m_size_hint.fetch_add(1, std::memory_order_relaxed);
     pointer e = m_stack.load();
     for (;;) {
       if (!e) {
         // if tail is nullptr, the queue has been closed
+        m_size_hint.fetch_sub(1, std::memory_order_relaxed);
         m_delete(new_element);
         return enqueue_result::queue_closed;
       }
@@ -181,7 +187,10 @@ class single_reader_queue {
     m_cache.clear(std::move(f));
   }
 
-  single_reader_queue() : m_head(nullptr) {
+  single_reader_queue()
+      : m_size_hint(0),
+        m_head(nullptr),
+        m_spin_count(min_spin_count) {
     m_stack = stack_empty_dummy();
   }
 
@@ -205,6 +214,16 @@ class single_reader_queue {
     return res;
   }
 
+  /**
+   * Returns an approximation of the number of elements that were enqueued
+   * but not yet taken out of the queue by the reader. Other than `count()`,
+   * this member function runs in constant time and is safe to call from
+   * any thread. Elements moved to the cache are not included.
+   */
+  size_t size_hint() const {
+    return m_size_hint.load(std::memory_order_relaxed);
+  }
+
   // note: the cache is intended to be used by the owner, the queue itself
   //       never accesses the cache other than for counting;
   //       the first partition of the cache is meant to be used to store and
@@ -237,10 +256,29 @@ class single_reader_queue {
     CAF_CRITICAL("invalid result of enqueue()");
   }
 
+  /**
+   * Minimum number of polls before `synchronized_await` blocks the reader.
+   */
+  static constexpr size_t min_spin_count = 16;
+
+  /**
+   * Maximum number of polls before `synchronized_await` blocks the reader.
+   */
+  static constexpr size_t max_spin_count = 4096;
+
+  /**
+   * Returns how many polls the next `synchronized_await` performs before
+   * blocking the reader.
+   * @warning Call only from the reader (owner).
+   */
+  size_t spin_count() const {
+    return m_spin_count;
+  }
+
   template <class Mutex, class CondVar>
   void synchronized_await(Mutex& mtx, CondVar& cv) {
     CAF_REQUIRE(!closed());
-    if (!can_fetch_more() && try_block()) {
+    if (!spin_for_data() && try_block()) {
       std::unique_lock<Mutex> guard(mtx);
       while (blocked()) {
         cv.wait(guard);
@@ -251,7 +289,7 @@ class single_reader_queue {
   template <class Mutex, class CondVar, class TimePoint>
   bool synchronized_await(Mutex& mtx, CondVar& cv, const TimePoint& timeout) {
     CAF_REQUIRE(!closed());
-    if (!can_fetch_more() && try_block()) {
+    if (!spin_for_data() && try_block()) {
       std::unique_lock<Mutex> guard(mtx);
       while (blocked()) {
         if (cv.wait_until(guard, timeout) == std::cv_status::timeout) {
@@ -267,11 +305,33 @@ class single_reader_queue {
  private:
   // exposed to "outside" access
   std::atomic<pointer> m_stack;
+  std::atomic<size_t> m_size_hint;
 
   // accessed only by the owner
   pointer m_head;
   deleter_type m_delete;
   intrusive_partitioned_list<value_type, deleter_type> m_cache;
+  size_t m_spin_count;
+
+  // polls for new data before the reader blocks, because parking and waking
+  // up a thread costs far more than a short busy wait if messages arrive in
+  // quick succession; the number of polls adapts to the success of previous
+  // attempts, i.e., readers that rarely receive data while spinning quickly
+  // fall back to blocking right away
+  bool spin_for_data() {
+    for (size_t i = 0; i < m_spin_count; ++i) {
+      if (can_fetch_more()) {
+        m_spin_count = std::min(m_spin_count * 2, max_spin_count);
+        return true;
+      }
+      // give senders on the same core a chance to run
+      if ((i & 0x3F) == 0x3F) {
+        std::this_thread::yield();
+      }
+    }
+    m_spin_count = std::max(m_spin_count / 2, min_spin_count);
+    return can_fetch_more();
+  }
 
   // atomically sets m_stack back and enqueues all elements to the cache
   bool fetch_new_data(pointer end_ptr) {
@@ -315,6 +375,7 @@ class single_reader_queue {
     if (m_head != nullptr || fetch_new_data()) {
       auto result = m_head;
       m_head = m_head->next;
+      m_size_hint.fetch_sub(1, std::memory_order_relaxed);
       return result;
     }
     return nullptr;
@@ -326,6 +387,7 @@ class single_reader_queue {
       auto next = m_head->next;
       f(*m_head);
       m_delete(m_head);
+      m_size_hint.fetch_sub(1, std::memory_order_relaxed);
       m_head = next;
     }
   }
@@ -347,6 +409,12 @@ class single_reader_queue {
   }
 };
 
+template <class T, class Delete>
+constexpr size_t single_reader_queue<T, Delete>::min_spin_count;
+
+template <class T, class Delete>
+constexpr size_t single_reader_queue<T, Delete>::max_spin_count;
+
 } // namespace detail
 } // namespace caf
 
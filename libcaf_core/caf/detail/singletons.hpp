@@ -70,6 +70,11 @@ class singletons {
 
   static uniform_type_info_map* get_uniform_type_info_map();
 
+  static detached_thread_pool* get_detached_thread_pool();
+
+  // returns false if singleton is already defined
+  static bool set_detached_thread_pool(detached_thread_pool*);
+
   // usually guarded by implementation-specific singleton getter
   template <class Factory>
   static abstract_singleton* get_plugin_singleton(size_t id, Factory f) {
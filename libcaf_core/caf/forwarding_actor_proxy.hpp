@@ -20,6 +20,11 @@
 #ifndef CAF_FORWARDING_ACTOR_PROXY_HPP
 #define CAF_FORWARDING_ACTOR_PROXY_HPP
 
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
 #include "caf/actor.hpp"
 #include "caf/actor_proxy.hpp"
 
@@ -51,11 +56,33 @@ class forwarding_actor_proxy : public actor_proxy {
 
   void manager(actor new_manager);
 
+  /**
+   * Sets whether the route to the remote actor is congested. Threads
+   * sending to this proxy wait while the route is congested, except for
+   * the thread calling this member function, which is the thread of the
+   * manager and needs to keep draining the route.
+   */
+  void congested(bool value);
+
+  /**
+   * Queries whether the route to the remote actor is congested.
+   */
+  inline bool congested() const {
+    return m_congested;
+  }
+
  private:
   void forward_msg(const actor_addr& sender, message_id mid, message msg);
 
+  // blocks the caller while the route to the remote actor is congested
+  void await_route();
+
   mutable detail::shared_spinlock m_manager_mtx;
   actor m_manager;
+  std::atomic<bool> m_congested;
+  std::mutex m_route_mtx;
+  std::condition_variable m_route_cv;
+  std::thread::id m_manager_thread;
 };
 
 } // namespace caf
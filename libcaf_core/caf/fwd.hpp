@@ -102,6 +102,7 @@ namespace detail {
   class group_manager;
   class actor_registry;
   class uniform_type_info_map;
+  class detached_thread_pool;
 } // namespace detail
 
 using mailbox_element_ptr = std::unique_ptr<mailbox_element, detail::disposer>;
@@ -41,10 +41,12 @@
 #include "caf/exit_reason.hpp"
 #include "caf/typed_actor.hpp"
 #include "caf/spawn_options.hpp"
+#include "caf/actor_metrics.hpp"
 #include "caf/abstract_actor.hpp"
 #include "caf/abstract_group.hpp"
 #include "caf/mailbox_element.hpp"
 #include "caf/message_handler.hpp"
+#include "caf/message_tracing.hpp"
 #include "caf/response_promise.hpp"
 #include "caf/message_priority.hpp"
 #include "caf/check_typed_input.hpp"
@@ -419,6 +421,12 @@ class local_actor : public abstract_actor, public resumable {
 
   resumable::resume_result resume(execution_unit*, size_t) override;
 
+  /****************************************************************************
+   *           override virtual member functions of abstract_actor            *
+   ****************************************************************************/
+
+  size_t mailbox_size_hint() const override;
+
   /****************************************************************************
    *                 here be dragons: end of public interface                 *
    ****************************************************************************/
@@ -541,6 +549,10 @@ class local_actor : public abstract_actor, public resumable {
                                        behavior& fun,
                                        message_id awaited_response);
 
+  // returns a snapshot of the metrics of this actor; safe to call
+  // from any thread as long as this actor did not yet call cleanup()
+  actor_metrics metrics() const;
+
   using pending_response = std::pair<message_id, behavior>;
 
   message_id new_request_id(message_priority mp);
@@ -582,7 +594,7 @@ class local_actor : public abstract_actor, public resumable {
   void do_become(behavior bhvr, bool discard_old);
 
   // used only in thread-mapped actors
-  void await_data();
+  virtual void await_data();
 
   // identifies the ID of the last sent synchronous request
   message_id m_last_request_id;
@@ -617,6 +629,10 @@ class local_actor : public abstract_actor, public resumable {
     if (!dest) {
       return;
     }
+    // starts a new trace for a sample of messages sent outside of traces
+    detail::trace_scope guard{detail::message_tracing_enabled()
+                              ? detail::sample_trace_context()
+                              : trace_context{0, 0}};
     dest->enqueue(mailbox_element::make_joint(address(),
                                               mid,
                                               std::forward<T>(x),
@@ -629,6 +645,17 @@ class local_actor : public abstract_actor, public resumable {
   void delayed_send_impl(message_priority mid, const channel& whom,
                          const duration& rtime, message data);
 
+  invoke_message_result invoke_and_measure(mailbox_element_ptr& node,
+                                           behavior& fun,
+                                           message_id awaited_response);
+
+  invoke_message_result invoke_message_impl(mailbox_element_ptr& node,
+                                            behavior& fun,
+                                            message_id awaited_response);
+
+  // only set if this actor collects metrics
+  std::unique_ptr<detail::actor_metrics_counters> m_metrics;
+
   std::function<void()> m_sync_failure_handler;
   std::function<void()> m_sync_timeout_handler;
 };
@@ -27,11 +27,13 @@
 #include "caf/actor_addr.hpp"
 #include "caf/message_id.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/message_tracing.hpp"
 
 #include "caf/detail/memory.hpp"
 #include "caf/detail/embedded.hpp"
 #include "caf/detail/disposer.hpp"
 #include "caf/detail/tuple_vals.hpp"
+#include "caf/detail/mailbox_slot.hpp"
 #include "caf/detail/pair_storage.hpp"
 #include "caf/detail/message_data.hpp"
 #include "caf/detail/memory_cache_flag_type.hpp"
@@ -48,6 +50,7 @@ class mailbox_element : public memory_managed {
   actor_addr sender;
   message_id mid;
   message msg;           // 'content field'
+  std::unique_ptr<message_span> span; // only set for traced messages
 
   mailbox_element();
   mailbox_element(actor_addr sender, message_id id);
@@ -62,6 +65,10 @@ class mailbox_element : public memory_managed {
 
   using unique_ptr = std::unique_ptr<mailbox_element, detail::disposer>;
 
+  /**
+   * Creates a new mailbox element for `msg`. Constructs the element in
+   * memory reserved by `make_message` if `msg` is its sole owner.
+   */
   static unique_ptr make(actor_addr sender, message_id id, message msg);
 
   template <class... Ts>
@@ -87,6 +94,10 @@ class mailbox_element : public memory_managed {
 
 using mailbox_element_ptr = std::unique_ptr<mailbox_element, detail::disposer>;
 
+static_assert(sizeof(detail::embedded<mailbox_element>)
+              <= detail::mailbox_slot_size,
+              "mailbox_slot_size is too small for a mailbox element");
+
 } // namespace caf
 
 #endif // CAF_MAILBOX_ELEMENT_HPP
@@ -20,7 +20,9 @@
 #ifndef CAF_MATCH_CASE_HPP
 #define CAF_MATCH_CASE_HPP
 
+#include "caf/atom.hpp"
 #include "caf/none.hpp"
+#include "caf/variant.hpp"
 #include "caf/optional.hpp"
 
 #include "caf/skip_message.hpp"
@@ -48,12 +50,21 @@ class match_case {
 
   match_case(bool has_wildcard, uint32_t token);
 
+  match_case(bool has_wildcard, uint32_t token,
+             optional<atom_value> leading_atom);
+
   match_case(match_case&&) = default;
   match_case(const match_case&) = default;
 
   virtual ~match_case();
 
-  virtual result invoke(optional<message>&, message&) = 0;
+  /**
+   * Invokes this case if it matches `msg`. By-value and rvalue reference
+   * parameters may receive elements moved out of `msg` if `consume` is
+   * `true`, i.e., if the caller discards `msg` after a match.
+   */
+  virtual result invoke(optional<message>& res, message& msg,
+                        bool consume) = 0;
 
   inline uint32_t type_token() const {
     return m_token;
@@ -63,9 +74,35 @@ class match_case {
     return m_has_wildcard;
   }
 
+  /**
+   * Returns the atom constant this case expects as first element,
+   * e.g., `get_atom::value` for a case `[](get_atom, int)`.
+   */
+  inline const optional<atom_value>& leading_atom() const {
+    return m_leading_atom;
+  }
+
  private:
   bool m_has_wildcard;
   uint32_t m_token;
+  optional<atom_value> m_leading_atom;
+};
+
+/*
+ * Extracts the atom constant at the first position of a pattern.
+ */
+template <class Pattern>
+struct leading_atom_of {
+  static optional<atom_value> get() {
+    return none;
+  }
+};
+
+template <atom_value V, class... Ts>
+struct leading_atom_of<detail::type_list<atom_constant<V>, Ts...>> {
+  static optional<atom_value> get() {
+    return V;
+  }
 };
 
 struct match_case_zipper {
@@ -81,8 +118,8 @@ struct match_case_zipper {
 };
 
 template <class T>
-T& unopt(T& v) {
-  return v;
+T&& unopt(T&& v) {
+  return std::forward<T>(v);
 }
 
 template <class T>
@@ -149,6 +186,89 @@ struct projection_result<unit_t> {
   using type = unit_t;
 };
 
+namespace detail {
+
+/*
+ * Checks whether a handler returning `T` can skip a message, in which
+ * case the message must remain intact for later invocations.
+ */
+template <class T>
+struct may_skip_message {
+  static constexpr bool value =
+    is_one_of<T, skip_message_t, optional<skip_message_t>>::value;
+};
+
+template <class... Ts>
+struct may_skip_message<variant<Ts...>> {
+  static constexpr bool value =
+    disjunction<may_skip_message<Ts>::value...>::value;
+};
+
+/*
+ * Evaluates to `true` if a handler parameter of type `Arg` benefits from
+ * receiving a moved element, i.e., if `Arg` is an rvalue reference or a
+ * by-value parameter of non-scalar, non-empty type such as a string.
+ */
+template <class Arg>
+struct is_consuming_arg {
+  static constexpr bool value =
+    std::is_rvalue_reference<Arg>::value
+    || (!std::is_reference<Arg>::value
+        && !std::is_scalar<Arg>::value
+        && !std::is_empty<Arg>::value);
+};
+
+/*
+ * Selects how an element of a message is passed to a handler parameter
+ * of type `Arg`. By-value and rvalue reference parameters receive moved
+ * elements if `Move` is `std::true_type` and a copy otherwise.
+ */
+template <class Arg>
+struct handler_arg {
+  template <class T>
+  static const T& get(T& x, std::false_type) {
+    return x;
+  }
+
+  template <class T>
+  static T&& get(T& x, std::true_type) {
+    return std::move(x);
+  }
+};
+
+template <class Arg>
+struct handler_arg<Arg&> {
+  template <class T, class Move>
+  static T& get(T& x, Move) {
+    return x;
+  }
+};
+
+template <class Arg>
+struct handler_arg<Arg&&> {
+  // rvalue references cannot bind to elements of a shared message,
+  // hence the handler receives a temporary copy
+  template <class T>
+  static T get(T& x, std::false_type) {
+    return x;
+  }
+
+  template <class T>
+  static T&& get(T& x, std::true_type) {
+    return std::move(x);
+  }
+};
+
+template <class Args, class F, long... Is, class Tuple, class Move>
+auto apply_handler_args(F& f, detail::int_list<Is...>, Tuple& tup, Move mv)
+-> decltype(f(handler_arg<typename tl_at<Args, Is>::type>::get(get<Is>(tup),
+                                                               mv)...)) {
+  return f(handler_arg<typename tl_at<Args, Is>::type>::get(get<Is>(tup),
+                                                            mv)...);
+}
+
+} // namespace detail
+
 template <class F>
 class trivial_match_case : public match_case {
  public:
@@ -171,6 +291,14 @@ class trivial_match_case : public match_case {
       detail::is_mutable_ref
     >::value;
 
+  // handlers that can skip a message must not move out of it
+  static constexpr bool is_consumer =
+    detail::tl_exists<
+      arg_types,
+      detail::is_consuming_arg
+    >::value
+    && !detail::may_skip_message<result_type>::value;
+
   using pattern =
     typename detail::tl_map<
       arg_types,
@@ -184,12 +312,14 @@ class trivial_match_case : public match_case {
     >::type;
 
   trivial_match_case(F f)
-      : match_case(false, detail::make_type_token_from_list<pattern>()),
+      : match_case(false, detail::make_type_token_from_list<pattern>(),
+                   leading_atom_of<pattern>::get()),
         m_fun(std::move(f)) {
     // nop
   }
 
-  match_case::result invoke(optional<message>& res, message& msg) override {
+  match_case::result invoke(optional<message>& res, message& msg,
+                            bool consume) override {
     intermediate_tuple it;
     detail::meta_elements<pattern> ms;
     // check if try_match() reports success
@@ -208,7 +338,26 @@ class trivial_match_case : public match_case {
     }
     lfinvoker<std::is_same<result_type, void>::value, F> fun{m_fun};
     detail::optional_message_visitor omv;
-    auto funres = apply_args(fun, detail::get_indices(it), it);
+    // move elements into by-value and rvalue reference parameters if the
+    // caller discards msg and no one else holds a reference to its content
+    if (is_consumer && consume
+        && (is_manipulator || msg.cvals()->unique())) {
+      if (!is_manipulator) {
+        // mutable_at() also detaches the data wrapped by views such as
+        // decorated tuples, i.e., we never move out of shared data
+        for (size_t i = 0; i < msg.size(); ++i) {
+          it[i] = msg.vals()->mutable_at(i);
+        }
+      }
+      // evaluates to std::false_type if m_fun never consumes arguments
+      std::integral_constant<bool, is_consumer> mv;
+      auto funres = detail::apply_handler_args<arg_types>(
+                      fun, detail::get_indices(it), it, mv);
+      res = omv(funres);
+      return match_case::match;
+    }
+    auto funres = detail::apply_handler_args<arg_types>(
+                    fun, detail::get_indices(it), it, std::false_type{});
     res = omv(funres);
     return match_case::match;
   }
@@ -237,7 +386,8 @@ class catch_all_match_case : public match_case {
     // nop
   }
 
-  match_case::result invoke(optional<message>& res, message&) override {
+  match_case::result invoke(optional<message>& res, message&,
+                            bool) override {
     lfinvoker<std::is_same<result_type, void>::value, F> fun{m_fun};
     auto fun_res = fun();
     detail::optional_message_visitor omv;
@@ -258,8 +408,8 @@ class advanced_match_case : public match_case {
 
   using result_type = typename detail::get_callable_trait<F>::result_type;
 
-  advanced_match_case(bool hw, uint32_t tt, F f)
-      : match_case(hw, tt),
+  advanced_match_case(bool hw, uint32_t tt, optional<atom_value> la, F f)
+      : match_case(hw, tt, std::move(la)),
         m_fun(std::move(f)) {
     // nop
   }
@@ -270,7 +420,8 @@ class advanced_match_case : public match_case {
   // however, dealing with all the template parameters in a debugger
   // is just dreadful; this "hack" essentially hides all the ugly
   // template boilterplate types when debugging CAF applications
-  match_case::result invoke(optional<message>& res, message& msg) override {
+  match_case::result invoke(optional<message>& res, message& msg,
+                            bool) override {
     struct storage {
       storage() : valid(false) {
         // nop
@@ -424,13 +575,13 @@ class advanced_match_case_impl : public
 
   advanced_match_case_impl(F f)
       : super(pattern_has_wildcard<Pattern>::value, static_type_token,
-              std::move(f)) {
+              leading_atom_of<Pattern>::get(), std::move(f)) {
     // nop
   }
 
   advanced_match_case_impl(F f, projections ps)
       : super(pattern_has_wildcard<Pattern>::value, static_type_token,
-              std::move(f)),
+              leading_atom_of<Pattern>::get(), std::move(f)),
         m_ps(std::move(ps)) {
     // nop
   }
@@ -474,7 +625,9 @@ class advanced_match_case_impl : public
 
 struct match_case_info {
   bool has_wildcard;
+  bool has_leading_atom;
   uint32_t type_token;
+  atom_value leading_atom;
   match_case* ptr;
 };
 
@@ -26,6 +26,8 @@
 #include "caf/message_handler.hpp"
 #include "caf/uniform_type_info.hpp"
 
+#include "caf/detail/mailbox_slot.hpp"
+
 namespace caf {
 
 /**
@@ -40,6 +42,13 @@ class message_builder {
   message_builder();
   ~message_builder();
 
+  /**
+   * Creates a new instance that reserves memory for the mailbox element
+   * of the resulting message next to its data. Used for messages that
+   * are enqueued right away, e.g., after deserializing them.
+   */
+  explicit message_builder(detail::mailbox_slot_t);
+
   /**
    * Creates a new instance and immediately calls `append(first, last)`.
    */
@@ -49,6 +58,11 @@ class message_builder {
     append(first, last);
   }
 
+  /**
+   * Reserves storage for at least `num_elements` elements.
+   */
+  message_builder& reserve(size_t num_elements);
+
   /**
    * Adds `what` to the elements of the buffer.
    */
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_MESSAGE_TRACING_HPP
+#define CAF_MESSAGE_TRACING_HPP
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/fwd.hpp"
+
+namespace caf {
+
+/**
+ * Identifies the span a message belongs to. A `trace_id` of 0
+ * denotes that a message is not part of a sampled trace.
+ */
+struct trace_context {
+  uint64_t trace_id;
+  uint64_t span_id;
+};
+
+/**
+ * Records one hop of a traced message, i.e., the time the message was
+ * enqueued to the mailbox of `receiver`, the time `receiver` started
+ * processing it, and the time its message handler returned.
+ * All timestamps are nanoseconds since the UNIX epoch in order to
+ * allow correlating spans of different nodes.
+ */
+struct message_span {
+  uint64_t trace_id;
+  uint64_t span_id;
+  uint64_t parent_id;
+  actor_id sender;
+  actor_id receiver;
+  int64_t enqueued;
+  int64_t dequeued;
+  int64_t completed;
+};
+
+/**
+ * Sets the fraction of messages sent by actors that start a new trace.
+ * Messages sent while processing a traced message always propagate
+ * the trace. A rate of 0 (default) disables tracing altogether.
+ * @relates message_span
+ */
+void set_message_tracing_rate(double rate);
+
+/**
+ * Returns the fraction of messages that start a new trace.
+ * @relates message_span
+ */
+double message_tracing_rate();
+
+/**
+ * Removes all recorded spans from the internal buffer and returns them.
+ * The buffer is bounded, i.e., spans get dropped if nobody collects them.
+ * @relates message_span
+ */
+std::vector<message_span> take_message_spans();
+
+/**
+ * Converts `x` to a complete event of the Trace Event Format
+ * as used by Chrome's trace viewer (chrome://tracing).
+ * @relates message_span
+ */
+std::string to_trace_event(const message_span& x);
+
+/**
+ * Spawns a hidden actor that periodically collects all recorded spans
+ * and appends them to the file `path` in the JSON Array Format of the
+ * Trace Event Format. The file is completed once the actor exits.
+ * @relates message_span
+ */
+actor spawn_trace_collector(std::string path,
+                            std::chrono::milliseconds interval
+                              = std::chrono::milliseconds(500));
+
+namespace detail {
+
+// returns whether tracing is enabled, i.e., the rate is > 0
+bool message_tracing_enabled();
+
+// returns the context of the currently processed message on this thread
+trace_context current_trace_context();
+
+// replaces the context of this thread, returning the previous value
+trace_context exchange_trace_context(trace_context ctx);
+
+// returns a new span for a message created in the current context or
+// `nullptr` if the thread currently doesn't process a traced message
+std::unique_ptr<message_span> make_message_span(actor_id sender);
+
+// starts a new trace with probability `message_tracing_rate()` unless
+// this thread already processes a traced message, returns a context
+// with `trace_id == 0` if no new trace was started
+trace_context sample_trace_context();
+
+// stores `ptr` in the buffer for take_message_spans()
+void record_message_span(std::unique_ptr<message_span> ptr);
+
+// returns nanoseconds since the UNIX epoch
+int64_t trace_timestamp();
+
+// sets the trace context of this thread for the lifetime of this object
+class trace_scope {
+ public:
+  explicit trace_scope(trace_context ctx)
+      : m_active(ctx.trace_id != 0) {
+    if (m_active) {
+      m_prev = exchange_trace_context(ctx);
+    }
+  }
+
+  ~trace_scope() {
+    if (m_active) {
+      exchange_trace_context(m_prev);
+    }
+  }
+
+  trace_scope(const trace_scope&) = delete;
+  trace_scope& operator=(const trace_scope&) = delete;
+
+ private:
+  bool m_active;
+  trace_context m_prev;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_MESSAGE_TRACING_HPP
@@ -37,7 +37,8 @@ namespace policy {
 /**
  * An enhancement of CAF's scheduling policy which records fine-grained
  * resource utiliziation for worker threads and actors in the parent
- * coordinator of the workers.
+ * coordinator of the workers. Measurements are stored in worker-local
+ * state, i.e., profiling does not introduce synchronization between workers.
 */
 template <class Policy>
 struct profiled : Policy {
@@ -63,10 +64,10 @@ struct profiled : Policy {
   }
 
   template <class Worker>
-  void after_completion(Worker* worker, resumable* job) {
-    Policy::after_completion(worker, job);
+  void before_shutdown(Worker* worker) {
     auto parent = static_cast<coordinator_type*>(worker->parent());
-    parent->remove_job(id_of(job));
+    parent->flush_on_shutdown(worker->id());
+    Policy::before_shutdown(worker);
   }
 };
 
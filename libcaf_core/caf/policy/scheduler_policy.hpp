@@ -100,6 +100,14 @@ class scheduler_policy {
   template <class Worker>
   void after_completion(Worker* self, resumable* job);
 
+  /**
+   * Returns an approximation of the number of jobs waiting in the queue
+   * of `self`. This member is optional, workers report a queue size
+   * of 0 in their metrics if the policy does not provide it.
+   */
+  template <class Worker>
+  size_t queue_size_hint(Worker* self);
+
   /**
    * Applies given functor to all resumables attached to a worker.
    */
@@ -28,6 +28,8 @@
 
 #include "caf/resumable.hpp"
 
+#include "caf/scheduler/worker_metrics.hpp"
+
 #include "caf/detail/double_ended_queue.hpp"
 
 namespace caf {
@@ -100,7 +102,13 @@ class work_stealing {
     }
     while (victim == self->id());
     // steal oldest element from the victim's queue
-    return d(p->worker_by_id(victim)).queue.take_tail();
+    auto& counters = self->counters();
+    detail::worker_counters::inc(counters.steal_attempts);
+    auto job = d(p->worker_by_id(victim)).queue.take_tail();
+    if (job) {
+      detail::worker_counters::inc(counters.steal_successes);
+    }
+    return job;
   }
 
   template <class Coordinator>
@@ -141,7 +149,8 @@ class work_stealing {
       size_t steal_interval;
       std::chrono::microseconds sleep_duration;
     };
-    constexpr poll_strategy strategies[3] = {
+    constexpr size_t num_stages = scheduler::worker_metrics::num_poll_stages;
+    constexpr poll_strategy strategies[num_stages] = {
       // aggressive polling  (100x) without sleep interval
       {100, 1, 10, std::chrono::microseconds{0}},
       // moderate polling (500x) with 50 us sleep interval
@@ -149,28 +158,57 @@ class work_stealing {
       // relaxed polling (infinite attempts) with 10 ms sleep interval
       {101, 0, 1,  std::chrono::microseconds{10000}}
     };
-    resumable* job = nullptr;
-    for (auto& strat : strategies) {
+    // fast path: don't bother measuring time if work is available right away
+    resumable* job = d(self).queue.take_head();
+    if (job) {
+      return job;
+    }
+    // time spent in each polling stage
+    using clock_type = std::chrono::steady_clock;
+    auto& poll_time = self->counters().poll_time;
+    auto t0 = clock_type::now();
+    auto record = [&](size_t stage) {
+      auto t1 = clock_type::now();
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+      detail::worker_counters::inc(poll_time[stage],
+                                   static_cast<uint64_t>(ns.count()));
+      t0 = t1;
+    };
+    for (size_t stage = 0; stage < num_stages; ++stage) {
+      auto& strat = strategies[stage];
       for (size_t i = 0; i < strat.attempts; i += strat.step_size) {
         job = d(self).queue.take_head();
         if (job) {
+          record(stage);
           return job;
         }
         // try to steal every X poll attempts
         if ((i % strat.steal_interval) == 0) {
           job = try_steal(self);
           if (job) {
+            record(stage);
             return job;
           }
         }
         std::this_thread::sleep_for(strat.sleep_duration);
+        // the relaxed stage polls forever, hence we need to
+        // update its time periodically for readers
+        if (strat.step_size == 0) {
+          record(stage);
+        }
       }
+      record(stage);
     }
     // unreachable, because the last strategy loops
     // until a job has been dequeued
     return nullptr;
   }
 
+  template <class Worker>
+  size_t queue_size_hint(Worker* self) {
+    return d(self).queue.size_hint();
+  }
+
   template <class Worker>
   void before_shutdown(Worker*) {
     // nop
@@ -24,6 +24,7 @@
 #include "caf/message.hpp"
 #include "caf/actor_addr.hpp"
 #include "caf/message_id.hpp"
+#include "caf/message_tracing.hpp"
 
 namespace caf {
 
@@ -61,6 +62,7 @@ class response_promise {
   actor_addr m_from;
   actor_addr m_to;
   message_id m_id;
+  trace_context m_trace{0, 0}; // propagated to the response
 };
 
 } // namespace caf
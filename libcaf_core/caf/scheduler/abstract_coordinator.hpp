@@ -20,8 +20,10 @@
 #ifndef CAF_SCHEDULER_ABSTRACT_COORDINATOR_HPP
 #define CAF_SCHEDULER_ABSTRACT_COORDINATOR_HPP
 
+#include <mutex>
 #include <chrono>
 #include <atomic>
+#include <vector>
 #include <cstddef>
 
 #include "caf/fwd.hpp"
@@ -32,6 +34,8 @@
 #include "caf/duration.hpp"
 #include "caf/actor_addr.hpp"
 
+#include "caf/scheduler/worker_metrics.hpp"
+
 namespace caf {
 namespace scheduler {
 
@@ -56,6 +60,14 @@ class abstract_coordinator {
     return m_printer;
   }
 
+  /**
+   * Returns a handle to an actor replying to `get_atom` with a
+   * human-readable table of all actors collecting metrics.
+   * The actor is spawned on first use.
+   * @see set_actor_metrics_enabled
+   */
+  actor metrics_server();
+
   /**
    * Puts `what` into the queue of a randomly chosen worker.
    */
@@ -74,6 +86,12 @@ class abstract_coordinator {
     return m_num_workers;
   }
 
+  /**
+   * Returns a snapshot of the counters of all workers or an empty
+   * vector if this coordinator does not collect worker metrics.
+   */
+  virtual std::vector<worker_metrics> worker_metrics_snapshot();
+
  protected:
   abstract_coordinator();
 
@@ -93,6 +111,10 @@ class abstract_coordinator {
   actor m_timer;
   actor m_printer;
 
+  // spawned lazily by metrics_server()
+  std::mutex m_metrics_server_mtx;
+  actor m_metrics_server;
+
   // ID of the worker receiving the next enqueue
   std::atomic<size_t> m_next_worker;
 
@@ -58,6 +58,15 @@ class coordinator : public abstract_coordinator {
     return m_data;
   }
 
+  std::vector<worker_metrics> worker_metrics_snapshot() override {
+    std::vector<worker_metrics> result;
+    result.reserve(m_workers.size());
+    for (auto& w : m_workers) {
+      result.push_back(w->metrics());
+    }
+    return result;
+  }
+
  protected:
   void initialize() override {
     super::initialize();
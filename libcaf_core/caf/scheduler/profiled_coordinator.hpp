@@ -28,11 +28,24 @@
 #include <sys/resource.h>
 #endif // CAF_MACOS
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CAF_HAS_RDTSC
+#endif
+
+#include <new>
 #include <cmath>
 #include <mutex>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <vector>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <algorithm>
 #include <unordered_map>
 
 #include "caf/policy/profiled.hpp"
@@ -45,7 +58,15 @@ namespace scheduler {
 
 /**
  * A coordinator which keeps fine-grained profiling state about its workers
- * and their jobs.
+ * and their jobs. Each worker measures the run time of its jobs using a
+ * cycle counter and aggregates them in a worker-local table. Once per
+ * resolution interval, each worker samples its CPU usage and writes the
+ * aggregated values of the interval to the output file, i.e., all records
+ * describe the activity of one worker or actor in one interval and actors
+ * running on multiple workers produce one record per worker.
+ * Since CPU usage is sampled only once per interval, the CPU time of a worker
+ * is attributed to its actors proportionally to their run time, whereas CPU
+ * time exceeding the accumulated run time is considered scheduling overhead.
  */
 template <class Policy = policy::profiled<policy::work_stealing>>
 class profiled_coordinator : public coordinator<Policy> {
@@ -56,6 +77,21 @@ class profiled_coordinator : public coordinator<Policy> {
   using usec = std::chrono::microseconds;
   using msec = std::chrono::milliseconds;
 
+  /**
+   * Selects the format of the profiler output.
+   */
+  enum class output_format {
+    /**
+     * Writes one line of whitespace-separated columns per record.
+     */
+    text,
+    /**
+     * Writes fixed-size binary records, which can be converted
+     * to the text format using {@link decode}.
+     */
+    binary
+  };
+
   class measurement {
    public:
 #   ifdef CAF_MACOS
@@ -137,131 +173,443 @@ class profiled_coordinator : public coordinator<Policy> {
     long mem = 0;
   };
 
-  struct worker_state {
-    actor_id current;
-    measurement job;
-    measurement worker;
-    clock_type::duration last_flush;
+  /**
+   * A single entry of the profiler output.
+   */
+  struct record {
+    usec clock = usec::zero(); // UNIX timestamp
+    bool is_actor = false;
+    uint64_t id = 0;
+    uint64_t worker = 0;
+    uint64_t resumes = 0;
+    measurement value;
+  };
+
+  /**
+   * Summarizes the activity of a worker since its start.
+   */
+  struct worker_statistics {
+    uint64_t resumes;
+    usec busy_time;
   };
 
+  /**
+   * Returns a cheap, monotonically increasing timestamp.
+   */
+  static uint64_t ticks() {
+#   ifdef CAF_HAS_RDTSC
+    return __rdtsc();
+#   else
+    using nsec = std::chrono::nanoseconds;
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<nsec>(t).count());
+#   endif
+  }
+
   profiled_coordinator(const std::string& filename,
                        msec res = msec{1000},
                        size_t nw = std::max(std::thread::hardware_concurrency(),
                                             4u),
-                       size_t mt = std::numeric_limits<size_t>::max())
+                       size_t mt = std::numeric_limits<size_t>::max(),
+                       output_format fmt = output_format::text)
       : super{nw, mt},
-        m_file{filename},
+        m_file{filename, fmt == output_format::binary ? std::ios::binary
+                                                      : std::ios::out},
+        m_format{fmt},
         m_resolution{res},
         m_system_start{std::chrono::system_clock::now()},
-        m_clock_start{clock_type::now().time_since_epoch()} {
+        m_clock_start{clock_type::now().time_since_epoch()},
+        m_tick_start{ticks()},
+        m_ticks_per_usec{1.0} {
     if (!m_file) {
       throw std::runtime_error{"failed to open CAF profiler file"};
     }
   }
 
   void initialize() override {
+    calibrate();
+    // workers start running in super::initialize()
+    m_worker_states.reset(this->num_workers());
+    auto interval = interval_ticks();
+    for (size_t i = 0; i < this->num_workers(); ++i) {
+      m_worker_states[i].next_flush = m_tick_start + interval;
+    }
+    if (m_format == output_format::binary) {
+      m_file.write(binary_magic, sizeof(binary_magic));
+    } else {
+      write_header(m_file);
+    }
     super::initialize();
-    m_worker_states.resize(this->num_workers());
-    using std::setw;
-    m_file.flags(std::ios::left);
-    m_file << setw(21) << "clock"     // UNIX timestamp in microseconds
-           << setw(10) << "type"      // "actor" or "worker"
-           << setw(10) << "id"        // ID of the above
-           << setw(15) << "time"      // duration of this sample (cumulative)
-           << setw(15) << "usr"       // time spent in user mode (cumulative)
-           << setw(15) << "sys"       // time spent in kernel model (cumulative)
-           << setw(15) << "mem"       // used memory (cumulative)
-           << std::endl;
   }
 
   void stop() override {
     CAF_LOG_TRACE("");
+    // each worker flushes its state before shutting down
     super::stop();
-    auto now = clock_type::now().time_since_epoch();
-    auto wallclock = m_system_start + (now - m_clock_start);
-    for (size_t i = 0; i < m_worker_states.size(); ++i) {
-      record(wallclock, "worker", i, m_worker_states[i].worker);
+    // all workers have been joined at this point, i.e., we can safely
+    // write the state of any worker that did not flush on its own
+    for (size_t i = 0; i < this->num_workers(); ++i) {
+      if (!m_worker_states[i].stopped) {
+        flush(i);
+      }
     }
+    std::lock_guard<std::mutex> file_guard{m_file_mtx};
+    m_file.flush();
   }
 
   void start_measuring(size_t worker, actor_id job) {
     auto& w = m_worker_states[worker];
     w.current = job;
-    w.job = measurement::take();
+    w.job_start = ticks();
   }
 
   void stop_measuring(size_t worker, actor_id job) {
-    auto m = measurement::take();
+    auto now = ticks();
     auto& w = m_worker_states[worker];
     CAF_REQUIRE(job == w.current);
-    auto delta = m - w.job;
-    // It's not possible that the wallclock timer is less than actual CPU time
-    // spent. Due to resolution mismatches of the C++ high-resolution clock and
-    // the system timers, this may appear to be the case sometimes. We "fix"
-    // this by adjusting the wallclock to the sum of user and system time, so
-    // that utilization never exceeds 100%.
-    if (delta.time < delta.usr + delta.sys) {
-      delta.time = delta.usr + delta.sys;
-    }
-    w.worker += delta;
-    report(job, delta);
-    if (m.time - w.last_flush >= m_resolution) {
-      w.last_flush = m.time;
-      auto wallclock = m_system_start + (m.time - m_clock_start);
-      std::lock_guard<std::mutex> file_guard{m_file_mtx};
-      record(wallclock, "worker", worker, w.worker);
+    static_cast<void>(job);
+    auto delta = now - w.job_start;
+    auto& j = w.jobs[w.current];
+    j.ticks += delta;
+    ++j.resumes;
+    // only the owning worker writes to its counters
+    w.resumes.store(w.resumes.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    w.busy_ticks.store(w.busy_ticks.load(std::memory_order_relaxed) + delta,
+                       std::memory_order_relaxed);
+    if (now >= w.next_flush) {
+      flush(worker);
     }
   }
 
-  void remove_job(actor_id job) {
-    std::lock_guard<std::mutex> job_guard{m_job_mtx};
-    auto j = m_jobs.find(job);
-    if (j != m_jobs.end()) {
-      if (job != 0) {
-        auto now = clock_type::now().time_since_epoch();
-        auto wallclock = m_system_start + (now - m_clock_start);
-        std::lock_guard<std::mutex> file_guard{m_file_mtx};
-        record(wallclock, "actor", job, j->second);
+  /**
+   * Writes the state of `worker` to the output and starts a new interval.
+   * @warning Call only from the worker thread.
+   */
+  void flush(size_t worker) {
+    auto& w = m_worker_states[worker];
+    auto now_ticks = ticks();
+    auto now = clock_type::now().time_since_epoch();
+    auto elapsed = std::chrono::duration_cast<usec>(now - m_clock_start);
+    auto tpu = elapsed.count() > 0
+               ? static_cast<double>(now_ticks - m_tick_start) / elapsed.count()
+               : m_ticks_per_usec;
+    auto to_usec = [&](uint64_t x) {
+      return usec{static_cast<usec::rep>(x / tpu)};
+    };
+    auto m = measurement::take();
+    auto cpu = m - w.last;
+    w.last = m;
+    uint64_t busy = 0;
+    uint64_t resumes = 0;
+    for (auto& kvp : w.jobs) {
+      busy += kvp.second.ticks;
+      resumes += kvp.second.resumes;
+    }
+    // the worker consumes CPU time outside of resume() as well, e.g., for
+    // polling its queue; this overhead is not attributed to the actors
+    auto busy_time = to_usec(busy);
+    auto cpu_time = cpu.usr + cpu.sys;
+    auto scale = cpu_time.count() > 0
+                 ? std::min(1.0, static_cast<double>(busy_time.count())
+                                 / cpu_time.count())
+                 : 0.0;
+    auto usr = cpu.usr.count() * scale;
+    auto sys = cpu.sys.count() * scale;
+    record r;
+    r.clock = std::chrono::duration_cast<usec>(
+                (m_system_start + (now - m_clock_start)).time_since_epoch());
+    r.worker = worker;
+    std::vector<record> records;
+    records.reserve(w.jobs.size() + 1);
+    for (auto& kvp : w.jobs) {
+      // ID 0 denotes resumables that are not actors
+      if (kvp.first == 0) {
+        continue;
+      }
+      auto share = busy > 0 ? static_cast<double>(kvp.second.ticks) / busy
+                            : 0.0;
+      r.is_actor = true;
+      r.id = kvp.first;
+      r.resumes = kvp.second.resumes;
+      r.value.time = to_usec(kvp.second.ticks);
+      r.value.usr = usec{static_cast<usec::rep>(usr * share)};
+      r.value.sys = usec{static_cast<usec::rep>(sys * share)};
+      r.value.mem = 0;
+      fix_wallclock(r.value);
+      records.push_back(r);
+    }
+    r.is_actor = false;
+    r.id = worker;
+    r.resumes = resumes;
+    r.value.time = busy_time;
+    r.value.usr = usec{static_cast<usec::rep>(usr)};
+    r.value.sys = usec{static_cast<usec::rep>(sys)};
+    r.value.mem = m.mem;
+    fix_wallclock(r.value);
+    records.push_back(r);
+    w.jobs.clear();
+    w.next_flush = now_ticks + interval_ticks(tpu);
+    std::lock_guard<std::mutex> file_guard{m_file_mtx};
+    for (auto& x : records) {
+      if (m_format == output_format::binary) {
+        write_binary(m_file, x);
+      } else {
+        write_text(m_file, x);
       }
-      m_jobs.erase(j);
     }
   }
 
-  template <class Time, class Label>
-  void record(Time t, Label label, size_t id, measurement const& m) {
+  /**
+   * Writes the final state of `worker` to the output.
+   * @warning Call only from the worker thread.
+   */
+  void flush_on_shutdown(size_t worker) {
+    flush(worker);
+    m_worker_states[worker].stopped = true;
+  }
+
+  /**
+   * Returns the statistics for `worker`. This member function is
+   * safe to call from any thread.
+   */
+  worker_statistics statistics(size_t worker) const {
+    auto& w = m_worker_states[worker];
+    auto busy = w.busy_ticks.load(std::memory_order_relaxed);
+    worker_statistics result;
+    result.resumes = w.resumes.load(std::memory_order_relaxed);
+    result.busy_time = usec{static_cast<usec::rep>(busy / m_ticks_per_usec)};
+    return result;
+  }
+
+  /**
+   * Writes the column names of the text format to `out`.
+   */
+  static void write_header(std::ostream& out) {
     using std::setw;
-    m_file << setw(21) << t.time_since_epoch().count()
-           << setw(10) << label
-           << setw(10) << id
-           << m
-           << std::endl;
+    out.flags(std::ios::left);
+    out << setw(21) << "clock"     // UNIX timestamp in microseconds
+        << setw(10) << "type"      // "actor" or "worker"
+        << setw(10) << "id"        // ID of the above
+        << setw(10) << "worker"    // ID of the worker
+        << setw(10) << "resumes"   // number of resumes in this sample
+        << setw(15) << "time"      // duration of this sample
+        << setw(15) << "usr"       // time spent in user mode
+        << setw(15) << "sys"       // time spent in kernel model
+        << setw(15) << "mem"       // used memory (max. resident set size)
+        << '\n';
   }
 
-  void report(actor_id const& job, measurement const& m) {
-    std::lock_guard<std::mutex> job_guard{m_job_mtx};
-    m_jobs[job] += m;
-    if (m.time - m_last_flush >= m_resolution) {
-      m_last_flush = m.time;
-      auto now = clock_type::now().time_since_epoch();
-      auto wallclock = m_system_start + (now - m_clock_start);
-      std::lock_guard<std::mutex> file_guard{m_file_mtx};
-      for (auto& j : m_jobs) {
-        record(wallclock, "actor", j.first, j.second);
+  /**
+   * Writes `x` to `out` using the text format.
+   */
+  static void write_text(std::ostream& out, const record& x) {
+    using std::setw;
+    out << setw(21) << x.clock.count()
+        << setw(10) << (x.is_actor ? "actor" : "worker")
+        << setw(10) << x.id
+        << setw(10) << x.worker
+        << setw(10) << x.resumes
+        << x.value
+        << '\n';
+  }
+
+  /**
+   * Writes `x` to `out` using the binary format.
+   */
+  static void write_binary(std::ostream& out, const record& x) {
+    char buf[binary_record_size];
+    auto pos = buf;
+    *pos++ = x.is_actor ? 1 : 0;
+    auto put = [&](uint64_t val) {
+      // always use little endian byte order
+      for (int i = 0; i < 8; ++i) {
+        *pos++ = static_cast<char>((val >> (i * 8)) & 0xFF);
       }
+    };
+    put(static_cast<uint64_t>(x.clock.count()));
+    put(x.id);
+    put(x.worker);
+    put(x.resumes);
+    put(static_cast<uint64_t>(x.value.time.count()));
+    put(static_cast<uint64_t>(x.value.usr.count()));
+    put(static_cast<uint64_t>(x.value.sys.count()));
+    put(static_cast<uint64_t>(x.value.mem));
+    out.write(buf, binary_record_size);
+  }
+
+  /**
+   * Reads a record in binary format from `in`.
+   */
+  static bool read_binary(std::istream& in, record& x) {
+    char buf[binary_record_size];
+    if (!in.read(buf, binary_record_size)) {
+      return false;
     }
+    auto pos = buf;
+    x.is_actor = *pos++ != 0;
+    auto get = [&]() -> uint64_t {
+      uint64_t result = 0;
+      for (int i = 0; i < 8; ++i) {
+        result |= static_cast<uint64_t>(static_cast<unsigned char>(*pos++))
+                  << (i * 8);
+      }
+      return result;
+    };
+    x.clock = usec{static_cast<usec::rep>(get())};
+    x.id = get();
+    x.worker = get();
+    x.resumes = get();
+    x.value.time = usec{static_cast<usec::rep>(get())};
+    x.value.usr = usec{static_cast<usec::rep>(get())};
+    x.value.sys = usec{static_cast<usec::rep>(get())};
+    x.value.mem = static_cast<long>(get());
+    return true;
+  }
+
+  /**
+   * Converts a profiler output in binary format read from `in`
+   * to the text format and writes the result to `out`.
+   * @returns `false` if `in` does not contain valid binary output,
+   *          `true` otherwise.
+   */
+  static bool decode(std::istream& in, std::ostream& out) {
+    char magic[sizeof(binary_magic)];
+    if (!in.read(magic, sizeof(magic))
+        || !std::equal(magic, magic + sizeof(magic), binary_magic)) {
+      return false;
+    }
+    write_header(out);
+    record x;
+    while (read_binary(in, x)) {
+      write_text(out, x);
+    }
+    // a truncated trailing record indicates a corrupted file
+    return in.gcount() == 0;
+  }
+
+  static constexpr size_t binary_record_size = 1 + 8 * 8;
+
+  static constexpr char binary_magic[8] = {'C', 'A', 'F', 'P',
+                                           'R', 'O', 'F', '1'};
+
+ private:
+  struct job_state {
+    uint64_t ticks = 0;
+    uint64_t resumes = 0;
+  };
+
+  // the alignment avoids false sharing between workers
+  struct alignas(64) worker_state {
+    // accessed only by the worker
+    actor_id current = 0;
+    uint64_t job_start = 0;
+    uint64_t next_flush = 0;
+    bool stopped = false;
+    measurement last;
+    std::unordered_map<actor_id, job_state> jobs;
+    // written by the worker, readable from any thread
+    std::atomic<uint64_t> resumes{0};
+    std::atomic<uint64_t> busy_ticks{0};
+  };
+
+  // new[] ignores extended alignments prior to C++17
+  class worker_state_array {
+   public:
+    worker_state_array() : m_storage(nullptr), m_data(nullptr), m_size(0) {
+      // nop
+    }
+
+    ~worker_state_array() {
+      reset(0);
+    }
+
+    worker_state_array(const worker_state_array&) = delete;
+    worker_state_array& operator=(const worker_state_array&) = delete;
+
+    void reset(size_t n) {
+      for (size_t i = 0; i < m_size; ++i) {
+        m_data[i].~worker_state();
+      }
+      ::operator delete(m_storage);
+      m_storage = nullptr;
+      m_data = nullptr;
+      m_size = 0;
+      if (n == 0) {
+        return;
+      }
+      constexpr size_t align = alignof(worker_state);
+      m_storage = ::operator new(n * sizeof(worker_state) + align - 1);
+      auto addr = reinterpret_cast<uintptr_t>(m_storage);
+      addr = (addr + align - 1) & ~static_cast<uintptr_t>(align - 1);
+      m_data = reinterpret_cast<worker_state*>(addr);
+      for (; m_size < n; ++m_size) {
+        new (m_data + m_size) worker_state;
+      }
+    }
+
+    worker_state& operator[](size_t i) const {
+      return m_data[i];
+    }
+
+   private:
+    void* m_storage;
+    worker_state* m_data;
+    size_t m_size;
+  };
+
+  // it's not possible that the wallclock timer is less than actual CPU time
+  // spent; due to resolution mismatches of the cycle counter and the system
+  // timers, this may appear to be the case sometimes. We "fix" this by
+  // adjusting the wallclock to the sum of user and system time, so that
+  // utilization never exceeds 100%
+  static void fix_wallclock(measurement& m) {
+    if (m.time < m.usr + m.sys) {
+      m.time = m.usr + m.sys;
+    }
+  }
+
+  // estimates the frequency of the cycle counter
+  void calibrate() {
+    auto t0 = clock_type::now();
+    auto c0 = ticks();
+    auto t1 = t0;
+    while (t1 - t0 < std::chrono::milliseconds(1)) {
+      t1 = clock_type::now();
+    }
+    auto c1 = ticks();
+    auto dt = std::chrono::duration_cast<usec>(t1 - t0).count();
+    if (dt > 0 && c1 > c0) {
+      m_ticks_per_usec = static_cast<double>(c1 - c0) / dt;
+    }
+  }
+
+  uint64_t interval_ticks(double tpu) const {
+    auto res = std::chrono::duration_cast<usec>(m_resolution).count();
+    return static_cast<uint64_t>(res * tpu);
+  }
+
+  uint64_t interval_ticks() const {
+    return interval_ticks(m_ticks_per_usec);
   }
 
-  std::mutex m_job_mtx;
   std::mutex m_file_mtx;
   std::ofstream m_file;
+  output_format m_format;
   msec m_resolution;
   std::chrono::system_clock::time_point m_system_start;
   clock_type::duration m_clock_start;
-  std::vector<worker_state> m_worker_states;
-  std::unordered_map<actor_id, measurement> m_jobs;
-  clock_type::duration m_last_flush;
+  uint64_t m_tick_start;
+  double m_ticks_per_usec;
+  worker_state_array m_worker_states;
 };
 
+template <class Policy>
+constexpr size_t profiled_coordinator<Policy>::binary_record_size;
+
+template <class Policy>
+constexpr char profiled_coordinator<Policy>::binary_magic[8];
+
 } // namespace scheduler
 } // namespace caf
 
@@ -24,6 +24,8 @@
 
 #include "caf/execution_unit.hpp"
 
+#include "caf/scheduler/worker_metrics.hpp"
+
 #include "caf/detail/logging.hpp"
 #include "caf/detail/double_ended_queue.hpp"
 
@@ -116,7 +118,51 @@ class worker : public execution_unit {
     return m_max_throughput;
   }
 
+  /**
+   * Returns the counters of this worker, which must
+   * only be written to from the worker's own thread.
+   */
+  detail::worker_counters& counters() {
+    return m_counters;
+  }
+
+  /**
+   * Returns a snapshot of the counters of this worker.
+   * Safe to call from any thread.
+   */
+  worker_metrics metrics() {
+    using counters_type = detail::worker_counters;
+    worker_metrics result;
+    result.id = m_id;
+    result.jobs_run = counters_type::get(m_counters.jobs_run);
+    result.resumed_later = counters_type::get(m_counters.resumed_later);
+    result.awaiting_message = counters_type::get(m_counters.awaiting_message);
+    result.done = counters_type::get(m_counters.done);
+    result.steal_attempts = counters_type::get(m_counters.steal_attempts);
+    result.steal_successes = counters_type::get(m_counters.steal_successes);
+    for (size_t i = 0; i < worker_metrics::num_poll_stages; ++i) {
+      auto ns = counters_type::get(m_counters.poll_time[i]);
+      result.poll_time[i] = std::chrono::nanoseconds{
+        static_cast<std::chrono::nanoseconds::rep>(ns)
+      };
+    }
+    result.queue_size = queue_size_hint(m_policy, this, 0);
+    return result;
+  }
+
  private:
+  template <class P>
+  static auto queue_size_hint(P& policy, worker* self, int)
+  -> decltype(policy.queue_size_hint(self)) {
+    return policy.queue_size_hint(self);
+  }
+
+  // fallback for policies without the optional `queue_size_hint` member
+  template <class P>
+  static size_t queue_size_hint(P&, worker*, long) {
+    return 0;
+  }
+
   void run() {
     CAF_LOG_TRACE("worker with ID " << m_id);
     // scheduling loop
@@ -126,13 +172,16 @@ class worker : public execution_unit {
       CAF_LOG_DEBUG("resume actor " << id_of(job));
       CAF_PUSH_AID_FROM_PTR(dynamic_cast<abstract_actor*>(job));
       m_policy.before_resume(this, job);
+      detail::worker_counters::inc(m_counters.jobs_run);
       switch (job->resume(this, m_max_throughput)) {
         case resumable::resume_later: {
+          detail::worker_counters::inc(m_counters.resumed_later);
           m_policy.after_resume(this, job);
           m_policy.resume_job_later(this, job);
           break;
         }
         case resumable::done: {
+          detail::worker_counters::inc(m_counters.done);
           m_policy.after_resume(this, job);
           m_policy.after_completion(this, job);
           job->detach_from_scheduler();
@@ -140,6 +189,7 @@ class worker : public execution_unit {
         }
         case resumable::awaiting_message: {
           // resumable will be enqueued again later
+          detail::worker_counters::inc(m_counters.awaiting_message);
           m_policy.after_resume(this, job);
           break;
         }
@@ -164,6 +214,8 @@ class worker : public execution_unit {
   policy_data m_data;
   // instance of our policy object
   Policy m_policy;
+  // statistics written by this worker only
+  detail::worker_counters m_counters;
 };
 
 } // namespace scheduler
@@ -0,0 +1,142 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_SCHEDULER_WORKER_METRICS_HPP
+#define CAF_SCHEDULER_WORKER_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/detail/double_ended_queue.hpp" // CAF_CACHE_LINE_SIZE
+
+namespace caf {
+namespace scheduler {
+
+/**
+ * A snapshot of the counters of a single worker.
+ */
+struct worker_metrics {
+  /**
+   * Number of polling stages a worker goes through while waiting for work.
+   * The stages are ordered from aggressive to relaxed polling.
+   */
+  static constexpr size_t num_poll_stages = 3;
+
+  /**
+   * Identifies the worker.
+   */
+  size_t id;
+
+  /**
+   * Counts how often the worker resumed a job.
+   */
+  uint64_t jobs_run;
+
+  /**
+   * Counts resumes that returned `resumable::resume_later`,
+   * i.e., jobs that exhausted their `max_throughput`.
+   */
+  uint64_t resumed_later;
+
+  /**
+   * Counts resumes that returned `resumable::awaiting_message`.
+   */
+  uint64_t awaiting_message;
+
+  /**
+   * Counts resumes that returned `resumable::done`.
+   */
+  uint64_t done;
+
+  /**
+   * Counts attempts to steal a job from another worker.
+   */
+  uint64_t steal_attempts;
+
+  /**
+   * Counts successful steal attempts.
+   */
+  uint64_t steal_successes;
+
+  /**
+   * Stores the time spent in each polling stage while waiting for work.
+   */
+  std::chrono::nanoseconds poll_time[num_poll_stages];
+
+  /**
+   * Approximates the number of jobs in the queue of the worker.
+   */
+  size_t queue_size;
+};
+
+} // namespace scheduler
+
+namespace detail {
+
+// counters of a worker that are written only by the worker itself,
+// hence increments don't need atomic read-modify-write operations;
+// the padding keeps other data out of the cache line written by the worker
+class worker_counters {
+ public:
+  using counter = std::atomic<uint64_t>;
+
+  worker_counters() {
+    reset(jobs_run);
+    reset(resumed_later);
+    reset(awaiting_message);
+    reset(done);
+    reset(steal_attempts);
+    reset(steal_successes);
+    for (auto& x : poll_time) {
+      reset(x);
+    }
+  }
+
+  static void inc(counter& x, uint64_t value = 1) {
+    x.store(x.load(std::memory_order_relaxed) + value,
+            std::memory_order_relaxed);
+  }
+
+  static uint64_t get(const counter& x) {
+    return x.load(std::memory_order_relaxed);
+  }
+
+  char pad1[CAF_CACHE_LINE_SIZE];
+  counter jobs_run;
+  counter resumed_later;
+  counter awaiting_message;
+  counter done;
+  counter steal_attempts;
+  counter steal_successes;
+  // in nanoseconds
+  counter poll_time[scheduler::worker_metrics::num_poll_stages];
+  char pad2[CAF_CACHE_LINE_SIZE];
+
+ private:
+  static void reset(counter& x) {
+    x.store(0, std::memory_order_relaxed);
+  }
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_SCHEDULER_WORKER_METRICS_HPP
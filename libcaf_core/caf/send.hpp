@@ -26,6 +26,7 @@
 #include "caf/actor_cast.hpp"
 #include "caf/actor_addr.hpp"
 #include "caf/message_id.hpp"
+#include "caf/mailbox_element.hpp"
 #include "caf/message_priority.hpp"
 #include "caf/typed_actor.hpp"
 #include "caf/system_messages.hpp"
@@ -33,6 +34,28 @@
 
 namespace caf {
 
+namespace detail {
+
+// places the mailbox element and the message content on one memory block
+template <class T, class... Ts>
+typename std::enable_if<
+  !std::is_same<message, typename std::decay<T>::type>::value
+  || (sizeof...(Ts) > 0),
+  mailbox_element_ptr
+>::type
+make_send_element(actor_addr sender, message_id mid, T&& x, Ts&&... xs) {
+  return mailbox_element::make_joint(std::move(sender), mid,
+                                     std::forward<T>(x),
+                                     std::forward<Ts>(xs)...);
+}
+
+inline mailbox_element_ptr make_send_element(actor_addr sender,
+                                             message_id mid, message msg) {
+  return mailbox_element::make(std::move(sender), mid, std::move(msg));
+}
+
+} // namespace detail
+
 /**
  * Sends `to` a message under the identity of `from` with priority `prio`.
  */
@@ -43,9 +66,12 @@ void send_as(const actor& from, message_priority prio,
     return;
   }
   message_id mid;
-  to->enqueue(from.address(),
-              prio == message_priority::high ? mid.with_high_priority() : mid,
-              make_message(std::forward<Ts>(xs)...), nullptr);
+  to->enqueue(detail::make_send_element(from.address(),
+                                        prio == message_priority::high
+                                        ? mid.with_high_priority()
+                                        : mid,
+                                        std::forward<Ts>(xs)...),
+              nullptr);
 }
 
 /**
@@ -144,8 +170,11 @@ inline void anon_send_exit(const actor_addr& to, uint32_t reason) {
     return;
   }
   auto ptr = actor_cast<actor>(to);
-  ptr->enqueue(invalid_actor_addr, message_id{}.with_high_priority(),
-               make_message(exit_msg{invalid_actor_addr, reason}), nullptr);
+  ptr->enqueue(mailbox_element::make_joint(invalid_actor_addr,
+                                           message_id{}.with_high_priority(),
+                                           exit_msg{invalid_actor_addr,
+                                                    reason}),
+               nullptr);
 }
 
 /**
@@ -56,6 +56,17 @@ void set_scheduler(size_t nw = std::thread::hardware_concurrency(),
   set_scheduler(new scheduler::coordinator<Policy>(nw, max_throughput));
 }
 
+/**
+ * Configures the thread pool for detached actors, i.e., actors spawned
+ * using the `detached` flag. The pool keeps up to `max_idle_threads`
+ * terminated threads around for reuse and creates new threads
+ * with `stack_size` bytes of stack. A stack size of 0 selects the
+ * default stack size of the platform.
+ * @note This function must be used before any detached actor is spawned.
+ * @throws std::logic_error if the thread pool is already defined
+ */
+void set_detached_thread_pool(size_t max_idle_threads, size_t stack_size = 0);
+
 } // namespace caf
 
 #endif // CAF_SET_SCHEDULER_HPP
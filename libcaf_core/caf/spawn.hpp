@@ -28,6 +28,7 @@
 #include "caf/spawn_options.hpp"
 #include "caf/typed_event_based_actor.hpp"
 
+#include "caf/detail/fiber.hpp"
 #include "caf/detail/logging.hpp"
 #include "caf/detail/type_traits.hpp"
 #include "caf/detail/typed_actor_util.hpp"
@@ -59,7 +60,12 @@ intrusive_ptr<C> spawn_impl(execution_unit* host,
   if (has_priority_aware_flag(Os)) {
     ptr->is_priority_aware(true);
   }
-  if (has_detach_flag(Os) || has_blocking_api_flag(Os)) {
+  // blocking actors run in their own thread unless spawned with the
+  // context_switching flag on a platform supporting fibers
+  if (has_detach_flag(Os)
+      || (has_blocking_api_flag(Os)
+          && !(has_context_switching_flag(Os)
+               && detail::fiber::is_supported()))) {
     ptr->is_detached(true);
   }
   before_launch_fun(ptr.get());
@@ -41,7 +41,8 @@ enum class spawn_options : int {
   hide_flag = 0x08,
   blocking_api_flag = 0x10,
   priority_aware_flag = 0x20,
-  lazy_init_flag = 0x40
+  lazy_init_flag = 0x40,
+  context_switching_flag = 0x80
 };
 #endif
 
@@ -101,6 +102,17 @@ constexpr spawn_options priority_aware = spawn_options::priority_aware_flag;
  */
 constexpr spawn_options lazy_init = spawn_options::lazy_init_flag;
 
+/**
+ * Causes a blocking actor to run on the cooperative scheduler using its own
+ * stack instead of running in a separate thread. Blocking operations then
+ * suspend only the actor and yield the worker thread to other actors.
+ * @note This flag has no effect unless combined with {@link blocking_api}
+ *       and causes the actor to run detached on platforms without support
+ *       for context switching.
+ */
+constexpr spawn_options context_switching =
+  spawn_options::context_switching_flag;
+
 /**
  * Checks wheter `haystack` contains `needle`.
  * @relates spawn_options
@@ -165,6 +177,14 @@ constexpr bool has_lazy_init_flag(spawn_options opts) {
   return has_spawn_option(opts, lazy_init);
 }
 
+/**
+ * Checks wheter the {@link context_switching} flag is set in `opts`.
+ * @relates spawn_options
+ */
+constexpr bool has_context_switching_flag(spawn_options opts) {
+  return has_spawn_option(opts, context_switching);
+}
+
 /** @} */
 
 /** @cond PRIVATE */
@@ -32,6 +32,7 @@
 #include "caf/uniform_typeid.hpp"
 
 #include "caf/detail/type_traits.hpp"
+#include "caf/detail/message_arena.hpp"
 
 namespace caf {
 
@@ -48,6 +49,13 @@ struct uniform_value_t {
   void* val;
   virtual uniform_value copy() = 0;
   virtual ~uniform_value_t();
+  // allows deserializers to place values in a `detail::message_arena`
+  static inline void* operator new(size_t size) {
+    return detail::message_arena::allocate(size);
+  }
+  static inline void operator delete(void* ptr, size_t size) {
+    detail::message_arena::deallocate(ptr, size);
+  }
 };
 
 template <class T, class... Ts>
@@ -250,6 +258,12 @@ class uniform_type_info {
    */
   virtual message as_message(void* instance) const = 0;
 
+  /**
+   * Deserializes an instance of this type from `source`
+   * and stores it as `message` in `msg`.
+   */
+  virtual void deserialize_message(message& msg, deserializer* source) const;
+
   /**
    * Returns a unique number for builtin types or 0.
    */
@@ -239,6 +239,11 @@ std::set<std::string> abstract_actor::message_types() const {
   return std::set<std::string>{};
 }
 
+size_t abstract_actor::mailbox_size_hint() const {
+  // actors without mailbox, e.g., proxies, are considered idle
+  return 0;
+}
+
 optional<uint32_t> abstract_actor::handle(const std::exception_ptr& eptr) {
   { // lifetime scope of guard
     guard_type guard{m_mtx};
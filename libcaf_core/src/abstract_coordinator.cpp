@@ -31,6 +31,7 @@
 #include "caf/anything.hpp"
 #include "caf/to_string.hpp"
 #include "caf/local_actor.hpp"
+#include "caf/actor_metrics.hpp"
 #include "caf/scoped_actor.hpp"
 #include "caf/system_messages.hpp"
 
@@ -190,6 +191,23 @@ void printer_loop(blocking_actor* self) {
   );
 }
 
+void metrics_server_loop(blocking_actor* self) {
+  self->trap_exit(true);
+  bool running = true;
+  self->receive_while([&] { return running; })(
+    [](get_atom) {
+      return to_string(actor_metrics_snapshot());
+    },
+    [&](const exit_msg&) {
+      running = false;
+    },
+    others >> [&] {
+      std::cerr << "*** unexpected: " << to_string(self->current_message())
+                << std::endl;
+    }
+  );
+}
+
 } // namespace <anonymous>
 
 /******************************************************************************
@@ -212,6 +230,19 @@ void abstract_coordinator::initialize() {
   m_printer = spawn<hidden + detached + blocking_api>(printer_loop);
 }
 
+std::vector<worker_metrics> abstract_coordinator::worker_metrics_snapshot() {
+  return {};
+}
+
+actor abstract_coordinator::metrics_server() {
+  std::lock_guard<std::mutex> guard{m_metrics_server_mtx};
+  if (m_metrics_server == invalid_actor) {
+    m_metrics_server = spawn<hidden + detached + blocking_api>(
+                         metrics_server_loop);
+  }
+  return m_metrics_server;
+}
+
 void abstract_coordinator::stop_actors() {
   CAF_LOG_TRACE("");
   scoped_actor self{true};
@@ -219,8 +250,17 @@ void abstract_coordinator::stop_actors() {
   self->monitor(m_printer);
   anon_send_exit(m_timer, exit_reason::user_shutdown);
   anon_send_exit(m_printer, exit_reason::user_shutdown);
+  int num_actors = 2;
+  std::unique_lock<std::mutex> guard{m_metrics_server_mtx};
+  if (m_metrics_server != invalid_actor) {
+    self->monitor(m_metrics_server);
+    anon_send_exit(m_metrics_server, exit_reason::user_shutdown);
+    m_metrics_server = invalid_actor;
+    ++num_actors;
+  }
+  guard.unlock();
   int i = 0;
-  self->receive_for(i, 2)(
+  self->receive_for(i, num_actors)(
     [](const down_msg&) {
       // nop
     }
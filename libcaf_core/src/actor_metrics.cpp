@@ -0,0 +1,73 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/actor_metrics.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "caf/detail/singletons.hpp"
+#include "caf/detail/actor_registry.hpp"
+
+namespace caf {
+
+void set_actor_metrics_enabled(bool value) {
+  detail::singletons::get_actor_registry()->metrics_enabled(value);
+}
+
+bool actor_metrics_enabled() {
+  return detail::singletons::get_actor_registry()->metrics_enabled();
+}
+
+std::vector<actor_metrics> actor_metrics_snapshot() {
+  return detail::singletons::get_actor_registry()->metrics();
+}
+
+std::string to_string(const std::vector<actor_metrics>& xs) {
+  std::vector<const actor_metrics*> rows;
+  rows.reserve(xs.size());
+  for (auto& x : xs) {
+    rows.push_back(&x);
+  }
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const actor_metrics* x, const actor_metrics* y) {
+    return x->mailbox_size > y->mailbox_size;
+  });
+  std::ostringstream oss;
+  oss << std::setw(10) << "actor"
+      << std::setw(10) << "mailbox"
+      << std::setw(14) << "processed"
+      << std::setw(12) << "skipped"
+      << std::setw(14) << "time (us)"
+      << '\n';
+  for (auto x : rows) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                x->processing_time);
+    oss << std::setw(10) << x->id
+        << std::setw(10) << x->mailbox_size
+        << std::setw(14) << x->processed_messages
+        << std::setw(12) << x->skipped_messages
+        << std::setw(14) << us.count()
+        << '\n';
+  }
+  return oss.str();
+}
+
+} // namespace caf
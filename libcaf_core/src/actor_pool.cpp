@@ -19,9 +19,14 @@
 
 #include "caf/actor_pool.hpp"
 
+#include <stdexcept>
+
 #include "caf/send.hpp"
 #include "caf/default_attachable.hpp"
 
+#include "caf/scheduler/abstract_coordinator.hpp"
+
+#include "caf/detail/singletons.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 
 namespace caf {
@@ -71,6 +76,113 @@ void actor_pool::random::operator()(uplock& guard, const actor_vec& vec,
   selected->enqueue(std::move(ptr), host);
 }
 
+namespace {
+
+// finalizer of the SplitMix64 generator, see http://xorshift.di.unimi.it
+uint64_t mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// elastic pools inspect their workers on every n-th message only
+constexpr size_t elastic_check_interval = 16;
+
+using tick_atom = atom_constant<atom("TICK")>;
+
+} // namespace <anonymous>
+
+actor_pool::least_loaded::least_loaded() : m_pos(0) {
+  // nop
+}
+
+actor_pool::least_loaded::least_loaded(const least_loaded&) : m_pos(0) {
+  // nop
+}
+
+void actor_pool::least_loaded::operator()(uplock& guard, const actor_vec& vec,
+                                          mailbox_element_ptr& ptr,
+                                          execution_unit* host) {
+  CAF_REQUIRE(!vec.empty());
+  auto n = vec.size();
+  auto offset = m_pos++;
+  auto best = offset % n;
+  auto best_load = vec[best]->mailbox_size_hint();
+  for (size_t i = 1; i < n && best_load > 0; ++i) {
+    auto pos = (offset + i) % n;
+    auto load = vec[pos]->mailbox_size_hint();
+    if (load < best_load) {
+      best = pos;
+      best_load = load;
+    }
+  }
+  actor selected = vec[best];
+  guard.unlock();
+  selected->enqueue(std::move(ptr), host);
+}
+
+actor_pool::power_of_two_choices::power_of_two_choices() {
+  std::random_device rd;
+  m_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+actor_pool::power_of_two_choices::power_of_two_choices(
+  const power_of_two_choices& other)
+    : m_seed(mix(other.m_seed.load())) {
+  // nop
+}
+
+size_t actor_pool::power_of_two_choices::next_random() {
+  return static_cast<size_t>(mix(m_seed.fetch_add(0x9e3779b97f4a7c15ULL)));
+}
+
+void actor_pool::power_of_two_choices::operator()(uplock& guard,
+                                                  const actor_vec& vec,
+                                                  mailbox_element_ptr& ptr,
+                                                  execution_unit* host) {
+  CAF_REQUIRE(!vec.empty());
+  auto n = vec.size();
+  auto selected = &vec.front();
+  if (n > 1) {
+    // pick two distinct workers
+    auto x = next_random();
+    auto first = x % n;
+    auto second = (first + 1 + (x / n) % (n - 1)) % n;
+    auto& w0 = vec[first];
+    auto& w1 = vec[second];
+    selected = w1->mailbox_size_hint() < w0->mailbox_size_hint() ? &w1 : &w0;
+  }
+  actor worker = *selected;
+  guard.unlock();
+  worker->enqueue(std::move(ptr), host);
+}
+
+actor_pool::consistent_hash::consistent_hash(key_function fun)
+    : m_key(std::move(fun)) {
+  // nop
+}
+
+void actor_pool::consistent_hash::operator()(uplock& guard,
+                                             const actor_vec& vec,
+                                             mailbox_element_ptr& ptr,
+                                             execution_unit* host) {
+  CAF_REQUIRE(!vec.empty());
+  auto key = mix(m_key(ptr->msg));
+  // select the worker with the highest score for this key
+  size_t best = 0;
+  uint64_t best_score = 0;
+  for (size_t i = 0; i < vec.size(); ++i) {
+    auto score = mix(key ^ mix(vec[i]->id()));
+    if (i == 0 || score > best_score) {
+      best = i;
+      best_score = score;
+    }
+  }
+  actor selected = vec[best];
+  guard.unlock();
+  selected->enqueue(std::move(ptr), host);
+}
+
 actor_pool::~actor_pool() {
   // nop
 }
@@ -94,25 +206,63 @@ actor actor_pool::make(size_t num_workers, factory fac, policy pol) {
   return res;
 }
 
+actor actor_pool::make(elasticity cfg, factory fac, policy pol) {
+  if (cfg.min_workers == 0 || cfg.min_workers > cfg.max_workers) {
+    throw std::invalid_argument("invalid number of workers");
+  }
+  if (!cfg.cooldown.valid() || cfg.cooldown.is_zero()) {
+    throw std::invalid_argument("cooldown must be a positive duration");
+  }
+  auto res = make(std::move(pol));
+  auto ptr = static_cast<actor_pool*>(actor_cast<abstract_actor*>(res));
+  // configure the pool before its workers can send messages to it
+  ptr->m_factory = fac;
+  ptr->m_elasticity = cfg;
+  auto res_addr = ptr->address();
+  for (size_t i = 0; i < cfg.min_workers; ++i) {
+    auto worker = fac();
+    worker->attach(default_attachable::make_monitor(res_addr));
+    ptr->m_workers.push_back(worker);
+  }
+  ptr->request_tick();
+  return res;
+}
+
 void actor_pool::enqueue(const actor_addr& sender, message_id mid,
                          message content, execution_unit* eu) {
-  upgrade_lock<detail::shared_spinlock> guard{m_mtx};
-  if (filter(guard, sender, mid, content, eu)) {
-    return;
+  { // lifetime scope of guard
+    upgrade_lock<detail::shared_spinlock> guard{m_mtx};
+    if (filter(guard, sender, mid, content, eu)) {
+      return;
+    }
+    auto ptr = mailbox_element::make(sender, mid, std::move(content));
+    m_policy(guard, m_workers, ptr, eu);
+  }
+  // only messages dispatched to workers count towards growing the pool
+  if (m_factory) {
+    grow();
   }
-  auto ptr = mailbox_element::make(sender, mid, std::move(content));
-  m_policy(guard, m_workers, ptr, eu);
 }
 
 void actor_pool::enqueue(mailbox_element_ptr what, execution_unit* eu) {
-  upgrade_lock<detail::shared_spinlock> guard{m_mtx};
-  if (filter(guard, what->sender, what->mid, what->msg, eu)) {
-    return;
+  { // lifetime scope of guard
+    upgrade_lock<detail::shared_spinlock> guard{m_mtx};
+    if (filter(guard, what->sender, what->mid, what->msg, eu)) {
+      return;
+    }
+    m_policy(guard, m_workers, what, eu);
+  }
+  if (m_factory) {
+    grow();
   }
-  m_policy(guard, m_workers, what, eu);
 }
 
-actor_pool::actor_pool() : m_planned_reason(caf::exit_reason::not_exited) {
+actor_pool::actor_pool()
+    : m_planned_reason(caf::exit_reason::not_exited),
+      m_elasticity{0, 0, 0, duration{}},
+      m_dispatched(0),
+      m_growing(false),
+      m_has_grown(false) {
   is_registered(true);
 }
 
@@ -178,6 +328,12 @@ bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
     }
     return true;
   }
+  if (m_factory && msg.match_elements<sys_atom, atom_value>()
+      && msg.get_as<atom_value>(1) == tick_atom::value) {
+    shrink(guard);
+    request_tick();
+    return true;
+  }
   if (msg.match_elements<sys_atom, get_atom>()) {
     auto cpy = m_workers;
     guard.unlock();
@@ -207,4 +363,70 @@ void actor_pool::quit() {
   is_registered(false);
 }
 
+void actor_pool::grow() {
+  if (++m_dispatched % elastic_check_interval != 0) {
+    return;
+  }
+  // make sure only one sender at a time spawns new workers
+  bool expected = false;
+  if (!m_growing.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  size_t num_workers = 0;
+  size_t backlog = 0;
+  { // lifetime scope of guard
+    shared_lock<detail::shared_spinlock> guard{m_mtx};
+    num_workers = m_workers.size();
+    for (auto& w : m_workers) {
+      backlog += w->mailbox_size_hint();
+    }
+  }
+  if (num_workers > 0 && num_workers < m_elasticity.max_workers
+      && backlog > num_workers * m_elasticity.grow_threshold) {
+    // never call the factory while holding m_mtx, since it
+    // might send messages to this pool
+    auto worker = m_factory();
+    worker->attach(default_attachable::make_monitor(address()));
+    std::unique_lock<detail::shared_spinlock> guard{m_mtx};
+    auto rsn = m_planned_reason;
+    if (rsn == exit_reason::not_exited) {
+      m_workers.push_back(worker);
+      m_has_grown = true;
+    } else {
+      // pool has been closed in the meantime
+      guard.unlock();
+      anon_send_exit(worker, rsn);
+    }
+  }
+  m_growing = false;
+}
+
+void actor_pool::shrink(upgrade_lock<detail::shared_spinlock>& guard) {
+  if (m_has_grown.exchange(false)
+      || m_workers.size() <= m_elasticity.min_workers) {
+    return;
+  }
+  actor retired;
+  { // lifetime scope of unique_guard
+    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
+    // retire the most recently added idle worker
+    auto pred = [](const actor& w) { return w->mailbox_size_hint() == 0; };
+    auto i = std::find_if(m_workers.rbegin(), m_workers.rend(), pred);
+    if (i == m_workers.rend()) {
+      return;
+    }
+    retired = *i;
+    m_workers.erase(std::next(i).base());
+  }
+  guard.unlock();
+  anon_send_exit(retired, exit_reason::user_shutdown);
+}
+
+void actor_pool::request_tick() {
+  auto sched_cd = detail::singletons::get_scheduling_coordinator();
+  sched_cd->delayed_send(m_elasticity.cooldown, address(), this,
+                         invalid_message_id,
+                         make_message(sys_atom::value, tick_atom::value));
+}
+
 } // namespace caf
@@ -23,6 +23,7 @@
 
 #include "caf/attachable.hpp"
 #include "caf/exit_reason.hpp"
+#include "caf/local_actor.hpp"
 #include "caf/detail/actor_registry.hpp"
 
 #include "caf/locks.hpp"
@@ -43,7 +44,10 @@ actor_registry::~actor_registry() {
   // nop
 }
 
-actor_registry::actor_registry() : m_running(0), m_ids(1) {
+actor_registry::actor_registry()
+    : m_running(0),
+      m_ids(1),
+      m_metrics_enabled(false) {
   // nop
 }
 
@@ -91,11 +95,9 @@ uint32_t actor_registry::next_id() {
 }
 
 void actor_registry::inc_running() {
-# if defined(CAF_LOG_LEVEL) && CAF_LOG_LEVEL >= CAF_DEBUG
-    CAF_LOG_DEBUG("new value = " << ++m_running);
-# else
-    ++m_running;
-# endif
+  size_t new_val = ++m_running;
+  CAF_LOG_DEBUG(CAF_ARG(new_val));
+  static_cast<void>(new_val);
 }
 
 size_t actor_registry::running() const {
@@ -121,5 +123,33 @@ void actor_registry::await_running_count_equal(size_t expected) {
   }
 }
 
+bool actor_registry::metrics_enabled() const {
+  return m_metrics_enabled;
+}
+
+void actor_registry::metrics_enabled(bool value) {
+  m_metrics_enabled = value;
+}
+
+void actor_registry::add_metrics_source(const local_actor* ptr) {
+  std::lock_guard<std::mutex> guard{m_metrics_mtx};
+  m_metrics_sources.emplace(ptr->id(), ptr);
+}
+
+void actor_registry::remove_metrics_source(actor_id key) {
+  std::lock_guard<std::mutex> guard{m_metrics_mtx};
+  m_metrics_sources.erase(key);
+}
+
+std::vector<actor_metrics> actor_registry::metrics() const {
+  std::vector<actor_metrics> result;
+  std::lock_guard<std::mutex> guard{m_metrics_mtx};
+  result.reserve(m_metrics_sources.size());
+  for (auto& kvp : m_metrics_sources) {
+    result.push_back(kvp.second->metrics());
+  }
+  return result;
+}
+
 } // namespace detail
 } // namespace caf
@@ -19,6 +19,8 @@
 
 #include "caf/detail/behavior_impl.hpp"
 
+#include <algorithm>
+
 #include "caf/message_handler.hpp"
 
 namespace caf {
@@ -26,11 +28,19 @@ namespace detail {
 
 namespace {
 
+bool get_leading_atom(const message& msg, atom_value& x) {
+  if (msg.empty() || !msg.match_element<atom_value>(0)) {
+    return false;
+  }
+  x = msg.get_as<atom_value>(0);
+  return true;
+}
+
 class combinator final : public behavior_impl {
  public:
-  bhvr_invoke_result invoke(message& arg) {
-    auto res = first->invoke(arg);
-    return res ? res : second->invoke(arg);
+  bhvr_invoke_result invoke(message& arg, bool consume) {
+    auto res = first->invoke(arg, consume);
+    return res ? res : second->invoke(arg, consume);
   }
 
   void handle_timeout() {
@@ -67,25 +77,143 @@ behavior_impl::~behavior_impl() {
   // nop
 }
 
+constexpr size_t behavior_impl::min_indexed_cases;
+
 behavior_impl::behavior_impl(duration tout)
     : m_timeout(tout),
       m_begin(nullptr),
-      m_end(nullptr) {
+      m_end(nullptr),
+      m_indexed(false),
+      m_has_atom_cases(false) {
   // nop
 }
 
-bhvr_invoke_result behavior_impl::invoke(message& msg) {
-  auto msg_token = msg.type_token();
+bhvr_invoke_result behavior_impl::invoke(message& msg, bool consume) {
   bhvr_invoke_result res;
+  if (m_indexed) {
+    auto cl = candidates(msg);
+    auto base = m_candidates.data();
+    for (auto i = base + cl.first; i != base + cl.last; ++i) {
+      if ((*i)->ptr->invoke(res, msg, consume) != match_case::no_match) {
+        return res;
+      }
+    }
+    return none;
+  }
+  auto msg_token = msg.type_token();
+  // cases expecting an atom constant can only match if the atom matches
+  atom_value msg_atom = static_cast<atom_value>(0);
+  auto has_atom = m_has_atom_cases && get_leading_atom(msg, msg_atom);
   for (auto i = m_begin; i != m_end; ++i) {
     if ((i->has_wildcard || i->type_token == msg_token)
-        && i->ptr->invoke(res, msg) != match_case::no_match) {
+        && (!i->has_leading_atom
+            || (has_atom && i->leading_atom == msg_atom))
+        && i->ptr->invoke(res, msg, consume) != match_case::no_match) {
       return res;
     }
   }
   return none;
 }
 
+template <class Predicate>
+behavior_impl::candidate_list behavior_impl::add_candidates(Predicate p) {
+  candidate_list result;
+  result.first = static_cast<uint32_t>(m_candidates.size());
+  for (auto i = m_begin; i != m_end; ++i) {
+    if (p(*i)) {
+      m_candidates.push_back(i);
+    }
+  }
+  result.last = static_cast<uint32_t>(m_candidates.size());
+  return result;
+}
+
+behavior_impl::token_entry behavior_impl::make_token_entry(bool any_token,
+                                                           uint32_t token) {
+  auto in_token = [=](const match_case_info& x) {
+    return x.has_wildcard || (!any_token && x.type_token == token);
+  };
+  token_entry result;
+  result.type_token = token;
+  // messages not starting with one of the atoms below
+  // can only match cases without leading atom
+  result.cases = add_candidates([&](const match_case_info& x) {
+    return in_token(x) && !x.has_leading_atom;
+  });
+  std::vector<atom_value> atoms;
+  for (auto i = m_begin; i != m_end; ++i) {
+    if (in_token(*i) && i->has_leading_atom) {
+      atoms.push_back(i->leading_atom);
+    }
+  }
+  std::sort(atoms.begin(), atoms.end());
+  atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+  result.atoms_first = static_cast<uint32_t>(m_atom_dispatch.size());
+  for (auto atom : atoms) {
+    atom_entry entry;
+    entry.atom = atom;
+    entry.cases = add_candidates([&](const match_case_info& x) {
+      return in_token(x) && (!x.has_leading_atom || x.leading_atom == atom);
+    });
+    m_atom_dispatch.push_back(entry);
+  }
+  result.atoms_last = static_cast<uint32_t>(m_atom_dispatch.size());
+  return result;
+}
+
+void behavior_impl::init_dispatch_index() {
+  m_dispatch.clear();
+  m_atom_dispatch.clear();
+  m_candidates.clear();
+  m_has_atom_cases = std::any_of(m_begin, m_end,
+                                 [](const match_case_info& x) {
+    return x.has_leading_atom;
+  });
+  m_indexed = static_cast<size_t>(m_end - m_begin) >= min_indexed_cases;
+  if (!m_indexed) {
+    return;
+  }
+  std::vector<uint32_t> tokens;
+  for (auto i = m_begin; i != m_end; ++i) {
+    if (!i->has_wildcard) {
+      tokens.push_back(i->type_token);
+    }
+  }
+  std::sort(tokens.begin(), tokens.end());
+  tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+  // each entry lists all cases for its type token plus all wildcard
+  // cases in their original order
+  m_dispatch.reserve(tokens.size());
+  for (auto token : tokens) {
+    m_dispatch.push_back(make_token_entry(false, token));
+  }
+  m_fallback = make_token_entry(true, 0);
+}
+
+behavior_impl::candidate_list
+behavior_impl::candidates(const message& msg) const {
+  auto token = msg.type_token();
+  auto i = std::lower_bound(m_dispatch.begin(), m_dispatch.end(), token,
+                            [](const token_entry& x, uint32_t y) {
+    return x.type_token < y;
+  });
+  auto& e = (i != m_dispatch.end() && i->type_token == token) ? *i
+                                                               : m_fallback;
+  atom_value atom;
+  if (e.atoms_first != e.atoms_last && get_leading_atom(msg, atom)) {
+    auto first = m_atom_dispatch.begin() + e.atoms_first;
+    auto last = m_atom_dispatch.begin() + e.atoms_last;
+    auto j = std::lower_bound(first, last, atom,
+                              [](const atom_entry& x, atom_value y) {
+      return x.atom < y;
+    });
+    if (j != last && j->atom == atom) {
+      return j->cases;
+    }
+  }
+  return e.cases;
+}
+
 void behavior_impl::handle_timeout() {
   // nop
 }
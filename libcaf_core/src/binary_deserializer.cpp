@@ -198,4 +198,9 @@ void binary_deserializer::read_raw(size_t num_bytes, void* storage) {
   m_pos = advanced(m_pos, num_bytes);
 }
 
+size_t binary_deserializer::remaining() const {
+  return static_cast<size_t>(as_char_pointer(m_end)
+                             - as_char_pointer(m_pos));
+}
+
 } // namespace caf
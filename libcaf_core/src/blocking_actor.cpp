@@ -18,14 +18,69 @@
  ******************************************************************************/
 
 #include "caf/exception.hpp"
+#include "caf/exit_reason.hpp"
 #include "caf/blocking_actor.hpp"
 
+#include "caf/detail/fiber.hpp"
 #include "caf/detail/logging.hpp"
+#include "caf/detail/message_arena.hpp"
 #include "caf/detail/singletons.hpp"
 #include "caf/detail/actor_registry.hpp"
 
 namespace caf {
 
+namespace {
+
+// thread-local state of an execution context; a fiber may continue
+// on a different worker after a swap and must neither leak its state
+// to the worker nor inherit the state of the worker
+class thread_locals {
+ public:
+  void save() {
+    m_aid = CAF_SET_AID(0);
+    m_trace = detail::exchange_trace_context(trace_context{0, 0});
+    m_arena = detail::message_arena::exchange_active(nullptr);
+  }
+
+  void restore() {
+    detail::message_arena::exchange_active(m_arena);
+    detail::exchange_trace_context(m_trace);
+    CAF_SET_AID(m_aid);
+  }
+
+ private:
+  actor_id m_aid;
+  trace_context m_trace;
+  detail::message_arena* m_arena;
+};
+
+// stores the context of `from` and activates `to`, saving and
+// restoring the thread-local state of `from` around the switch
+void switch_fiber(detail::fiber& from, detail::fiber& to) {
+  thread_locals state;
+  state.save();
+  detail::fiber::swap(from, to);
+  state.restore();
+}
+
+} // namespace <anonymous>
+
+struct blocking_actor::fiber_state {
+  fiber_state(blocking_actor* self)
+      : max_throughput(0),
+        handled_msgs(0),
+        result(resumable::resume_later),
+        self_fiber(fiber_main, self) {
+    // nop
+  }
+  size_t max_throughput;
+  size_t handled_msgs;
+  resumable::resume_result result;
+  // stores the context of the worker that resumed this actor
+  detail::fiber worker_fiber;
+  detail::fiber self_fiber;
+};
+
 blocking_actor::blocking_actor() {
   is_blocking(true);
 }
@@ -56,6 +111,93 @@ void blocking_actor::initialize() {
   // nop
 }
 
+void blocking_actor::act_and_cleanup() {
+  CAF_LOG_TRACE("");
+  uint32_t rsn = exit_reason::normal;
+  std::exception_ptr eptr = nullptr;
+  try {
+    act();
+  }
+  catch (actor_exited& e) {
+    rsn = e.reason();
+  }
+  catch (...) {
+    rsn = exit_reason::unhandled_exception;
+    eptr = std::current_exception();
+  }
+  if (eptr) {
+    auto opt_reason = handle(eptr);
+    if (opt_reason) {
+      // use exit reason defined by custom handler
+      rsn = *opt_reason;
+    }
+  }
+  planned_exit_reason(rsn);
+  try {
+    on_exit();
+  }
+  catch (...) {
+    // simply ignore exception
+  }
+  // exit reason might have been changed by on_exit()
+  cleanup(planned_exit_reason());
+}
+
+resumable::resume_result blocking_actor::resume_fiber(size_t max_throughput) {
+  CAF_LOG_TRACE("");
+  if (!m_fiber) {
+    m_fiber.reset(new fiber_state(this));
+  }
+  m_fiber->max_throughput = max_throughput;
+  m_fiber->handled_msgs = 0;
+  switch_fiber(m_fiber->worker_fiber, m_fiber->self_fiber);
+  auto result = m_fiber->result;
+  // blocking the mailbox allows other threads to re-schedule this actor,
+  // hence we must not do so before leaving the stack of the fiber
+  while (result == resumable::awaiting_message && !mailbox().try_block()) {
+    // a new message arrived in the meantime
+    switch_fiber(m_fiber->worker_fiber, m_fiber->self_fiber);
+    result = m_fiber->result;
+  }
+  if (result == resumable::done) {
+    // we are back on the stack of the worker, i.e., it is
+    // safe to release the stack of the terminated fiber
+    m_fiber.reset();
+  }
+  return result;
+}
+
+void blocking_actor::fiber_main(void* ptr) {
+  auto self = static_cast<blocking_actor*>(ptr);
+  CAF_PUSH_AID(self->id());
+  self->act_and_cleanup();
+  self->yield(resumable::done);
+  // a fiber is never resumed after returning done
+  CAF_CRITICAL("resumed a terminated fiber");
+}
+
+void blocking_actor::yield(resume_result result) {
+  m_fiber->result = result;
+  // a handler may yield while processing a traced message, etc.
+  switch_fiber(m_fiber->self_fiber, m_fiber->worker_fiber);
+}
+
+void blocking_actor::await_data() {
+  if (is_detached()) {
+    local_actor::await_data();
+    return;
+  }
+  // give other actors a chance to run after consuming max_throughput messages
+  if (m_fiber->handled_msgs >= m_fiber->max_throughput) {
+    yield(resumable::resume_later);
+  }
+  while (!has_next_message()) {
+    // resume_fiber() blocks the mailbox, causing enqueue()
+    // to re-schedule this actor once a new message arrives
+    yield(resumable::awaiting_message);
+  }
+}
+
 void blocking_actor::dequeue(behavior& bhvr, message_id mid) {
   // try to dequeue from cache first
   if (invoke_from_cache(bhvr, mid)) {
@@ -67,6 +209,9 @@ void blocking_actor::dequeue(behavior& bhvr, message_id mid) {
   for (;;) {
     await_data();
     auto msg = next_message();
+    if (m_fiber && msg) {
+      ++m_fiber->handled_msgs;
+    }
     switch (invoke_message(msg, bhvr, mid)) {
       case im_success:
         reset_timeout(timeout_id);
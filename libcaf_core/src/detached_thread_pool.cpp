@@ -0,0 +1,180 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/detached_thread_pool.hpp"
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+
+#include "caf/config.hpp"
+
+#ifndef CAF_WINDOWS
+#include <pthread.h>
+#endif
+
+#include "caf/detail/logging.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+constexpr std::chrono::seconds idle_timeout{10};
+
+} // namespace <anonymous>
+
+struct detached_thread_pool::state {
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::deque<job> jobs;
+  size_t max_idle_threads;
+  size_t idle_threads;
+  size_t hits;
+  size_t misses;
+  bool stopped;
+
+  state(size_t max_idle)
+      : max_idle_threads(max_idle),
+        idle_threads(0),
+        hits(0),
+        misses(0),
+        stopped(false) {
+    // nop
+  }
+};
+
+struct detached_thread_pool::launch_data {
+  std::shared_ptr<state> st;
+  job f;
+};
+
+#ifndef CAF_WINDOWS
+namespace {
+
+void* thread_entry(void* ptr) {
+  detached_thread_pool::run_loop(ptr);
+  return nullptr;
+}
+
+} // namespace <anonymous>
+#endif
+
+constexpr size_t detached_thread_pool::default_max_idle_threads;
+
+constexpr size_t detached_thread_pool::default_stack_size;
+
+detached_thread_pool::detached_thread_pool(size_t max_idle_threads,
+                                           size_t stack_size)
+    : m_state(std::make_shared<state>(max_idle_threads)),
+      m_stack_size(stack_size) {
+  // nop
+}
+
+detached_thread_pool::~detached_thread_pool() {
+  // nop
+}
+
+void detached_thread_pool::run(job f) {
+  auto& st = *m_state;
+  std::unique_lock<std::mutex> guard{st.mtx};
+  // only hand over the job if an idle thread is left to pick it up
+  if (!st.stopped && st.idle_threads > st.jobs.size()) {
+    ++st.hits;
+    st.jobs.push_back(std::move(f));
+    st.cv.notify_one();
+    return;
+  }
+  ++st.misses;
+  guard.unlock();
+  start_thread(std::move(f));
+}
+
+detached_thread_pool::statistics detached_thread_pool::stats() const {
+  auto& st = *m_state;
+  std::unique_lock<std::mutex> guard{st.mtx};
+  return statistics{st.hits, st.misses, st.idle_threads};
+}
+
+void detached_thread_pool::run_loop(void* ptr) {
+  std::unique_ptr<launch_data> ld{static_cast<launch_data*>(ptr)};
+  auto& st = *ld->st;
+  job f = std::move(ld->f);
+  for (;;) {
+    f();
+    // release resources captured by the job before waiting
+    f = nullptr;
+    std::unique_lock<std::mutex> guard{st.mtx};
+    if (st.stopped || st.idle_threads >= st.max_idle_threads) {
+      return;
+    }
+    ++st.idle_threads;
+    auto has_job = [&] { return st.stopped || !st.jobs.empty(); };
+    st.cv.wait_for(guard, idle_timeout, has_job);
+    --st.idle_threads;
+    if (st.jobs.empty()) {
+      // timeout or pool was stopped
+      return;
+    }
+    f = std::move(st.jobs.front());
+    st.jobs.pop_front();
+  }
+}
+
+detached_thread_pool* detached_thread_pool::create_singleton() {
+  return new detached_thread_pool;
+}
+
+void detached_thread_pool::initialize() {
+  CAF_LOG_TRACE("");
+}
+
+void detached_thread_pool::stop() {
+  CAF_LOG_TRACE("");
+  auto& st = *m_state;
+  std::unique_lock<std::mutex> guard{st.mtx};
+  st.stopped = true;
+  st.cv.notify_all();
+}
+
+void detached_thread_pool::start_thread(job f) {
+  auto ld = new launch_data{m_state, std::move(f)};
+# ifndef CAF_WINDOWS
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (m_stack_size > 0) {
+    pthread_attr_setstacksize(&attr, m_stack_size);
+  }
+  pthread_t tid;
+  auto res = pthread_create(&tid, &attr, thread_entry, ld);
+  pthread_attr_destroy(&attr);
+  if (res == 0) {
+    return;
+  }
+  CAF_LOG_WARNING("pthread_create failed, use std::thread with default "
+                  "stack size instead");
+# endif
+  std::thread([ld] { run_loop(ld); }).detach();
+}
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,173 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#ifdef CAF_MACOS
+// ucontext is deprecated on Mac OS and only available in XSI mode
+#  define _XOPEN_SOURCE 600
+#endif
+
+#include "caf/detail/fiber.hpp"
+
+#include <new>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef CAF_POSIX
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#endif
+
+namespace caf {
+namespace detail {
+
+constexpr size_t fiber::default_stack_size;
+
+#ifdef CAF_POSIX
+
+namespace {
+
+struct entry {
+  fiber::entry_point fun;
+  void* arg;
+};
+
+// makecontext only passes int arguments portably,
+// so we split the pointer to the entry point into two halves
+void trampoline(unsigned int hi, unsigned int lo) {
+  auto addr = (static_cast<uint64_t>(hi) << 32) | static_cast<uint64_t>(lo);
+  auto ptr = reinterpret_cast<entry*>(static_cast<uintptr_t>(addr));
+  ptr->fun(ptr->arg);
+}
+
+#ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS MAP_ANON
+#endif
+
+// a stack with an inaccessible guard page below its lowest address,
+// i.e., a stack overflow causes a segfault instead of corrupting memory
+class fiber_stack {
+ public:
+  fiber_stack() : m_addr(nullptr), m_size(0), m_guard_size(0) {
+    // nop
+  }
+
+  ~fiber_stack() {
+    if (m_addr) {
+      munmap(m_addr, m_size);
+    }
+  }
+
+  fiber_stack(const fiber_stack&) = delete;
+  fiber_stack& operator=(const fiber_stack&) = delete;
+
+  void allocate(size_t stack_size) {
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto pages = (stack_size + page_size - 1) / page_size;
+    m_size = (pages + 1) * page_size;
+    auto addr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    m_addr = addr;
+    if (mprotect(m_addr, page_size, PROT_NONE) != 0) {
+      throw std::runtime_error("cannot protect guard page of fiber stack");
+    }
+    m_guard_size = page_size;
+  }
+
+  // returns the usable part of the stack, i.e., without the guard page
+  void* data() const {
+    return static_cast<char*>(m_addr) + m_guard_size;
+  }
+
+  size_t size() const {
+    return m_size - m_guard_size;
+  }
+
+ private:
+  void* m_addr;
+  size_t m_size;
+  size_t m_guard_size;
+};
+
+} // namespace <anonymous>
+
+struct fiber::impl {
+  ucontext_t ctx;
+  fiber_stack stack;
+  entry start;
+};
+
+fiber::fiber() : m_impl(new impl) {
+  m_impl->start.fun = nullptr;
+  m_impl->start.arg = nullptr;
+}
+
+fiber::fiber(entry_point fun, void* arg, size_t stack_size) : m_impl(new impl) {
+  m_impl->start.fun = fun;
+  m_impl->start.arg = arg;
+  m_impl->stack.allocate(stack_size);
+  auto& ctx = m_impl->ctx;
+  if (getcontext(&ctx) != 0) {
+    throw std::runtime_error("getcontext failed");
+  }
+  ctx.uc_stack.ss_sp = m_impl->stack.data();
+  ctx.uc_stack.ss_size = m_impl->stack.size();
+  ctx.uc_link = nullptr;
+  auto ptr = &m_impl->start;
+  auto addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+  makecontext(&ctx, reinterpret_cast<void (*)()>(trampoline), 2,
+              static_cast<unsigned int>(addr >> 32),
+              static_cast<unsigned int>(addr & 0xFFFFFFFF));
+}
+
+void fiber::swap(fiber& from, fiber& to) {
+  swapcontext(&from.m_impl->ctx, &to.m_impl->ctx);
+}
+
+#else // CAF_POSIX
+
+struct fiber::impl {
+  // nop
+};
+
+fiber::fiber() {
+  // nop
+}
+
+fiber::fiber(entry_point, void*, size_t) {
+  throw std::logic_error("fibers are not supported on this platform");
+}
+
+void fiber::swap(fiber&, fiber&) {
+  throw std::logic_error("fibers are not supported on this platform");
+}
+
+#endif // CAF_POSIX
+
+fiber::~fiber() {
+  // nop
+}
+
+} // namespace detail
+} // namespace caf
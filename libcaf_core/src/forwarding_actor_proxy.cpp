@@ -32,7 +32,8 @@ namespace caf {
 forwarding_actor_proxy::forwarding_actor_proxy(actor_id aid, node_id nid,
                                                actor mgr)
     : actor_proxy(aid, nid),
-      m_manager(mgr) {
+      m_manager(mgr),
+      m_congested(false) {
   CAF_REQUIRE(mgr != invalid_actor);
   CAF_LOG_INFO(CAF_ARG(aid) << ", " << CAF_TARG(nid, to_string));
 }
@@ -55,6 +56,31 @@ void forwarding_actor_proxy::manager(actor new_manager) {
   m_manager.swap(new_manager);
 }
 
+void forwarding_actor_proxy::congested(bool value) {
+  CAF_LOG_TRACE(CAF_ARG(id()) << ", " << CAF_ARG(value));
+  {
+    std::unique_lock<std::mutex> guard{m_route_mtx};
+    m_congested = value;
+    m_manager_thread = std::this_thread::get_id();
+  }
+  if (!value) {
+    m_route_cv.notify_all();
+  }
+}
+
+void forwarding_actor_proxy::await_route() {
+  if (!m_congested) {
+    return;
+  }
+  std::unique_lock<std::mutex> guard{m_route_mtx};
+  if (std::this_thread::get_id() == m_manager_thread) {
+    // waiting on the manager's thread would deadlock
+    return;
+  }
+  CAF_LOG_DEBUG("route to " << id() << " is congested, wait");
+  m_route_cv.wait(guard, [&] { return !m_congested; });
+}
+
 void forwarding_actor_proxy::forward_msg(const actor_addr& sender,
                                          message_id mid, message msg) {
   CAF_LOG_TRACE(CAF_ARG(id()) << ", " << CAF_TSARG(sender) << ", "
@@ -69,6 +95,7 @@ void forwarding_actor_proxy::forward_msg(const actor_addr& sender,
 
 void forwarding_actor_proxy::enqueue(const actor_addr& sender, message_id mid,
                                      message m, execution_unit*) {
+  await_route();
   forward_msg(sender, mid, std::move(m));
 }
 
@@ -121,6 +148,8 @@ void forwarding_actor_proxy::local_unlink_from(const actor_addr& other) {
 }
 
 void forwarding_actor_proxy::kill_proxy(uint32_t reason) {
+  // release all waiting senders, the manager drops their messages
+  congested(false);
   cleanup(reason);
 }
 
@@ -26,6 +26,7 @@
 #include "caf/default_attachable.hpp"
 
 #include "caf/detail/logging.hpp"
+#include "caf/detail/detached_thread_pool.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 
 namespace caf {
@@ -40,6 +41,10 @@ local_actor::local_actor()
 }
 
 local_actor::~local_actor() {
+  if (m_metrics) {
+    // cleanup() has not been called if this actor never ran
+    detail::singletons::get_actor_registry()->remove_metrics_source(id());
+  }
   if (!m_mailbox.closed()) {
     detail::sync_request_bouncer f{this->exit_reason()};
     m_mailbox.close(f);
@@ -129,6 +134,10 @@ void local_actor::forward_message(const actor& dest, message_priority prio) {
   m_current_element->mid = prio == message_priority::high
                            ? mid.with_high_priority()
                            : mid.with_normal_priority();
+  if (detail::message_tracing_enabled()) {
+    // each hop of a traced message is a span of its own
+    m_current_element->span = detail::make_message_span(id());
+  }
   dest->enqueue(std::move(m_current_element), host());
 }
 
@@ -314,6 +323,81 @@ optional<message> post_process_invoke_res(local_actor* self,
 invoke_message_result local_actor::invoke_message(mailbox_element_ptr& ptr,
                                                   behavior& fun,
                                                   message_id awaited_id) {
+  if (!ptr->span) {
+    return invoke_and_measure(ptr, fun, awaited_id);
+  }
+  // messages sent by the handler become children of this span
+  std::unique_ptr<message_span> span;
+  span.swap(ptr->span);
+  span->receiver = id();
+  span->dequeued = detail::trace_timestamp();
+  invoke_message_result result;
+  { // lifetime scope of guard
+    detail::trace_scope guard{trace_context{span->trace_id, span->span_id}};
+    result = invoke_and_measure(ptr, fun, awaited_id);
+  }
+  if (result == im_skipped && ptr) {
+    // record the span once the message actually gets processed
+    ptr->span.swap(span);
+  } else {
+    span->completed = detail::trace_timestamp();
+    detail::record_message_span(std::move(span));
+  }
+  return result;
+}
+
+invoke_message_result
+local_actor::invoke_and_measure(mailbox_element_ptr& ptr, behavior& fun,
+                                message_id awaited_id) {
+  if (!m_metrics) {
+    return invoke_message_impl(ptr, fun, awaited_id);
+  }
+  using clock_type = std::chrono::steady_clock;
+  auto t0 = clock_type::now();
+  auto result = invoke_message_impl(ptr, fun, awaited_id);
+  auto t1 = clock_type::now();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+  auto& counters = *m_metrics;
+  counters.processing_time.fetch_add(static_cast<uint64_t>(ns.count()),
+                                     std::memory_order_relaxed);
+  switch (result) {
+    case im_success:
+      counters.processed_messages.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case im_skipped:
+      counters.skipped_messages.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case im_dropped:
+      break;
+  }
+  return result;
+}
+
+actor_metrics local_actor::metrics() const {
+  actor_metrics result;
+  result.id = id();
+  result.mailbox_size = mailbox_size_hint();
+  if (m_metrics) {
+    auto& counters = *m_metrics;
+    auto rd = [](const std::atomic<uint64_t>& x) {
+      return x.load(std::memory_order_relaxed);
+    };
+    result.processed_messages = rd(counters.processed_messages);
+    result.skipped_messages = rd(counters.skipped_messages);
+    result.processing_time = std::chrono::nanoseconds{
+      static_cast<std::chrono::nanoseconds::rep>(rd(counters.processing_time))
+    };
+  } else {
+    result.processed_messages = 0;
+    result.skipped_messages = 0;
+    result.processing_time = std::chrono::nanoseconds::zero();
+  }
+  return result;
+}
+
+invoke_message_result
+local_actor::invoke_message_impl(mailbox_element_ptr& ptr, behavior& fun,
+                                 message_id awaited_id) {
   CAF_REQUIRE(ptr != nullptr);
   CAF_LOG_TRACE(CAF_TSARG(*ptr) << ", " << CAF_MARG(awaited_id, integer_value));
   switch (filter_msg(this, *ptr)) {
@@ -349,8 +433,9 @@ invoke_message_result local_actor::invoke_message(mailbox_element_ptr& ptr,
         bool is_sync_tout = ptr->msg.match_elements<sync_timeout_msg>();
         ptr.swap(current_mailbox_element());
         auto mid = current_mailbox_element()->mid;
-        auto res = post_process_invoke_res(this, mid,
-                                           fun(current_mailbox_element()->msg));
+        // the mailbox element is discarded after a match
+        auto& msg = current_mailbox_element()->msg;
+        auto res = post_process_invoke_res(this, mid, fun.consume(msg));
         ptr.swap(current_mailbox_element());
         mark_arrived(awaited_id);
         if (!res) {
@@ -371,8 +456,9 @@ invoke_message_result local_actor::invoke_message(mailbox_element_ptr& ptr,
       if (!awaited_id.valid()) {
         ptr.swap(current_mailbox_element());
         auto mid = current_mailbox_element()->mid;
-        auto res = post_process_invoke_res(this, mid,
-                                           fun(current_mailbox_element()->msg));
+        // the mailbox element is discarded after a match
+        auto& msg = current_mailbox_element()->msg;
+        auto res = post_process_invoke_res(this, mid, fun.consume(msg));
         ptr.swap(current_mailbox_element());
         if (res) {
           return im_success;
@@ -455,13 +541,19 @@ message_id local_actor::awaited_response_id() {
 
 void local_actor::launch(execution_unit* eu, bool lazy, bool hide) {
   is_registered(!hide);
+  auto registry = detail::singletons::get_actor_registry();
+  if (registry->metrics_enabled()) {
+    m_metrics.reset(new detail::actor_metrics_counters);
+    registry->add_metrics_source(this);
+  }
   if (is_detached()) {
     // actor lives in its own thread
     CAF_PUSH_AID(id());
     CAF_LOG_TRACE(CAF_ARG(lazy) << ", " << CAF_ARG(hide));
     intrusive_ptr<local_actor> mself{this};
     attach_to_scheduler();
-    std::thread([=] {
+    auto pool = detail::singletons::get_detached_thread_pool();
+    pool->run([=] {
       CAF_PUSH_AID(id());
       CAF_LOG_TRACE("");
       auto max_throughput = std::numeric_limits<size_t>::max();
@@ -471,7 +563,7 @@ void local_actor::launch(execution_unit* eu, bool lazy, bool hide) {
         CAF_REQUIRE(mailbox().blocked() == false);
       }
       detach_from_scheduler();
-    }).detach();
+    });
     return;
   }
   // actor is cooperatively scheduled
@@ -546,34 +638,15 @@ resumable::resume_result local_actor::resume(execution_unit* eu,
                                              size_t max_throughput) {
   CAF_LOG_TRACE("");
   if (is_blocking()) {
-    // actor lives in its own thread
     CAF_REQUIRE(dynamic_cast<blocking_actor*>(this) != 0);
     auto self = static_cast<blocking_actor*>(this);
-    uint32_t rsn = exit_reason::normal;
-    std::exception_ptr eptr = nullptr;
-    try {
-      self->act();
-    }
-    catch (actor_exited& e) {
-      rsn = e.reason();
+    if (!is_detached()) {
+      // actor uses its own stack but shares the worker with other actors
+      host(eu);
+      return self->resume_fiber(max_throughput);
     }
-    catch (...) {
-      rsn = exit_reason::unhandled_exception;
-      eptr = std::current_exception();
-    }
-    if (eptr) {
-      auto opt_reason = self->handle(eptr);
-      rsn = *opt_reason;
-    }
-    self->planned_exit_reason(rsn);
-    try {
-      self->on_exit();
-    }
-    catch (...) {
-      // simply ignore exception
-    }
-    // exit reason might have been changed by on_exit()
-    self->cleanup(self->planned_exit_reason());
+    // actor lives in its own thread
+    self->act_and_cleanup();
     return resumable::done;
   }
   // actor is cooperatively scheduled
@@ -713,6 +786,10 @@ resumable::resume_result local_actor::resume(execution_unit* eu,
   return resumable::done;
 }
 
+size_t local_actor::mailbox_size_hint() const {
+  return m_mailbox.size_hint();
+}
+
 mailbox_element_ptr local_actor::next_message() {
   if (!is_priority_aware()) {
     return mailbox_element_ptr{mailbox().try_pop()};
@@ -802,6 +879,9 @@ void local_actor::send_impl(message_id mid, abstract_channel* dest,
   if (!dest) {
     return;
   }
+  detail::trace_scope guard{detail::message_tracing_enabled()
+                            ? detail::sample_trace_context()
+                            : trace_context{0, 0}};
   dest->enqueue(address(), mid, std::move(what), host());
 }
 
@@ -832,6 +912,9 @@ response_promise local_actor::make_response_promise() {
 
 void local_actor::cleanup(uint32_t reason) {
   CAF_LOG_TRACE(CAF_ARG(reason));
+  if (m_metrics) {
+    detail::singletons::get_actor_registry()->remove_metrics_source(id());
+  }
   detail::sync_request_bouncer f{reason};
   m_mailbox.close(f);
   abstract_actor::cleanup(reason);
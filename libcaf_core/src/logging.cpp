@@ -18,15 +18,24 @@
  ******************************************************************************/
 
 #include <ctime>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
+#include <vector>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
-#include <pthread.h>
+#include <streambuf>
+#include <unordered_map>
 #include <condition_variable>
 
 #ifndef CAF_WINDOWS
 #include <unistd.h>
+#include <pthread.h>
 #include <sys/types.h>
 #endif
 
@@ -43,7 +52,6 @@
 #include "caf/actor_proxy.hpp"
 
 #include "caf/detail/logging.hpp"
-#include "caf/detail/single_reader_queue.hpp"
 
 namespace caf {
 namespace detail {
@@ -52,44 +60,141 @@ namespace {
 
 __thread actor_id t_self_id;
 
-constexpr struct pop_aid_log_event_t {
-  constexpr pop_aid_log_event_t() {
-    // nop
-  }
-} pop_aid_log_event;
+#ifndef CAF_LOG_LEVEL
+  constexpr int global_log_level = 0;
+#else
+  constexpr int global_log_level = CAF_LOG_LEVEL;
+#endif
+
+const char* log_level_table[] = {"ERROR", "WARN ", "INFO ", "DEBUG", "TRACE"};
 
+constexpr size_t max_msg_size = 448;
+
+// a log event as stored in the ring buffer of a thread; all strings
+// except the message itself have static storage duration
 struct log_event {
-  log_event* next;
-  log_event* prev;
-  std::string msg;
-  log_event(std::string logmsg = "")
-      : next(nullptr),
-        prev(nullptr),
-        msg(std::move(logmsg)) {
+  time_t timestamp;
+  actor_id aid;
+  int level;
+  int line_num;
+  const char* class_name;
+  const char* function_name;
+  const char* file_name;
+  size_t msg_size;
+  char msg[max_msg_size];
+};
+
+// a lock-free single-producer, single-consumer queue of log events
+struct log_ring {
+  static constexpr size_t capacity = 256;
+  log_ring() : head(0), tail(0), orphaned(false) {
+    std::ostringstream oss;
+    oss << std::this_thread::get_id();
+    thread_id = oss.str();
+  }
+  // next element to read, written by the logger only
+  std::atomic<size_t> head;
+  // next element to write, written by the owning thread only
+  std::atomic<size_t> tail;
+  // set by the owning thread on exit
+  std::atomic<bool> orphaned;
+  std::string thread_id;
+  log_event events[capacity];
+};
+
+constexpr size_t log_ring::capacity;
+
+// a stream buffer writing to a fixed-size array, silently
+// discarding all characters exceeding the array
+class fixed_buffer : public std::streambuf {
+ public:
+  fixed_buffer() {
+    reset();
+  }
+
+  void reset() {
+    setp(m_buf, m_buf + max_msg_size);
+  }
+
+  const char* data() const {
+    return pbase();
+  }
+
+  size_t size() const {
+    return static_cast<size_t>(pptr() - pbase());
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    return traits_type::not_eof(ch);
+  }
+
+ private:
+  char m_buf[max_msg_size];
+};
+
+struct thread_state {
+  thread_state() : out(&buf), owner(0) {
     // nop
   }
+  ~thread_state() {
+    if (ring) {
+      ring->orphaned = true;
+    }
+  }
+  fixed_buffer buf;
+  std::ostream out;
+  // ID of the logger draining `ring`, i.e., a logger created after
+  // shutting down the previous one needs to register a new ring buffer
+  size_t owner;
+  std::shared_ptr<log_ring> ring;
 };
 
-#ifndef CAF_LOG_LEVEL
-  constexpr int global_log_level = 0;
-#else
-  constexpr int global_log_level = CAF_LOG_LEVEL;
-#endif
+thread_state& this_thread_state() {
+  static thread_local thread_state result;
+  return result;
+}
+
+// accepts the same names as the configure script or a number
+int parse_log_level(const char* str) {
+  const char* names[] = {"ERROR", "WARNING", "INFO", "DEBUG", "TRACE"};
+  for (int i = 0; i < 5; ++i) {
+    if (strcmp(str, names[i]) == 0) {
+      return i;
+    }
+  }
+  if (str[0] >= '0' && str[0] <= '9') {
+    return atoi(str);
+  }
+  return global_log_level;
+}
+
+int initial_log_level() {
+  auto env = getenv("CAF_LOG_LEVEL");
+  auto lvl = env ? parse_log_level(env) : global_log_level;
+  return std::max(0, std::min(lvl, global_log_level));
+}
 
 class logging_impl : public logging {
  public:
+  logging_impl() : m_id(++s_instances), m_wakeup(false), m_shutdown(false) {
+    // nop
+  }
+
   void initialize() override {
-    const char* log_level_table[] = {"ERROR", "WARN", "INFO", "DEBUG", "TRACE"};
     m_thread = std::thread([this] { (*this)(); });
-    std::string msg = "ENTRY log level = ";
-    msg += log_level_table[global_log_level];
-    log("TRACE", "logging", "run", __FILE__, __LINE__, msg);
+    stream() << "ENTRY log level = " << log_level_table[logging::level()];
+    log(CAF_TRACE, "logging", "run", __FILE__, __LINE__);
   }
 
   void stop() override {
-    log("TRACE", "logging", "run", __FILE__, __LINE__, "EXIT");
-    // an empty string means: shut down
-    m_queue.synchronized_enqueue(m_queue_mtx, m_queue_cv, new log_event{""});
+    stream() << "EXIT";
+    log(CAF_TRACE, "logging", "run", __FILE__, __LINE__);
+    { // lifetime scope of guard
+      std::unique_lock<std::mutex> guard{m_mtx};
+      m_shutdown = true;
+      m_cv.notify_all();
+    }
     m_thread.join();
   }
 
@@ -97,24 +202,127 @@ class logging_impl : public logging {
     std::ostringstream fname;
     fname << "actor_log_" << getpid() << "_" << time(0) << ".log";
     std::fstream out(fname.str().c_str(), std::ios::out | std::ios::app);
-    std::unique_ptr<log_event> event;
+    std::vector<std::shared_ptr<log_ring>> rings;
     for (;;) {
-      // make sure we have data to read
-      m_queue.synchronized_await(m_queue_mtx, m_queue_cv);
-      // read & process event
-      event.reset(m_queue.try_pop());
-      CAF_REQUIRE(event != nullptr);
-      if (event->msg.empty()) {
+      bool done;
+      { // lifetime scope of guard
+        std::unique_lock<std::mutex> guard{m_mtx};
+        m_cv.wait_for(guard, std::chrono::milliseconds(50), [&] {
+          return m_wakeup.load() || m_shutdown.load();
+        });
+        m_wakeup = false;
+        done = m_shutdown;
+      }
+      { // lifetime scope of guard
+        std::lock_guard<std::mutex> guard{m_rings_mtx};
+        rings = m_rings;
+      }
+      bool removed_orphans = false;
+      for (auto& ring : rings) {
+        // read the flag before draining, i.e., an orphaned ring
+        // is guaranteed to be empty after the call to drain()
+        auto orphaned = ring->orphaned.load();
+        drain(*ring, out);
+        if (orphaned) {
+          ring.reset();
+          removed_orphans = true;
+        }
+      }
+      // write all events of this batch to the file at once
+      out.flush();
+      if (removed_orphans) {
+        std::lock_guard<std::mutex> guard{m_rings_mtx};
+        auto is_orphaned = [](const std::shared_ptr<log_ring>& ptr) {
+          return ptr->orphaned.load() && ptr->head == ptr->tail;
+        };
+        m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                     is_orphaned),
+                      m_rings.end());
+      }
+      if (done) {
         out.close();
         return;
       }
-      out << event->msg << std::flush;
     }
   }
 
-  void log(const char* level, const char* c_class_name,
-           const char* function_name, const char* c_full_file_name,
-           int line_num, const std::string& msg) override {
+  void log(int level, const char* class_name, const char* function_name,
+           const char* file_name, int line_num) override {
+    auto& st = this_thread_state();
+    if (!st.ring || st.owner != m_id) {
+      if (st.ring) {
+        st.ring->orphaned = true;
+      }
+      st.owner = m_id;
+      st.ring = std::make_shared<log_ring>();
+      std::lock_guard<std::mutex> guard{m_rings_mtx};
+      m_rings.push_back(st.ring);
+    }
+    auto& ring = *st.ring;
+    auto tail = ring.tail.load(std::memory_order_relaxed);
+    // wait for the logger thread if the ring buffer is full
+    while (tail - ring.head.load(std::memory_order_acquire)
+           >= log_ring::capacity) {
+      if (m_shutdown) {
+        // the logger thread no longer drains the ring buffer after stop()
+        st.buf.reset();
+        return;
+      }
+      wakeup();
+      std::this_thread::yield();
+    }
+    auto& e = ring.events[tail % log_ring::capacity];
+    e.timestamp = time(0);
+    e.aid = t_self_id;
+    e.level = level;
+    e.line_num = line_num;
+    e.class_name = class_name;
+    e.function_name = function_name;
+    e.file_name = file_name;
+    e.msg_size = st.buf.size();
+    memcpy(e.msg, st.buf.data(), e.msg_size);
+    st.buf.reset();
+    ring.tail.store(tail + 1, std::memory_order_release);
+    // wake up the logger early if the ring buffer is filling up
+    if (tail + 1 - ring.head.load(std::memory_order_relaxed)
+        >= log_ring::capacity / 2) {
+      wakeup();
+    }
+  }
+
+ private:
+  void wakeup() {
+    if (!m_wakeup.exchange(true)) {
+      std::lock_guard<std::mutex> guard{m_mtx};
+      m_cv.notify_one();
+    }
+  }
+
+  void drain(log_ring& ring, std::ostream& out) {
+    auto head = ring.head.load(std::memory_order_relaxed);
+    auto tail = ring.tail.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      auto& e = ring.events[head % log_ring::capacity];
+      auto file_name = strrchr(e.file_name, '/');
+      out << e.timestamp << " " << log_level_table[e.level] << " "
+          << "actor" << e.aid << " " << ring.thread_id << " "
+          << class_name(e.class_name) << " " << e.function_name << " "
+          << (file_name ? file_name + 1 : e.file_name) << ":"
+          << e.line_num << " ";
+      out.write(e.msg, static_cast<std::streamsize>(e.msg_size));
+      out << '\n';
+      // release the slot to the producer
+      ring.head.store(head + 1, std::memory_order_release);
+    }
+  }
+
+  // returns the demangled name for `c_class_name`, whereas the
+  // result is computed only once for each distinct pointer
+  const std::string& class_name(const char* c_class_name) {
+    auto i = m_class_names.find(c_class_name);
+    if (i != m_class_names.end()) {
+      return i->second;
+    }
 #   if defined(CAF_LINUX) || defined(CAF_MACOS)
     int stat = 0;
     std::unique_ptr<char, decltype(free)*> real_class_name{nullptr, free};
@@ -141,51 +349,53 @@ class logging_impl : public logging {
 #   else
     std::string class_name = c_class_name;
 #   endif
-    std::string file_name;
-    std::string full_file_name = c_full_file_name;
-    auto ri = find(full_file_name.rbegin(), full_file_name.rend(), '/');
-    if (ri != full_file_name.rend()) {
-      auto i = ri.base();
-      if (i == full_file_name.end()) {
-        file_name = std::move(full_file_name);
-      } else {
-        file_name = std::string(i, full_file_name.end());
-      }
-    } else {
-      file_name = std::move(full_file_name);
-    }
-    std::ostringstream line;
-    line << time(0) << " " << level << " "
-         << "actor" << t_self_id << " " << std::this_thread::get_id() << " "
-         << class_name << " " << function_name << " " << file_name << ":"
-         << line_num << " " << msg << std::endl;
-    m_queue.synchronized_enqueue(m_queue_mtx, m_queue_cv,
-                                 new log_event{line.str()});
+    return m_class_names.emplace(c_class_name,
+                                 std::move(class_name)).first->second;
   }
 
- private:
+  static std::atomic<size_t> s_instances;
+  size_t m_id;
   std::thread m_thread;
-  std::mutex m_queue_mtx;
-  std::condition_variable m_queue_cv;
-  detail::single_reader_queue<log_event> m_queue;
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  std::atomic<bool> m_wakeup;
+  std::atomic<bool> m_shutdown;
+  std::mutex m_rings_mtx;
+  std::vector<std::shared_ptr<log_ring>> m_rings;
+  // accessed only by the logger thread
+  std::unordered_map<const char*, std::string> m_class_names;
 };
 
+std::atomic<size_t> logging_impl::s_instances;
+
 } // namespace <anonymous>
 
-logging::trace_helper::trace_helper(std::string class_name,
-                                    const char* fun_name, const char* file_name,
-                                    int line_num, const std::string& msg)
-    : m_class(std::move(class_name)),
-      m_fun_name(fun_name),
-      m_file_name(file_name),
-      m_line_num(line_num) {
-  singletons::get_logger()->log("TRACE", m_class.c_str(), fun_name, file_name,
-                                line_num, "ENTRY " + msg);
+std::atomic<int> logging::s_level{initial_log_level()};
+
+int logging::level() {
+  return s_level.load(std::memory_order_relaxed);
+}
+
+void logging::level(int new_level) {
+  s_level = std::max(0, std::min(new_level, global_log_level));
+}
+
+std::ostream& logging::stream() {
+  auto& st = this_thread_state();
+  st.buf.reset();
+  st.out.clear();
+  st.out.flags(std::ios::dec | std::ios::skipws | std::ios::boolalpha);
+  st.out.precision(6);
+  st.out.fill(' ');
+  return st.out;
 }
 
 logging::trace_helper::~trace_helper() {
-  singletons::get_logger()->log("TRACE", m_class.c_str(), m_fun_name,
-                                m_file_name, m_line_num, "EXIT");
+  if (m_enabled) {
+    auto logger = singletons::get_logger();
+    stream() << "EXIT";
+    logger->log(CAF_TRACE, m_class, m_fun_name, m_file_name, m_line_num);
+  }
 }
 
 logging::~logging() {
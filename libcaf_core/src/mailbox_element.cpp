@@ -34,7 +34,9 @@ mailbox_element::mailbox_element(actor_addr arg0, message_id arg1)
       marked(false),
       sender(std::move(arg0)),
       mid(arg1) {
-  // nop
+  if (detail::message_tracing_enabled()) {
+    span = detail::make_message_span(sender.id());
+  }
 }
 
 mailbox_element::mailbox_element(actor_addr arg0, message_id arg1, message arg2)
@@ -44,7 +46,9 @@ mailbox_element::mailbox_element(actor_addr arg0, message_id arg1, message arg2)
       sender(std::move(arg0)),
       mid(arg1),
       msg(std::move(arg2)) {
-  // nop
+  if (detail::message_tracing_enabled()) {
+    span = detail::make_message_span(sender.id());
+  }
 }
 
 mailbox_element::~mailbox_element() {
@@ -53,6 +57,16 @@ mailbox_element::~mailbox_element() {
 
 mailbox_element_ptr mailbox_element::make(actor_addr sender, message_id id,
                                             message msg) {
+  if (msg.cvals() && msg.cvals()->unique()) {
+    intrusive_ptr<ref_counted> storage;
+    auto slot = msg.cvals().get()->claim_mailbox_slot(storage);
+    if (slot) {
+      using embedded_t = detail::embedded<mailbox_element>;
+      auto ptr = new (slot) embedded_t(std::move(storage), std::move(sender),
+                                       id, std::move(msg));
+      return mailbox_element_ptr{ptr};
+    }
+  }
   auto ptr = detail::memory::create<mailbox_element>(std::move(sender), id,
                                                      std::move(msg));
   return mailbox_element_ptr{ptr};
@@ -29,4 +29,11 @@ match_case::match_case(bool hw, uint32_t tt) : m_has_wildcard(hw), m_token(tt) {
   // nop
 }
 
+match_case::match_case(bool hw, uint32_t tt, optional<atom_value> la)
+    : m_has_wildcard(hw),
+      m_token(tt),
+      m_leading_atom(std::move(la)) {
+  // nop
+}
+
 } // namespace caf
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/message_arena.hpp"
+
+#include <new>
+#include <atomic>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// alignment guaranteed by ::operator new
+constexpr size_t max_align = alignof(std::max_align_t);
+
+constexpr size_t align(size_t size) {
+  return (size + max_align - 1) & ~(max_align - 1);
+}
+
+std::atomic<size_t> s_num_chunks{0};
+
+message_arena*& active_arena() {
+  static thread_local message_arena* result = nullptr;
+  return result;
+}
+
+} // namespace <anonymous>
+
+struct message_arena::chunk {
+  // one reference per allocated object plus one for the owning arena
+  std::atomic<size_t> rc;
+  char* pos;
+  char* end;
+
+  static chunk* make() {
+    auto mem = static_cast<char*>(::operator new(chunk_size));
+    auto result = new (mem) chunk;
+    result->rc = 1;
+    result->pos = mem + align(sizeof(chunk));
+    result->end = mem + chunk_size;
+    s_num_chunks.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  void deref() {
+    if (rc.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      s_num_chunks.fetch_sub(1, std::memory_order_relaxed);
+      this->~chunk();
+      ::operator delete(this);
+    }
+  }
+};
+
+namespace {
+
+// follows each allocation to find its chunk on deallocation: the offset
+// of the object to the beginning of its chunk in units of max_align
+// or 0 for heap-allocated objects
+using tag = uint16_t;
+
+static_assert(message_arena::chunk_size / max_align
+              <= std::numeric_limits<tag>::max(),
+              "chunk_size too large for the allocation tag");
+
+void write_tag(void* obj, size_t size, tag x) {
+  memcpy(static_cast<char*>(obj) + size, &x, sizeof(tag));
+}
+
+tag read_tag(void* obj, size_t size) {
+  tag result;
+  memcpy(&result, static_cast<char*>(obj) + size, sizeof(tag));
+  return result;
+}
+
+} // namespace <anonymous>
+
+message_arena::message_arena() : m_chunk(nullptr) {
+  // nop
+}
+
+message_arena::message_arena(message_arena&& other) : m_chunk(other.m_chunk) {
+  other.m_chunk = nullptr;
+}
+
+message_arena& message_arena::operator=(message_arena&& other) {
+  std::swap(m_chunk, other.m_chunk);
+  return *this;
+}
+
+message_arena::~message_arena() {
+  if (m_chunk) {
+    m_chunk->deref();
+  }
+}
+
+message_arena::scope::scope(message_arena& arena) : m_prev(active_arena()) {
+  active_arena() = &arena;
+}
+
+message_arena::scope::~scope() {
+  active_arena() = m_prev;
+}
+
+message_arena* message_arena::exchange_active(message_arena* arena) {
+  auto result = active_arena();
+  active_arena() = arena;
+  return result;
+}
+
+void* message_arena::allocate(size_t size) {
+  auto arena = active_arena();
+  if (arena && size <= max_object_size) {
+    return arena->allocate_impl(size);
+  }
+  auto result = ::operator new(size + sizeof(tag));
+  write_tag(result, size, 0);
+  return result;
+}
+
+void message_arena::deallocate(void* ptr, size_t size) {
+  if (!ptr) {
+    return;
+  }
+  auto offset = read_tag(ptr, size);
+  if (offset == 0) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto owner = static_cast<char*>(ptr) - offset * max_align;
+  reinterpret_cast<chunk*>(owner)->deref();
+}
+
+size_t message_arena::num_chunks() {
+  return s_num_chunks.load(std::memory_order_relaxed);
+}
+
+void* message_arena::allocate_impl(size_t size) {
+  auto n = align(size + sizeof(tag));
+  if (!m_chunk || static_cast<size_t>(m_chunk->end - m_chunk->pos) < n) {
+    // objects of the previous chunk keep it alive as long as needed
+    if (m_chunk) {
+      m_chunk->deref();
+    }
+    m_chunk = chunk::make();
+  }
+  auto result = m_chunk->pos;
+  m_chunk->pos += n;
+  m_chunk->rc.fetch_add(1, std::memory_order_relaxed);
+  auto offset = (result - reinterpret_cast<char*>(m_chunk)) / max_align;
+  write_tag(result, size, static_cast<tag>(offset));
+  return result;
+}
+
+} // namespace detail
+} // namespace caf
@@ -118,6 +118,10 @@ message_builder::message_builder() {
   init();
 }
 
+message_builder::message_builder(detail::mailbox_slot_t) {
+  m_data.reset(detail::make_with_mailbox_slot<dynamic_msg_data>(), false);
+}
+
 message_builder::~message_builder() {
   // nop
 }
@@ -141,6 +145,11 @@ bool message_builder::empty() const {
   return size() == 0;
 }
 
+message_builder& message_builder::reserve(size_t num_elements) {
+  data()->m_elements.reserve(num_elements);
+  return *this;
+}
+
 message_builder& message_builder::append(uniform_value what) {
   data()->append(std::move(what));
   return *this;
@@ -28,6 +28,10 @@ message_data::~message_data() {
   // nop
 }
 
+void* message_data::claim_mailbox_slot(intrusive_ptr<ref_counted>&) {
+  return nullptr;
+}
+
 bool message_data::equals(const message_data& other) const {
   if (this == &other) {
     return true;
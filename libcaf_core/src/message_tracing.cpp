@@ -0,0 +1,212 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/message_tracing.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include "caf/on.hpp"
+#include "caf/spawn.hpp"
+#include "caf/blocking_actor.hpp"
+#include "caf/system_messages.hpp"
+
+#include "caf/detail/singletons.hpp"
+
+namespace caf {
+
+namespace {
+
+// maximum number of spans kept in memory until collected
+constexpr size_t max_buffered_spans = 65536;
+
+std::atomic<bool> s_enabled{false};
+std::atomic<uint64_t> s_interval{0};
+std::atomic<double> s_rate{0.};
+
+std::mutex s_buf_mtx;
+std::vector<message_span> s_buf;
+
+trace_context& thread_context() {
+  static thread_local trace_context result{0, 0};
+  return result;
+}
+
+uint64_t next_id() {
+  static thread_local std::mt19937_64 engine{std::random_device{}()};
+  uint64_t result;
+  do {
+    result = engine();
+  } while (result == 0);
+  return result;
+}
+
+void write_timestamp(std::ostream& out, int64_t ns) {
+  // the Trace Event Format expects microseconds
+  out << (ns / 1000) << '.' << std::setw(3) << std::setfill('0')
+      << (ns % 1000) << std::setfill(' ');
+}
+
+void write_id(std::ostream& out, uint64_t x) {
+  // 64-bit integers exceed the precision of JSON numbers in most parsers
+  out << "\"0x" << std::hex << x << std::dec << '"';
+}
+
+void trace_collector(blocking_actor* self, const std::string& path,
+                     std::chrono::milliseconds interval) {
+  self->trap_exit(true);
+  std::ofstream out{path};
+  bool first = true;
+  auto collect = [&] {
+    for (auto& x : take_message_spans()) {
+      out << (first ? "[\n" : ",\n") << to_trace_event(x);
+      first = false;
+    }
+    out.flush();
+  };
+  bool running = true;
+  self->receive_while([&] { return running; })(
+    [&](const exit_msg&) {
+      running = false;
+    },
+    others >> [] {
+      // nop
+    },
+    after(interval) >> collect
+  );
+  collect();
+  out << (first ? "[\n" : "\n") << "]\n";
+}
+
+} // namespace <anonymous>
+
+void set_message_tracing_rate(double rate) {
+  uint64_t interval = 0;
+  if (rate > 0.) {
+    interval = rate >= 1. ? 1 : static_cast<uint64_t>(1. / rate + 0.5);
+  }
+  s_rate = rate > 0. ? rate : 0.;
+  s_interval = interval;
+  s_enabled = interval > 0;
+}
+
+double message_tracing_rate() {
+  return s_rate;
+}
+
+std::vector<message_span> take_message_spans() {
+  std::vector<message_span> result;
+  std::lock_guard<std::mutex> guard{s_buf_mtx};
+  s_buf.swap(result);
+  return result;
+}
+
+std::string to_trace_event(const message_span& x) {
+  std::ostringstream oss;
+  auto pid = detail::singletons::get_node_id().process_id();
+  oss << "{\"name\":\"actor " << x.receiver << "\""
+      << ",\"cat\":\"message\",\"ph\":\"X\",\"ts\":";
+  write_timestamp(oss, x.dequeued);
+  oss << ",\"dur\":";
+  write_timestamp(oss, x.completed - x.dequeued);
+  oss << ",\"pid\":" << pid
+      << ",\"tid\":" << x.receiver
+      << ",\"args\":{\"trace_id\":";
+  write_id(oss, x.trace_id);
+  oss << ",\"span_id\":";
+  write_id(oss, x.span_id);
+  oss << ",\"parent_id\":";
+  write_id(oss, x.parent_id);
+  oss << ",\"sender\":" << x.sender
+      << ",\"queued_us\":";
+  write_timestamp(oss, x.dequeued - x.enqueued);
+  oss << "}}";
+  return oss.str();
+}
+
+actor spawn_trace_collector(std::string path,
+                            std::chrono::milliseconds interval) {
+  return spawn<hidden + detached + blocking_api>(trace_collector,
+                                                 std::move(path), interval);
+}
+
+namespace detail {
+
+bool message_tracing_enabled() {
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+trace_context current_trace_context() {
+  return thread_context();
+}
+
+trace_context exchange_trace_context(trace_context ctx) {
+  auto& ref = thread_context();
+  auto result = ref;
+  ref = ctx;
+  return result;
+}
+
+std::unique_ptr<message_span> make_message_span(actor_id sender) {
+  auto& ctx = thread_context();
+  if (ctx.trace_id == 0) {
+    return nullptr;
+  }
+  std::unique_ptr<message_span> result{new message_span};
+  result->trace_id = ctx.trace_id;
+  result->span_id = next_id();
+  result->parent_id = ctx.span_id;
+  result->sender = sender;
+  result->receiver = 0;
+  result->enqueued = trace_timestamp();
+  result->dequeued = 0;
+  result->completed = 0;
+  return result;
+}
+
+trace_context sample_trace_context() {
+  static thread_local uint64_t count = 0;
+  auto interval = s_interval.load(std::memory_order_relaxed);
+  if (interval == 0 || thread_context().trace_id != 0
+      || ++count % interval != 0) {
+    return {0, 0};
+  }
+  // a root context has no span, i.e., spans created
+  // in this context have no parent
+  return {next_id(), 0};
+}
+
+void record_message_span(std::unique_ptr<message_span> ptr) {
+  std::lock_guard<std::mutex> guard{s_buf_mtx};
+  if (s_buf.size() < max_buffered_spans) {
+    s_buf.push_back(*ptr);
+  }
+}
+
+int64_t trace_timestamp() {
+  auto t = std::chrono::system_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+} // namespace detail
+} // namespace caf
@@ -28,6 +28,9 @@ response_promise::response_promise(const actor_addr& from, const actor_addr& to,
                                    const message_id& id)
     : m_from(from), m_to(to), m_id(id) {
   CAF_REQUIRE(id.is_response() || !id.valid());
+  if (detail::message_tracing_enabled()) {
+    m_trace = detail::current_trace_context();
+  }
 }
 
 void response_promise::deliver(message msg) const {
@@ -36,6 +39,7 @@ void response_promise::deliver(message msg) const {
   }
   auto to = actor_cast<abstract_actor_ptr>(m_to);
   auto from = actor_cast<abstract_actor_ptr>(m_from);
+  detail::trace_scope guard{m_trace};
   to->enqueue(m_from, m_id, std::move(msg), from->host());
 }
 
@@ -21,6 +21,7 @@
 
 #include "caf/set_scheduler.hpp"
 #include "caf/detail/singletons.hpp"
+#include "caf/detail/detached_thread_pool.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
 
 namespace caf {
@@ -32,4 +33,12 @@ void set_scheduler(scheduler::abstract_coordinator* impl) {
   }
 }
 
+void set_detached_thread_pool(size_t max_idle_threads, size_t stack_size) {
+  auto impl = new detail::detached_thread_pool(max_idle_threads, stack_size);
+  if (!detail::singletons::set_detached_thread_pool(impl)) {
+    delete impl;
+    throw std::logic_error("detached thread pool already defined");
+  }
+}
+
 } // namespace caf
@@ -29,6 +29,7 @@
 #include "caf/detail/singletons.hpp"
 #include "caf/detail/group_manager.hpp"
 #include "caf/detail/actor_registry.hpp"
+#include "caf/detail/detached_thread_pool.hpp"
 #include "caf/detail/uniform_type_info_map.hpp"
 
 namespace caf {
@@ -54,6 +55,9 @@ std::mutex s_group_manager_mtx;
 std::atomic<node_id::data*> s_node_id;
 std::mutex s_node_id_mtx;
 
+std::atomic<detached_thread_pool*> s_detached_thread_pool;
+std::mutex s_detached_thread_pool_mtx;
+
 std::atomic<logging*> s_logger;
 std::mutex s_logger_mtx;
 
@@ -79,6 +83,8 @@ void singletons::stop_singletons() {
   stop(s_scheduling_coordinator);
   CAF_LOGF_DEBUG("stop actor registry");
   stop(s_actor_registry);
+  CAF_LOGF_DEBUG("stop detached thread pool");
+  stop(s_detached_thread_pool);
   // dispose singletons, i.e., release memory
   CAF_LOGF_DEBUG("dispose plugins");
   for (auto& plugin : s_plugins) {
@@ -90,6 +96,8 @@ void singletons::stop_singletons() {
   dispose(s_scheduling_coordinator);
   CAF_LOGF_DEBUG("dispose registry");
   dispose(s_actor_registry);
+  CAF_LOGF_DEBUG("dispose detached thread pool");
+  dispose(s_detached_thread_pool);
   // final steps
   CAF_LOGF_DEBUG("stop and dispose logger, bye");
   stop(s_logger);
@@ -122,6 +130,16 @@ bool singletons::set_scheduling_coordinator(scheduler::abstract_coordinator*p) {
   return res == p;
 }
 
+detached_thread_pool* singletons::get_detached_thread_pool() {
+  return lazy_get(s_detached_thread_pool, s_detached_thread_pool_mtx);
+}
+
+bool singletons::set_detached_thread_pool(detached_thread_pool* p) {
+  auto res = lazy_get(s_detached_thread_pool, s_detached_thread_pool_mtx,
+                      [p] { return p; });
+  return res == p;
+}
+
 node_id singletons::get_node_id() {
   return node_id{lazy_get(s_node_id, s_node_id_mtx)};
 }
@@ -97,6 +97,13 @@ uniform_value uniform_type_info::deserialize(deserializer* src) const {
   return std::move(uval);
 }
 
+void uniform_type_info::deserialize_message(message& msg,
+                                            deserializer* source) const {
+  auto uval = create();
+  deserialize(uval->val, source);
+  msg = as_message(uval->val);
+}
+
 std::vector<const uniform_type_info*> uniform_type_info::instances() {
   return uti_map().get_all();
 }
@@ -248,11 +248,8 @@ void serialize_impl(const message& tup, serializer* sink) {
 
 void deserialize_impl(message& atref, deserializer* source) {
   auto uti = source->begin_object();
-  auto uval = uti->create();
-  // auto ptr = uti->new_instance();
-  uti->deserialize(uval->val, source);
+  uti->deserialize_message(atref, source);
   source->end_object();
-  atref = uti->as_message(uval->val);
 }
 
 void serialize_impl(const node_id& nid, serializer* sink) {
@@ -519,6 +516,12 @@ class default_meta_message : public uniform_type_info {
   message as_message(void* ptr) const override {
     return *cast(ptr);
   }
+  void deserialize_message(message& msg,
+                           deserializer* source) const override {
+    // deserialize in place, i.e., without creating a
+    // default-constructed message that is overridden anyway
+    deserialize(&msg, source);
+  }
   const char* name() const override {
     return m_name.c_str();
   }
@@ -530,11 +533,13 @@ class default_meta_message : public uniform_type_info {
     }
   }
   void deserialize(void* ptr, deserializer* source) const override {
-    message_builder mb;
+    // deserialized messages are usually enqueued right away
+    message_builder mb{detail::mailbox_slot};
+    mb.reserve(m_elements.size());
     for (size_t i = 0; i < m_elements.size(); ++i) {
       mb.append(m_elements[i]->deserialize(source));
     }
-    *cast(ptr) = mb.to_message();
+    *cast(ptr) = mb.move_to_message();
   }
 
   bool equal_to(const std::type_info&) const override {
@@ -48,10 +48,33 @@ struct header {
 };
 
 /**
- * The current BASP version. Different BASP versions will not
- * be able to exchange messages.
+ * The current BASP version. Nodes agree on the smaller of their two
+ * versions during the handshake and never send operations the other
+ * side does not know.
  */
-constexpr uint64_t version = 1;
+constexpr uint64_t version = 2;
+
+/**
+ * The oldest BASP version this node is able to exchange messages with.
+ */
+constexpr uint64_t min_version = 1;
+
+/**
+ * The version announced in the header of server handshakes. Clients
+ * using BASP version 1 close connections to servers announcing any other
+ * version, hence servers append their actual version to the payload.
+ */
+constexpr uint64_t handshake_version = 1;
+
+/**
+ * The first BASP version supporting `dispatch_traced_message`.
+ */
+constexpr uint64_t traced_message_version = 2;
+
+/**
+ * The first BASP version supporting `resolve_request` and `resolve_response`.
+ */
+constexpr uint64_t resolve_version = 2;
 
 /**
  * Size of a BASP header in serialized form
@@ -89,7 +112,11 @@ inline bool nonzero(T aid) {
  * source_actor   | Optional: ID of published actor
  * dest_actor     | 0
  * payload_len    | Optional: size of actor id + interface definition
- * operation_data | BASP version of the server
+ *                | + BASP version of the server
+ * operation_data | `handshake_version`
+ *
+ * Clients using BASP version 1 ignore the trailing BASP version. Servers
+ * without a published actor send no payload and are treated as version 1.
  */
 constexpr uint32_t server_handshake = 0x00;
 
@@ -113,7 +140,9 @@ inline bool server_handshake_valid(const header& hdr) {
  * source_actor   | 0
  * dest_actor     | 0
  * payload_len    | 0
- * operation_data | 0
+ * operation_data | 0 for BASP version 1, agreed-upon BASP version otherwise
+ *
+ * Servers using BASP version 1 close connections if operation_data is not 0.
  */
 constexpr uint32_t client_handshake = 0x01;
 
@@ -124,7 +153,7 @@ inline bool client_handshake_valid(const header& hdr) {
        && zero(hdr.source_actor)
        && zero(hdr.dest_actor)
        && zero(hdr.payload_len)
-       && zero(hdr.operation_data);
+       && hdr.operation_data <= version;
 }
 
 /**
@@ -200,6 +229,80 @@ inline bool kill_proxy_instance_valid(const header& hdr) {
        && nonzero(hdr.operation_data);
 }
 
+/**
+ * Transmits a message that is part of a sampled trace. Other than
+ * `dispatch_message`, the payload starts with the trace ID and the
+ * span ID of the sender (two uint64) followed by the message.
+ * Only used while message tracing is enabled on the sending node and
+ * only sent to nodes using at least `traced_message_version`. Nodes
+ * forwarding this message to an older node strip the trace context.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of sending node (invalid in case of anon_send)
+ * dest_node      | ID of receiving node
+ * source_actor   | ID of sending actor (invalid in case of anon_send)
+ * dest_actor     | ID of receiving actor, must not be invalid
+ * payload_len    | size of trace context and serialized message object
+ * operation_data | message ID (0 for asynchronous messages)
+ */
+constexpr uint32_t dispatch_traced_message = 0x05;
+
+inline bool dispatch_traced_message_valid(const header& hdr) {
+  return  dispatch_message_valid(hdr)
+       && hdr.payload_len > sizeof(uint64_t) * 2;
+}
+
+/**
+ * Asks the receiving node for the actor it has published at a given port.
+ * Allows a node to look up further published actors of a node it is
+ * already connected to without opening a new connection. Only sent to
+ * nodes using at least `resolve_version`.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of sending node
+ * dest_node      | ID of receiving node
+ * source_actor   | 0
+ * dest_actor     | 0
+ * payload_len    | size of the port (uint16)
+ * operation_data | request ID chosen by the sending node
+ */
+constexpr uint32_t resolve_request = 0x06;
+
+inline bool resolve_request_valid(const header& hdr) {
+  return  valid(hdr.source_node)
+       && valid(hdr.dest_node)
+       && hdr.source_node != hdr.dest_node
+       && zero(hdr.source_actor)
+       && zero(hdr.dest_actor)
+       && hdr.payload_len == sizeof(uint16_t);
+}
+
+/**
+ * Answers a `resolve_request`. The payload has the same format as the
+ * payload of a `server_handshake`.
+ *
+ * Field          | Assignment
+ * ---------------|----------------------------------------------------------
+ * source_node    | ID of sending node
+ * dest_node      | ID of receiving node
+ * source_actor   | ID of published actor or 0 if the port is not in use
+ * dest_actor     | 0
+ * payload_len    | Optional: size of actor id + interface definition
+ * operation_data | request ID of the `resolve_request`
+ */
+constexpr uint32_t resolve_response = 0x07;
+
+inline bool resolve_response_valid(const header& hdr) {
+  return  valid(hdr.source_node)
+       && valid(hdr.dest_node)
+       && hdr.source_node != hdr.dest_node
+       && zero(hdr.dest_actor)
+       && (   (nonzero(hdr.source_actor) && nonzero(hdr.payload_len))
+           || (zero(hdr.source_actor) && zero(hdr.payload_len)));
+}
+
 /**
  * Checks whether given header is valid.
  */
@@ -217,6 +320,12 @@ inline bool valid(header& hdr) {
       return announce_proxy_instance_valid(hdr);
     case kill_proxy_instance:
       return kill_proxy_instance_valid(hdr);
+    case dispatch_traced_message:
+      return dispatch_traced_message_valid(hdr);
+    case resolve_request:
+      return resolve_request_valid(hdr);
+    case resolve_response:
+      return resolve_response_valid(hdr);
   }
 }
 
@@ -31,6 +31,8 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/forwarding_actor_proxy.hpp"
 
+#include "caf/detail/message_arena.hpp"
+
 #include "caf/io/basp.hpp"
 #include "caf/io/broker.hpp"
 
@@ -55,6 +57,9 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   bool remove_published_actor(const abstract_actor_ptr& whom, uint16_t port);
 
+  // removes the `port => hdl` mapping and returns whether it existed
+  bool erase_open_port(uint16_t port, accept_handle hdl);
+
   actor_proxy_ptr make_proxy(const node_id&, actor_id) override;
 
   class payload_writer {
@@ -124,8 +129,28 @@ class basp_broker : public broker, public actor_namespace::backend {
     // a bug where re-using an "old" connection via
     // remote_actor() could return an expired proxy
     actor published_actor;
+    // allocates the wrappers of deserialized messages in chunks that are
+    // released once all messages from a chunk have been consumed
+    detail::message_arena arena;
+    // lookups for published actors of the remote node that
+    // await a `resolve_response` on this connection
+    std::map<int64_t, client_handshake_data> pending_resolves;
+    // BASP version both nodes agreed upon, 0 until the handshake completes
+    uint64_t remote_version = 0;
   };
 
+  // returns the BASP version agreed upon for `hdl` or 0 if unknown
+  uint64_t remote_version(connection_handle hdl) const;
+
+  // stops reading from `source` until `route` is no longer congested
+  void stall(connection_handle source, connection_handle route);
+
+  // resumes reading from all connections stalled by `route`
+  void unstall(connection_handle route);
+
+  // lets proxies block local senders while their route is congested
+  void update_congested_proxies();
+
   void read(binary_deserializer& bs, basp::header& msg);
 
   void write(binary_serializer& bs, const basp::header& msg);
@@ -206,12 +231,17 @@ class basp_broker : public broker, public actor_namespace::backend {
 
   actor_namespace m_namespace; // manages proxies
   std::map<connection_handle, connection_context> m_ctx;
+  // acceptors listening on a Unix domain socket use port 0
   std::map<accept_handle, std::pair<abstract_actor_ptr, uint16_t>> m_acceptors;
-  std::map<uint16_t, accept_handle> m_open_ports;
+  // a port has multiple acceptors when using SO_REUSEPORT
+  std::multimap<uint16_t, accept_handle> m_open_ports;
   routing_table m_routes; // stores non-direct routes
   std::set<blacklist_entry, blacklist_less> m_blacklist; // stores invalidated
                                                          // routes
   std::set<pending_request> m_pending_requests;
+  std::set<connection_handle> m_congested; // connections above high watermark
+  // congested connection => connections forwarding messages to it
+  std::map<connection_handle, std::set<connection_handle>> m_stalled;
 
   // needed to keep track to which node we are talking to at the moment
   connection_context* m_current_context;
@@ -34,11 +34,14 @@
 #include "caf/io/fwd.hpp"
 #include "caf/io/accept_handle.hpp"
 #include "caf/io/receive_policy.hpp"
+#include "caf/io/endpoint_handle.hpp"
+#include "caf/io/datagram_handle.hpp"
 #include "caf/io/system_messages.hpp"
 #include "caf/io/connection_handle.hpp"
 #include "caf/io/network/native_socket.hpp"
 #include "caf/io/network/stream_manager.hpp"
 #include "caf/io/network/acceptor_manager.hpp"
+#include "caf/io/network/datagram_manager.hpp"
 
 namespace caf {
 namespace io {
@@ -106,6 +109,16 @@ class broker : public abstract_event_based_actor<behavior, false> {
      */
     virtual buffer_type& wr_buf() = 0;
 
+    /**
+     * Configures when to signalize backpressure to the broker.
+     */
+    virtual void write_watermarks(size_t low, size_t high) = 0;
+
+    /**
+     * Stops or resumes reading from the connection.
+     */
+    virtual void pause_reading(bool paused) = 0;
+
     /**
      * Flushes the output buffer, i.e., sends the content of
      *    the buffer via the network.
@@ -135,6 +148,8 @@ class broker : public abstract_event_based_actor<behavior, false> {
 
     void consume(const void* data, size_t num_bytes) override;
 
+    void backpressure(bool congested) override;
+
     connection_handle m_hdl;
 
     message m_read_msg;
@@ -180,11 +195,85 @@ class broker : public abstract_event_based_actor<behavior, false> {
 
   using doorman_pointer = intrusive_ptr<doorman>;
 
+  /**
+   * Manages a datagram socket.
+   */
+  class datagram_servant : public network::datagram_manager, public servant {
+   public:
+    datagram_servant(broker* parent, datagram_handle hdl);
+
+    ~datagram_servant();
+
+    /**
+     * Configures the maximum size of received datagrams. Larger
+     * datagrams are truncated by the network layer and get dropped.
+     */
+    virtual void max_datagram_size(size_t num_bytes) = 0;
+
+    /**
+     * Configures how many endpoints learned from received datagrams
+     * the servant keeps at most before evicting the least recently
+     * used one.
+     */
+    virtual void max_endpoints(size_t num_endpoints) = 0;
+
+    /**
+     * Resolves `host` and returns a handle for sending datagrams
+     * to `host` on given `port`. The handle remains valid until
+     * released via `release_endpoint`.
+     */
+    virtual endpoint_handle add_endpoint(const std::string& host,
+                                         uint16_t port) = 0;
+
+    /**
+     * Forgets `ep`. Datagrams for released endpoints are dropped.
+     */
+    virtual void release_endpoint(endpoint_handle ep) = 0;
+
+    /**
+     * Enqueues a datagram for `ep`.
+     */
+    virtual void write(endpoint_handle ep, const void* buf,
+                       size_t num_bytes) = 0;
+
+    /**
+     * Sends all enqueued datagrams via the network.
+     */
+    virtual void flush() = 0;
+
+    inline datagram_handle hdl() const {
+      return m_hdl;
+    }
+
+    void io_failure(network::operation op) override;
+
+    // needs to be launched explicitly
+    virtual void launch() = 0;
+
+   protected:
+    inline new_datagram_msg& read_msg() {
+      return m_read_msg.get_as_mutable<new_datagram_msg>(0);
+    }
+
+    void remove_from_broker() override;
+
+    message disconnect_message() override;
+
+    void consume(endpoint_handle ep, buffer_type& buf) override;
+
+    datagram_handle m_hdl;
+
+    message m_read_msg;
+  };
+
+  using datagram_servant_pointer = intrusive_ptr<datagram_servant>;
+
   class continuation;
 
   // a broker needs friends
   friend class scribe;
   friend class doorman;
+  friend class datagram_servant;
   friend class continuation;
 
   ~broker();
@@ -196,6 +285,29 @@ class broker : public abstract_event_based_actor<behavior, false> {
    */
   void configure_read(connection_handle hdl, receive_policy::config config);
 
+  /**
+   * Modifies the write watermarks for given connection. Once more than
+   * `high` bytes are waiting to be sent, the broker receives a
+   * `connection_backpressure_msg` with `congested == true`. Once the
+   * unsent data dropped to `low` bytes or less, the broker receives a
+   * `connection_backpressure_msg` with `congested == false`.
+   * A high watermark of 0, the default, disables these messages.
+   * @param hdl Identifies the affected connection.
+   * @param low Number of bytes for leaving the congested state.
+   * @param high Number of bytes for entering the congested state.
+   */
+  void write_watermarks(connection_handle hdl, size_t low, size_t high);
+
+  /**
+   * Stops reading from given connection without closing it if `paused`
+   * is `true` and resumes reading otherwise. While paused, the broker
+   * receives no `new_data_msg` for the connection and the peer eventually
+   * blocks once the receive buffer of the socket is full.
+   * @param hdl Identifies the affected connection.
+   * @param paused Whether to stop or resume reading.
+   */
+  void pause_reading(connection_handle hdl, bool paused);
+
   /**
    * Returns the write buffer for given connection.
    */
@@ -220,6 +332,50 @@ class broker : public abstract_event_based_actor<behavior, false> {
 
   std::vector<connection_handle> connections() const;
 
+  /**
+   * Configures the maximum size of datagrams received by given servant.
+   */
+  void max_datagram_size(datagram_handle hdl, size_t num_bytes);
+
+  /**
+   * Configures how many endpoints learned from received datagrams given
+   * servant keeps at most. Exceeding the limit evicts the endpoint
+   * that neither sent nor received a datagram for the longest time.
+   */
+  void max_udp_endpoints(datagram_handle hdl, size_t num_endpoints);
+
+  /**
+   * Returns a handle for sending datagrams via `hdl` to `host` on `port`.
+   * The handle remains valid until released via `release_udp_endpoint`.
+   */
+  endpoint_handle add_udp_endpoint(datagram_handle hdl,
+                                   const std::string& host, uint16_t port);
+
+  /**
+   * Releases the endpoint `ep` of given servant.
+   */
+  void release_udp_endpoint(datagram_handle hdl, endpoint_handle ep);
+
+  /**
+   * Enqueues a datagram containing `data` for endpoint `ep` of given
+   * servant. Enqueued datagrams are sent after calling `flush` or
+   * after returning from the handler for a `new_datagram_msg`.
+   */
+  void write(datagram_handle hdl, endpoint_handle ep, size_t data_size,
+             const void* data);
+
+  /**
+   * Sends all datagrams enqueued for given servant.
+   */
+  void flush(datagram_handle hdl);
+
+  /**
+   * Returns the number of open datagram servants.
+   */
+  inline size_t num_datagram_servants() const {
+    return m_datagram_servants.size();
+  }
+
   /** @cond PRIVATE */
 
   void initialize() override;
@@ -272,6 +428,36 @@ class broker : public abstract_event_based_actor<behavior, false> {
 
   accept_handle add_tcp_doorman(network::native_socket fd);
 
+  /**
+   * Connects to the Unix domain socket at `path`.
+   */
+  connection_handle add_local_scribe(const std::string& path);
+
+  void assign_local_scribe(connection_handle hdl);
+
+  /**
+   * Accepts connections on the Unix domain socket at `path`. The
+   * socket file is removed once the doorman gets closed.
+   */
+  accept_handle add_local_doorman(const std::string& path);
+
+  void assign_local_doorman(accept_handle hdl);
+
+  inline void add_datagram_servant(const datagram_servant_pointer& ptr) {
+    m_datagram_servants.insert(std::make_pair(ptr->hdl(), ptr));
+    if (is_initialized()) {
+      ptr->launch();
+    }
+  }
+
+  std::pair<datagram_handle, uint16_t>
+  add_udp_datagram_servant(uint16_t port = 0, const char* in = nullptr,
+                           bool reuse_addr = false);
+
+  void assign_udp_datagram_servant(datagram_handle hdl);
+
+  datagram_handle add_udp_datagram_servant(network::native_socket fd);
+
   void invoke_message(mailbox_element_ptr& msg);
 
   void invoke_message(const actor_addr& sender, message_id mid, message& msg);
@@ -282,7 +468,7 @@ class broker : public abstract_event_based_actor<behavior, false> {
   void enqueue(mailbox_element_ptr, execution_unit*) override;
 
   /**
-   * Closes all connections and acceptors.
+   * Closes all connections, acceptors, and datagram servants.
    */
   void close_all();
 
@@ -297,6 +483,11 @@ class broker : public abstract_event_based_actor<behavior, false> {
    */
   void close(accept_handle handle);
 
+  /**
+   * Closes the datagram servant identified by `handle`.
+   */
+  void close(datagram_handle handle);
+
   /**
    * Checks whether a connection for `handle` exists.
    */
@@ -307,6 +498,11 @@ class broker : public abstract_event_based_actor<behavior, false> {
    */
   bool valid(accept_handle handle);
 
+  /**
+   * Checks whether a datagram servant for `handle` exists.
+   */
+  bool valid(datagram_handle handle);
+
   class functor_based;
 
   void launch(execution_unit* eu, bool lazy, bool hide);
@@ -367,6 +563,11 @@ class broker : public abstract_event_based_actor<behavior, false> {
   // throws on error
   inline doorman& by_id(accept_handle hdl) { return by_id(hdl, m_doormen); }
 
+  // throws on error
+  inline datagram_servant& by_id(datagram_handle hdl) {
+    return by_id(hdl, m_datagram_servants);
+  }
+
   bool invoke_message_from_cache();
 
   void erase_io(int id);
@@ -375,6 +576,7 @@ class broker : public abstract_event_based_actor<behavior, false> {
 
   std::map<accept_handle, doorman_pointer> m_doormen;
   std::map<connection_handle, scribe_pointer> m_scribes;
+  std::map<datagram_handle, datagram_servant_pointer> m_datagram_servants;
 
   middleman& m_mm;
   detail::intrusive_partitioned_list<mailbox_element, detail::disposer> m_cache;
@@ -21,6 +21,8 @@
 #define CAF_IO_MIDDLEMAN_HPP
 
 #include <map>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -95,6 +97,63 @@ class middleman : public detail::abstract_singleton {
     return *m_backend;
   }
 
+  /**
+   * Sets the maximum time `remote_actor` waits for a TCP connection
+   * to the remote node. The default is 30 seconds.
+   * @note This member function is thread-safe.
+   */
+  inline void connect_timeout(std::chrono::milliseconds x) {
+    m_connect_timeout = x.count();
+  }
+
+  /**
+   * Returns the maximum time `remote_actor` waits for a TCP connection.
+   */
+  inline std::chrono::milliseconds connect_timeout() const {
+    return std::chrono::milliseconds{m_connect_timeout.load()};
+  }
+
+  /**
+   * Sets how many listening sockets `publish` opens per port. Values
+   * greater than 1 bind the sockets via `SO_REUSEPORT`, which allows
+   * the kernel to spread incoming connections across all sockets and
+   * gives each published port a larger total accept backlog.
+   * The default is 1.
+   * @note This member function is thread-safe.
+   */
+  inline void acceptors_per_port(size_t x) {
+    m_acceptors_per_port = x > 0 ? x : 1;
+  }
+
+  /**
+   * Returns how many listening sockets `publish` opens per port.
+   */
+  inline size_t acceptors_per_port() const {
+    return m_acceptors_per_port.load();
+  }
+
+  /**
+   * Sets the write watermarks for connections to other nodes established
+   * from now on. Once more than `high` bytes are waiting to be sent to a
+   * node, this node stops reading from connections that forward messages
+   * to it until the number of unsent bytes drops to `low` or below.
+   * Likewise, local actors sending to actors on this node block until
+   * the number of unsent bytes drops to `low` or below.
+   * A high watermark of 0, the default, disables the limit.
+   * @note This member function is thread-safe.
+   */
+  inline void write_watermarks(size_t low, size_t high) {
+    m_write_low_watermark = low;
+    m_write_high_watermark = high;
+  }
+
+  /**
+   * Returns the low and high write watermarks for connections to other nodes.
+   */
+  inline std::pair<size_t, size_t> write_watermarks() const {
+    return {m_write_low_watermark.load(), m_write_high_watermark.load()};
+  }
+
   /**
    * Invokes the callback(s) associated with given event.
    */
@@ -148,6 +207,12 @@ class middleman : public detail::abstract_singleton {
   hook_uptr m_hooks;
   // actor offering asyncronous IO by managing this singleton instance
   middleman_actor m_manager;
+  // timeout for establishing connections in milliseconds
+  std::atomic<std::chrono::milliseconds::rep> m_connect_timeout;
+  // number of SO_REUSEPORT listening sockets per published port
+  std::atomic<size_t> m_acceptors_per_port;
+  std::atomic<size_t> m_write_low_watermark;
+  std::atomic<size_t> m_write_high_watermark;
 };
 
 } // namespace io
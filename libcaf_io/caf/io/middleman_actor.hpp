@@ -35,6 +35,10 @@ namespace io {
  *   either (ok_atom, uint16_t port)
  *   or     (error_atom, string error_string);
  *
+ * using put_local_result =
+ *   either (ok_atom)
+ *   or     (error_atom, string error_string);
+ *
  * using get_result =
  *   either (ok_atom, actor_addr remote_address)
  *   or     (error_atom, string error_string);
@@ -56,12 +60,18 @@ namespace io {
  *   (put_atom, actor_addr whom, uint16_t port)
  *   -> put_result;
  *
+ *   (put_atom, actor_addr whom, string path)
+ *   -> put_local_result;
+ *
  *   (get_atom, string hostname, uint16_t port)
  *   -> get_result;
  *
  *   (get_atom, string hostname, uint16_t port, set<string> expected_ifs)
  *   -> get_result;
  *
+ *   (get_atom, string path, set<string> expected_ifs)
+ *   -> get_result;
+ *
  *   (delete_atom, actor_addr whom)
  *   -> delete_result;
  *
@@ -81,7 +91,17 @@ namespace io {
  *   actor_addr | whom       | Actor that should be published at given port.
  *   uint16_t   | port       | Unused TCP port or 0 for any.
  *   string     | addr       | Optional; IP address to listen to or `INADDR_ANY`
- *   bool       | reuse_addr | Optional; enable SO_REUSEPORT option
+ *   bool       | reuse_addr | Optional; enable SO_REUSEADDR option
+ *
+ * - `PUT` with a `path` instead of a port establishes a mapping for the Unix
+ *   domain socket at `path`. A stale socket file left by a terminated process
+ *   is replaced. Access is controlled by the file system permissions of the
+ *   socket file and its directory.
+ *   Type       | Name       | Parameter Description
+ *   -----------|------------|--------------------------------------------------
+ *   put_atom   |            | Identifies `PUT` operations.
+ *   actor_addr | whom       | Actor that should be published at given path.
+ *   string     | path       | Path of the socket file.
  *
  * - `GET` queries a remote node and returns an `actor_addr` to the remote actor
  *   on success. This handle must be cast to either `actor` or `typed_actor`
@@ -93,8 +113,15 @@ namespace io {
  *   uint16_t    | port        | TCP port.
  *   set<string> | expected_ifs | Optional; Interface of typed remote actor.
  *
- * - `DELETE` removes either all `port <-> actor` mappings for an actor or only
- *   a single one if the optional `port` parameter is set.
+ * - `GET` with a `path` connects to an actor published at a Unix domain socket.
+ *   Type        | Name        | Parameter Description
+ *   ------------|-------------|------------------------------------------------
+ *   get_atom    |             | Identifies `GET` operations.
+ *   string      | path        | Path of the socket file.
+ *   set<string> | expected_ifs | Interface of typed remote actor or empty.
+ *
+ * - `DELETE` removes either all `port <-> actor` and `path <-> actor` mappings
+ *   for an actor or only a single one if the optional `port` parameter is set.
  *   Type        | Name        | Parameter Description
  *   ------------|-------------|------------------------------------------------
  *   delete_atom |             | Identifies `DELETE` operations.
@@ -115,12 +142,18 @@ using middleman_actor =
     replies_to<put_atom, actor_addr, uint16_t>
     ::with_either<ok_atom, uint16_t>
     ::or_else<error_atom, std::string>,
+    replies_to<put_atom, actor_addr, std::string>
+    ::with_either<ok_atom>
+    ::or_else<error_atom, std::string>,
     replies_to<get_atom, std::string, uint16_t>
     ::with_either<ok_atom, actor_addr>
     ::or_else<error_atom, std::string>,
     replies_to<get_atom, std::string, uint16_t, std::set<std::string>>
     ::with_either<ok_atom, actor_addr>
     ::or_else<error_atom, std::string>,
+    replies_to<get_atom, std::string, std::set<std::string>>
+    ::with_either<ok_atom, actor_addr>
+    ::or_else<error_atom, std::string>,
     replies_to<delete_atom, actor_addr>
     ::with_either<ok_atom>
     ::or_else<error_atom, std::string>,
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_NETWORK_BUFFER_POOL_HPP
+#define CAF_IO_NETWORK_BUFFER_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace caf {
+namespace io {
+namespace network {
+
+/**
+ * A size-classed cache for the read and write buffers of streams. Streams
+ * borrow buffers only while they have data in flight and return them once
+ * the connection becomes idle. Buffers are grouped by capacity into classes
+ * of powers of two. Requests fall back to cached buffers of at most
+ * `max_fallback_classes` larger classes, i.e., small requests never pin
+ * large buffers. The pool drops returned buffers that exceed the largest
+ * class or that would raise the cached memory above `max_cached_bytes()`.
+ * @warning `take` and `release` must be called from the IO multiplexer's
+ *          event loop only.
+ */
+class buffer_pool {
+ public:
+  using buffer_type = std::vector<char>;
+
+  /**
+   * Capacity of the smallest size class.
+   */
+  static constexpr size_t min_capacity = 256;
+
+  /**
+   * Capacity of the largest size class.
+   */
+  static constexpr size_t max_capacity = 1024 * 1024;
+
+  /**
+   * Number of larger size classes a request may take buffers from.
+   */
+  static constexpr size_t max_fallback_classes = 2;
+
+  /**
+   * Default upper bound for the memory held by cached buffers.
+   */
+  static constexpr size_t default_max_cached_bytes = 16 * 1024 * 1024;
+
+  buffer_pool();
+
+  buffer_pool(const buffer_pool&) = delete;
+  buffer_pool& operator=(const buffer_pool&) = delete;
+
+  /**
+   * Returns an empty buffer with a capacity of at least `size` bytes.
+   */
+  buffer_type take(size_t size);
+
+  /**
+   * Returns a buffer with a size of at least `size` bytes that equals its
+   * capacity. The content of the buffer is unspecified, i.e., buffers
+   * returned by readers can be used again without zero-filling them.
+   */
+  buffer_type take_initialized(size_t size);
+
+  /**
+   * Returns `buf` to the pool, leaving it empty without allocated memory.
+   */
+  void release(buffer_type& buf);
+
+  /**
+   * Returns the memory currently held by cached buffers.
+   */
+  inline size_t cached_bytes() const {
+    return m_cached_bytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the maximum of `cached_bytes()` ever observed.
+   */
+  inline size_t high_water_mark() const {
+    return m_high_water_mark.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the upper bound for the memory held by cached buffers.
+   */
+  inline size_t max_cached_bytes() const {
+    return m_max_cached_bytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Sets the upper bound for the memory held by cached buffers. Setting
+   * the bound to 0 disables caching. The new bound applies to buffers
+   * returned from now on, i.e., does not shrink the cache immediately.
+   */
+  inline void max_cached_bytes(size_t value) {
+    m_max_cached_bytes = value;
+  }
+
+ private:
+  // 256 B, 512 B, ..., 1 MB
+  static constexpr size_t num_classes = 13;
+
+  // returns a buffer with a capacity of at least `size` bytes
+  buffer_type take_impl(size_t size);
+
+  std::array<std::vector<buffer_type>, num_classes> m_classes;
+  std::atomic<size_t> m_cached_bytes;
+  std::atomic<size_t> m_high_water_mark;
+  std::atomic<size_t> m_max_cached_bytes;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_BUFFER_POOL_HPP
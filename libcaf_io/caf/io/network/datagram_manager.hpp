@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_NETWORK_DATAGRAM_MANAGER_HPP
+#define CAF_IO_NETWORK_DATAGRAM_MANAGER_HPP
+
+#include <vector>
+
+#include "caf/io/endpoint_handle.hpp"
+
+#include "caf/io/network/manager.hpp"
+
+namespace caf {
+namespace io {
+namespace network {
+
+/**
+ * A datagram manager configures an IO device for sending and
+ * receiving datagrams and processes the received datagrams.
+ */
+class datagram_manager : public manager {
+ public:
+  ~datagram_manager();
+
+  /**
+   * Called by the underlying IO device whenever it received a datagram
+   * from `ep`. The manager can take ownership of `buf` by swapping it
+   * with an empty buffer.
+   */
+  virtual void consume(endpoint_handle ep, std::vector<char>& buf) = 0;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_DATAGRAM_MANAGER_HPP
@@ -20,11 +20,19 @@
 #ifndef CAF_IO_NETWORK_DEFAULT_MULTIPLEXER_HPP
 #define CAF_IO_NETWORK_DEFAULT_MULTIPLEXER_HPP
 
+#include <mutex>
 #include <thread>
+#include <condition_variable>
 
+#include <map>
+#include <list>
+#include <deque>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <functional>
+#include <unordered_map>
 
 #include "caf/config.hpp"
 #include "caf/extend.hpp"
@@ -34,13 +42,18 @@
 #include "caf/io/fwd.hpp"
 #include "caf/io/accept_handle.hpp"
 #include "caf/io/receive_policy.hpp"
+#include "caf/io/datagram_handle.hpp"
+#include "caf/io/endpoint_handle.hpp"
 #include "caf/io/connection_handle.hpp"
 #include "caf/io/network/operation.hpp"
 #include "caf/io/network/multiplexer.hpp"
 #include "caf/io/network/stream_manager.hpp"
 #include "caf/io/network/acceptor_manager.hpp"
+#include "caf/io/network/datagram_manager.hpp"
 
+#include "caf/io/network/buffer_pool.hpp"
 #include "caf/io/network/native_socket.hpp"
+#include "caf/io/network/io_uring_poller.hpp"
 
 #include "caf/detail/logging.hpp"
 
@@ -240,9 +253,30 @@ class event_handler {
     m_eventbf = value;
   }
 
+  /**
+   * Returns the bit field storing the operations the socket is ready for.
+   * Only maintained if the multiplexer uses edge-triggered notifications.
+   */
+  inline int readiness() const {
+    return m_readiness;
+  }
+
+  /**
+   * Signalizes that performing `op` on the socket would block. Handlers
+   * must call this member function whenever reading, writing, or accepting
+   * fails with `EAGAIN`, because an edge-triggered multiplexer keeps
+   * dispatching events until the socket is no longer ready.
+   */
+  void would_block(operation op);
+
  protected:
   default_multiplexer& m_backend;
   int m_eventbf;
+
+ private:
+  friend class default_multiplexer;
+  int m_readiness;
+  bool m_scheduled;
 };
 
 /**
@@ -275,6 +309,10 @@ class default_socket {
     return m_parent;
   }
 
+ protected:
+  default_socket(default_multiplexer& parent, native_socket sock,
+                 bool tcp_socket);
+
  private:
   default_multiplexer& m_parent;
   native_socket m_fd;
@@ -285,6 +323,45 @@ class default_socket {
  */
 using default_socket_acceptor = default_socket;
 
+/**
+ * Low-level socket type for Unix domain sockets. Other than
+ * `default_socket`, it does not configure TCP-specific options.
+ */
+class local_socket : public default_socket {
+ public:
+  using socket_type = local_socket;
+
+  local_socket(default_multiplexer& parent,
+               native_socket sock = invalid_native_socket);
+};
+
+/**
+ * Identifies the socket file of a Unix domain socket by device and inode.
+ */
+struct local_socket_file {
+  uint64_t dev;
+  uint64_t ino;
+};
+
+/**
+ * Low-level socket type for accepting Unix domain socket connections.
+ * Remembers the socket file created by `bind` in order to remove only
+ * this file, not a file another process created at the same path.
+ */
+class local_socket_acceptor : public local_socket {
+ public:
+  local_socket_acceptor(default_multiplexer& parent,
+                        native_socket sock = invalid_native_socket,
+                        local_socket_file file = local_socket_file{0, 0});
+
+  inline const local_socket_file& file() const {
+    return m_file;
+  }
+
+ private:
+  local_socket_file m_file;
+};
+
 class default_multiplexer : public multiplexer {
  public:
   friend class io::middleman; // disambiguate reference
@@ -310,6 +387,10 @@ class default_multiplexer : public multiplexer {
 
   connection_handle new_tcp_scribe(const std::string&, uint16_t) override;
 
+  void new_tcp_scribe(const std::string& host, uint16_t port,
+                      std::chrono::milliseconds timeout,
+                      connect_handler f) override;
+
   void assign_tcp_scribe(broker* ptr, connection_handle hdl) override;
 
   connection_handle add_tcp_scribe(broker*, default_socket_acceptor&& sock);
@@ -320,7 +401,8 @@ class default_multiplexer : public multiplexer {
                                     uint16_t port) override;
 
   std::pair<accept_handle, uint16_t>
-  new_tcp_doorman(uint16_t p, const char* in, bool rflag) override;
+  new_tcp_doorman(uint16_t p, const char* in, bool rflag,
+                  port_sharing sharing) override;
 
   void assign_tcp_doorman(broker* ptr, accept_handle hdl) override;
 
@@ -331,6 +413,37 @@ class default_multiplexer : public multiplexer {
   std::pair<accept_handle, uint16_t>
   add_tcp_doorman(broker*, uint16_t p, const char* in, bool rflag) override;
 
+  connection_handle new_local_scribe(const std::string& path) override;
+
+  void new_local_scribe(const std::string& path,
+                        std::chrono::milliseconds timeout,
+                        connect_handler f) override;
+
+  void assign_local_scribe(broker* ptr, connection_handle hdl) override;
+
+  connection_handle add_local_scribe(broker*, local_socket&& sock);
+
+  connection_handle add_local_scribe(broker*, const std::string& path) override;
+
+  accept_handle new_local_doorman(const std::string& path) override;
+
+  void assign_local_doorman(broker* ptr, accept_handle hdl) override;
+
+  accept_handle add_local_doorman(broker*, local_socket_acceptor&& sock);
+
+  accept_handle add_local_doorman(broker*, const std::string& path) override;
+
+  std::pair<datagram_handle, uint16_t>
+  new_udp_datagram_servant(uint16_t p, const char* in, bool rflag) override;
+
+  void assign_udp_datagram_servant(broker* ptr, datagram_handle hdl) override;
+
+  datagram_handle add_udp_datagram_servant(broker*, native_socket fd) override;
+
+  std::pair<datagram_handle, uint16_t>
+  add_udp_datagram_servant(broker*, uint16_t p, const char* in,
+                           bool rflag) override;
+
   void dispatch_runnable(runnable_ptr ptr) override;
 
   default_multiplexer();
@@ -341,11 +454,63 @@ class default_multiplexer : public multiplexer {
 
   void run() override;
 
+  /**
+   * Returns whether this multiplexer uses io_uring instead of epoll. Setting
+   * the environment variable `CAF_MULTIPLEXER` to `io_uring` enables io_uring
+   * if supported by the system.
+   */
+  inline bool uses_io_uring() const {
+    return m_uring != nullptr;
+  }
+
+  /**
+   * Returns whether this multiplexer registers sockets for reading and
+   * writing permanently using edge-triggered epoll notifications instead
+   * of modifying the registration whenever a handler starts or stops
+   * writing. Setting the environment variable `CAF_MULTIPLEXER` to
+   * `epoll_et` enables this mode.
+   */
+  inline bool edge_triggered() const {
+    return m_edge_triggered;
+  }
+
+  /**
+   * Returns the pool providing read and write buffers to all streams.
+   */
+  inline buffer_pool& buffers() {
+    return m_buffers;
+  }
+
   void add(operation op, native_socket fd, event_handler* ptr);
 
   void del(operation op, native_socket fd, event_handler* ptr);
 
+  using timer_clock = std::chrono::steady_clock;
+
+  using timer_map = std::multimap<timer_clock::time_point,
+                                  std::function<void ()>>;
+
+  /**
+   * Invokes `f` from the event loop once `tp` has passed. All pending
+   * timers fire early when the multiplexer shuts down.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  timer_map::iterator add_timer(timer_clock::time_point tp,
+                                std::function<void ()> f);
+
+  /**
+   * Removes a pending timer without invoking it.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  void cancel_timer(timer_map::iterator i);
+
  private:
+  // returns the timeout for the next poll() or epoll_wait() call in ms
+  int next_timeout() const;
+
+  // invokes all timers expiring at or before `now`
+  void fire_timers(timer_clock::time_point now);
+
   // platform-dependent additional initialization code
   void init();
 
@@ -392,6 +557,16 @@ class default_multiplexer : public multiplexer {
 
   void handle(const event& event);
 
+  // adds `ptr` to the handlers dispatched in the next loop iteration
+  void schedule(event_handler* ptr);
+
+  // removes `ptr` from the handlers dispatched in the next loop iteration
+  void unschedule(event_handler* ptr);
+
+  // dispatches events to all handlers that are ready for an operation
+  // they are subscribed to (edge-triggered mode only)
+  void dispatch_ready();
+
   bool socket_had_rd_shutdown_event(native_socket fd);
 
   void handle_socket_event(native_socket fd, int mask, event_handler* ptr);
@@ -402,11 +577,31 @@ class default_multiplexer : public multiplexer {
 
   runnable* rd_dispatch_request();
 
+  // runs `f` in the resolver thread, starting the thread if needed
+  void run_resolver_job(std::function<void ()> f);
+
   native_socket m_epollfd; // unused in poll() implementation
+  std::unique_ptr<io_uring_poller> m_uring; // replaces m_epollfd if set
+  bool m_edge_triggered; // unused in poll() implementation
   std::vector<multiplexer_data> m_pollset;
   std::vector<event> m_events; // always sorted by .fd
+  timer_map m_timers;
   multiplexer_poll_shadow_data m_shadow;
   std::pair<native_socket, native_socket> m_pipe;
+  std::vector<event_handler*> m_ready; // edge-triggered mode only
+  std::vector<event_handler*> m_dispatching; // swapped with m_ready
+  buffer_pool m_buffers;
+  // socket files of local doormen created by `new_local_doorman`,
+  // kept until `assign_local_doorman` picks them up
+  std::mutex m_local_files_mtx;
+  std::map<native_socket, local_socket_file> m_local_files;
+  // resolves host names for `new_tcp_scribe` one at a time, because
+  // getaddrinfo() may block for several seconds
+  std::thread m_resolver;
+  std::mutex m_resolver_mtx;
+  std::condition_variable m_resolver_cv;
+  std::deque<std::function<void ()>> m_resolver_jobs;
+  bool m_resolver_done;
 };
 
 default_multiplexer& get_multiplexer_singleton();
@@ -445,7 +640,12 @@ class stream : public event_handler {
   stream(default_multiplexer& backend_ref)
       : event_handler(backend_ref),
         m_sock(backend_ref),
-        m_writing(false) {
+        m_rd_paused(false),
+        m_writing(false),
+        m_written(0),
+        m_wr_low(0),
+        m_wr_high(0),
+        m_congested(false) {
     configure_read(receive_policy::at_most(1024));
   }
 
@@ -475,7 +675,18 @@ class stream : public event_handler {
 
   void removed_from_loop(operation op) override {
     switch (op) {
-      case operation::read:  m_reader.reset(); break;
+      case operation::read:
+        if (m_rd_paused) {
+          // keep the reader and any partially received data
+          if (m_collected == 0) {
+            backend().buffers().release(m_rd_buf);
+          }
+          break;
+        }
+        // releasing the reader might destroy this stream
+        backend().buffers().release(m_rd_buf);
+        m_reader.reset();
+        break;
       case operation::write: m_writer.reset(); break;
       case operation::propagate_error: break;
     }
@@ -491,6 +702,16 @@ class stream : public event_handler {
     m_max = config.second;
   }
 
+  /**
+   * Configures when to signalize backpressure to the writer: once more than
+   * `high` bytes are waiting to be sent and once the unsent data dropped
+   * to `low` bytes or less. A high watermark of 0 disables backpressure.
+   */
+  void write_watermarks(size_t low, size_t high) {
+    m_wr_low = low;
+    m_wr_high = high;
+  }
+
   /**
    * Copies data to the write buffer.
    * @warning Not thread safe.
@@ -499,15 +720,21 @@ class stream : public event_handler {
     CAF_LOG_TRACE("num_bytes: " << num_bytes);
     auto first = reinterpret_cast<const char*>(buf);
     auto last  = first + num_bytes;
+    if (m_wr_offline_buf.capacity() == 0) {
+      m_wr_offline_buf = backend().buffers().take(num_bytes);
+    }
     m_wr_offline_buf.insert(m_wr_offline_buf.end(), first, last);
   }
 
   /**
-   * Returns the write buffer of this stream.
-   * @warning Must not be modified outside the IO multiplexers event loop
-   *          once the stream has been started.
+   * Returns the write buffer of this stream, borrowing
+   * a buffer from the multiplexer if necessary.
+   * @warning Must not be called outside the IO multiplexers event loop.
    */
   buffer_type& wr_buf() {
+    if (m_wr_offline_buf.capacity() == 0) {
+      m_wr_offline_buf = backend().buffers().take(0);
+    }
     return m_wr_offline_buf;
   }
 
@@ -532,47 +759,90 @@ class stream : public event_handler {
       m_writing = true;
       write_loop();
     }
+    check_watermarks(mgr.get());
+  }
+
+  /**
+   * Stops reading from the socket without closing it if `paused` is
+   * `true` and resumes reading otherwise.
+   * @warning Must not be called outside the IO multiplexers event loop.
+   */
+  void pause_reading(bool paused) {
+    CAF_LOG_TRACE(CAF_ARG(paused));
+    if (!m_reader || m_rd_paused == paused) {
+      return;
+    }
+    m_rd_paused = paused;
+    if (paused) {
+      backend().del(operation::read, m_sock.fd(), this);
+    } else {
+      backend().add(operation::read, m_sock.fd(), this);
+    }
   }
 
   void stop_reading() {
     CAF_LOG_TRACE("");
+    // a paused stream that already left the event loop
+    // gets no further notification from the multiplexer
+    auto detached = m_rd_paused && (eventbf() & input_mask) == 0;
+    m_rd_paused = false;
     m_sock.close_read();
     backend().del(operation::read, m_sock.fd(), this);
+    if (detached) {
+      removed_from_loop(operation::read);
+    }
   }
 
   void handle_event(operation op) override {
     CAF_LOG_TRACE("op = " << static_cast<int>(op));
     switch (op) {
       case operation::read: {
+        if (m_collected == 0) {
+          prepare_read_buffer();
+        }
         size_t rb; // read bytes
-        if (!read_some(rb, m_sock.fd(),
-                 m_rd_buf.data() + m_collected,
-                 m_rd_buf.size() - m_collected)) {
+        auto len = m_rd_size - m_collected;
+        if (!read_some(rb, m_sock.fd(), m_rd_buf.data() + m_collected, len)) {
           m_reader->io_failure(operation::read);
           backend().del(operation::read, m_sock.fd(), this);
-        } else if (rb > 0) {
+          break;
+        }
+        if (rb < len) {
+          // a short read drained the socket
+          would_block(operation::read);
+        }
+        if (rb > 0) {
           m_collected += rb;
           if (m_collected >= m_threshold) {
             m_reader->consume(m_rd_buf.data(), m_collected);
             read_loop();
           }
         }
+        if (m_collected == 0 && rb < len) {
+          // don't hold on to a buffer while the connection is idle
+          backend().buffers().release(m_rd_buf);
+        }
         break;
       }
       case operation::write: {
         size_t wb; // written bytes
-        if (!write_some(wb, m_sock.fd(),
-                m_wr_buf.data() + m_written,
-                m_wr_buf.size() - m_written)) {
+        auto len = m_wr_buf.size() - m_written;
+        if (!write_some(wb, m_sock.fd(), m_wr_buf.data() + m_written, len)) {
           m_writer->io_failure(operation::write);
           backend().del(operation::write, m_sock.fd(), this);
+          break;
+        }
+        if (wb < len) {
+          // a short write filled the send buffer
+          would_block(operation::write);
         }
-        else if (wb > 0) {
+        if (wb > 0) {
           m_written += wb;
           if (m_written >= m_wr_buf.size()) {
             // prepare next send (or stop sending)
             write_loop();
           }
+          check_watermarks(m_writer.get());
         }
         break;
       }
@@ -598,27 +868,49 @@ class stream : public event_handler {
     m_collected = 0;
     switch (m_rd_flag) {
       case receive_policy_flag::exactly:
-        if (m_rd_buf.size() != m_max) {
-          m_rd_buf.resize(m_max);
-        }
+        m_rd_size = m_max;
         m_threshold = m_max;
         break;
       case receive_policy_flag::at_most:
-        if (m_rd_buf.size() != m_max) {
-          m_rd_buf.resize(m_max);
-        }
+        m_rd_size = m_max;
         m_threshold = 1;
         break;
-      case receive_policy_flag::at_least: {
+      case receive_policy_flag::at_least:
         // read up to 10% more, but at least allow 100 bytes more
-        auto max_size =   m_max
-                + std::max<size_t>(100, m_max / 10);
-        if (m_rd_buf.size() != max_size) {
-          m_rd_buf.resize(max_size);
-        }
+        m_rd_size = m_max + std::max<size_t>(100, m_max / 10);
         m_threshold = m_max;
         break;
-      }
+    }
+  }
+
+  // signalizes crossing a watermark to `mgr`
+  void check_watermarks(stream_manager* mgr) {
+    if (m_wr_high == 0) {
+      return;
+    }
+    auto unsent = m_wr_buf.size() - m_written + m_wr_offline_buf.size();
+    if (!m_congested && unsent > m_wr_high) {
+      m_congested = true;
+      mgr->backpressure(true);
+    } else if (m_congested && unsent <= m_wr_low) {
+      m_congested = false;
+      mgr->backpressure(false);
+    }
+  }
+
+  // borrows a read buffer large enough for the current receive policy,
+  // reading only the first m_rd_size bytes of a possibly larger buffer
+  void prepare_read_buffer() {
+    if (m_rd_buf.size() >= m_rd_size) {
+      return;
+    }
+    if (m_rd_buf.capacity() >= m_rd_size) {
+      // the reader shrank the buffer to the size of the last chunk
+      m_rd_buf.resize(m_rd_size);
+    } else {
+      auto& pool = backend().buffers();
+      pool.release(m_rd_buf);
+      m_rd_buf = pool.take_initialized(m_rd_size);
     }
   }
 
@@ -630,6 +922,9 @@ class stream : public event_handler {
     if (m_wr_offline_buf.empty()) {
       m_writing = false;
       backend().del(operation::write, m_sock.fd(), this);
+      // don't hold on to buffers while the connection is idle
+      backend().buffers().release(m_wr_buf);
+      backend().buffers().release(m_wr_offline_buf);
     } else {
       m_wr_buf.swap(m_wr_offline_buf);
     }
@@ -642,14 +937,19 @@ class stream : public event_handler {
   size_t m_threshold;
   size_t m_collected;
   size_t m_max;
+  size_t m_rd_size;
   receive_policy_flag m_rd_flag;
   buffer_type m_rd_buf;
+  bool m_rd_paused;
   // writing
   manager_ptr m_writer;
   bool m_writing;
   size_t m_written;
   buffer_type m_wr_buf;
   buffer_type m_wr_offline_buf;
+  size_t m_wr_low;
+  size_t m_wr_high;
+  bool m_congested;
 };
 
 /**
@@ -670,8 +970,16 @@ class acceptor : public event_handler {
    */
   using manager_ptr = intrusive_ptr<manager_type>;
 
+  /**
+   * Maximum number of connections accepted per readiness event. Draining
+   * the accept queue saves a poll roundtrip per connection during
+   * connection storms, while the limit keeps other sockets responsive.
+   */
+  static constexpr size_t max_accepts_per_event = 64;
+
   acceptor(default_multiplexer& backend_ref)
       : event_handler(backend_ref),
+        m_reading(false),
         m_accept_sock(backend_ref),
         m_sock(backend_ref) {
     // nop
@@ -709,6 +1017,7 @@ class acceptor : public event_handler {
     CAF_LOG_TRACE("m_accept_sock.fd = " << m_accept_sock.fd());
     CAF_REQUIRE(mgr != nullptr);
     m_mgr = mgr;
+    m_reading = true;
     backend().add(operation::read, m_accept_sock.fd(), this);
   }
 
@@ -718,6 +1027,7 @@ class acceptor : public event_handler {
   void stop_reading() {
     CAF_LOG_TRACE("m_accept_sock.fd = " << m_accept_sock.fd()
              << ", m_mgr = " << m_mgr.get());
+    m_reading = false;
     backend().del(operation::read, m_accept_sock.fd(), this);
     m_accept_sock.close_read();
   }
@@ -725,14 +1035,21 @@ class acceptor : public event_handler {
   void handle_event(operation op) override {
     CAF_LOG_TRACE("m_accept_sock.fd = " << m_accept_sock.fd()
              << ", op = " << static_cast<int>(op));
-    if (m_mgr && op == operation::read) {
+    if (!m_mgr || op != operation::read) {
+      return;
+    }
+    // the manager might stop reading from within `new_connection`
+    for (size_t i = 0; i < max_accepts_per_event && m_reading; ++i) {
       native_socket sockfd = invalid_native_socket;
-      if (try_accept(sockfd, m_accept_sock.fd())) {
-        if (sockfd != invalid_native_socket) {
-          m_sock = socket_type{backend(), sockfd};
-          m_mgr->new_connection();
-        }
+      if (!try_accept(sockfd, m_accept_sock.fd())) {
+        return;
+      }
+      if (sockfd == invalid_native_socket) {
+        would_block(operation::read);
+        return;
       }
+      m_sock = socket_type{backend(), sockfd};
+      m_mgr->new_connection();
     }
   }
 
@@ -750,22 +1067,230 @@ class acceptor : public event_handler {
 
  private:
   manager_ptr m_mgr;
+  bool m_reading;
   SocketAcceptor m_accept_sock;
   socket_type m_sock;
 };
 
+template <class SocketAcceptor>
+constexpr size_t acceptor<SocketAcceptor>::max_accepts_per_event;
+
+/**
+ * A datagram socket for sending and receiving datagrams to and from any
+ * number of remote endpoints. Received datagrams are forwarded to its
+ * {@link datagram_manager manager}. On Linux, the socket receives and sends
+ * up to `max_batch_size` datagrams per system call using `recvmmsg` and
+ * `sendmmsg`.
+ */
+class datagram_handler : public event_handler {
+ public:
+  /**
+   * A smart pointer to a datagram manager.
+   */
+  using manager_ptr = intrusive_ptr<datagram_manager>;
+
+  /**
+   * A buffer class providing a compatible
+   * interface to `std::vector`.
+   */
+  using buffer_type = std::vector<char>;
+
+  /**
+   * Maximum number of datagrams per system call.
+   */
+  static constexpr size_t max_batch_size = 32;
+
+  /**
+   * Maximum number of receive batches per readiness event. The limit
+   * keeps other sockets responsive while a sender floods this socket.
+   */
+  static constexpr size_t max_batches_per_event = 8;
+
+  /**
+   * Default for the maximum size of received datagrams.
+   */
+  static constexpr size_t default_max_datagram_size = 2048;
+
+  /**
+   * Default for the maximum number of endpoints learned from received
+   * datagrams, see {@link max_endpoints}.
+   */
+  static constexpr size_t default_max_endpoints = 4096;
+
+  /**
+   * Takes ownership of `sockfd` and configures it as nonblocking socket.
+   */
+  datagram_handler(default_multiplexer& backend_ref, native_socket sockfd);
+
+  ~datagram_handler();
+
+  /**
+   * Starts reading datagrams from the socket, forwarding them to `mgr`.
+   */
+  void start(const manager_ptr& mgr);
+
+  /**
+   * Configures the maximum size of received datagrams.
+   */
+  void max_datagram_size(size_t num_bytes);
+
+  /**
+   * Configures how many endpoints learned from received datagrams this
+   * socket keeps at most. Exceeding the limit evicts the least recently
+   * used endpoint, i.e., the endpoint that neither sent nor received a
+   * datagram for the longest time. A sender that reappears after its
+   * eviction gets a new handle.
+   */
+  void max_endpoints(size_t num_endpoints);
+
+  /**
+   * Resolves `host` and returns a handle for sending datagrams to
+   * `host` on given `port`. Unlike endpoints learned from received
+   * datagrams, the handle remains valid until released.
+   * @throws network_error
+   */
+  endpoint_handle add_endpoint(const std::string& host, uint16_t port);
+
+  /**
+   * Forgets `ep`. Datagrams already enqueued for `ep` are still sent.
+   */
+  void release_endpoint(endpoint_handle ep);
+
+  /**
+   * Enqueues a datagram for `ep`. Silently drops the datagram
+   * if `ep` has been released or evicted.
+   * @throws std::invalid_argument if `ep` is unknown
+   */
+  void write(endpoint_handle ep, const void* buf, size_t num_bytes);
+
+  /**
+   * Sends all enqueued datagrams. Datagrams the network layer refuses to
+   * send, e.g., because they exceed the maximum message size, are dropped.
+   * Keeps a reference to `mgr` until all datagrams have been sent.
+   */
+  void flush(const manager_ptr& mgr);
+
+  void stop_reading();
+
+  void handle_event(operation op) override;
+
+  void removed_from_loop(operation op) override;
+
+  native_socket fd() const override;
+
+ private:
+  struct endpoint {
+    sockaddr_storage addr;
+    socklen_t len;
+  };
+
+  struct endpoint_hash {
+    size_t operator()(const endpoint& x) const;
+  };
+
+  struct endpoint_equal {
+    bool operator()(const endpoint& x, const endpoint& y) const;
+  };
+
+  // an entry of m_endpoints, learned endpoints are
+  // stored in m_lru while pinned endpoints are not
+  struct endpoint_entry {
+    endpoint addr;
+    bool pinned;
+    std::list<int64_t>::iterator lru_pos;
+  };
+
+  // a received datagram, stored in the slot of m_rd_buf at the same index
+  struct incoming {
+    endpoint from;
+    size_t size;
+  };
+
+  // a datagram enqueued for sending, referring to a slice of m_wr_buf,
+  // stores a copy of the address to survive releasing the endpoint
+  struct outgoing {
+    endpoint to;
+    size_t offset;
+    size_t size;
+  };
+
+  // returns the handle for `x`, adding `x` to the endpoints if needed,
+  // pinned endpoints are never evicted
+  endpoint_handle endpoint_of(const endpoint& x, bool pin);
+
+  // marks `x` as most recently used
+  void touch(endpoint_entry& x);
+
+  // evicts least recently used endpoints until m_lru fits m_max_endpoints
+  void evict_endpoints();
+
+  // reads up to max_batch_size datagrams into m_rd_buf and stores
+  // the number of received datagrams in `result`, returns false on error
+  bool read_batch(size_t& result);
+
+  // sends up to max_batch_size datagrams and returns how many datagrams
+  // were sent or dropped, returns 0 if the socket would block
+  size_t write_batch();
+
+  // sends enqueued datagrams until the socket would block,
+  // returns true if all datagrams have been sent
+  bool write_loop();
+
+  native_socket m_fd;
+  int m_family;
+  // endpoints
+  int64_t m_next_endpoint;
+  size_t m_max_endpoints;
+  std::unordered_map<int64_t, endpoint_entry> m_endpoints;
+  std::unordered_map<endpoint, int64_t, endpoint_hash, endpoint_equal> m_ids;
+  std::list<int64_t> m_lru; // most recently used endpoint first
+  // reading
+  manager_ptr m_reader;
+  bool m_reading;
+  size_t m_max_size;
+  buffer_type m_rd_buf;  // one slot of m_max_size + 1 bytes per datagram
+  buffer_type m_rd_dgram; // passed to the manager
+  std::vector<incoming> m_rd_queue;
+  // writing
+  manager_ptr m_writer;
+  bool m_writing;
+  buffer_type m_wr_buf;
+  std::vector<outgoing> m_wr_queue;
+  size_t m_wr_sent;
+};
+
 native_socket new_tcp_connection_impl(const std::string&, uint16_t,
                                       optional<protocol> preferred = none);
 
 default_socket new_tcp_connection(const std::string& host, uint16_t port);
 
 std::pair<native_socket, uint16_t>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr);
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      port_sharing sharing = port_sharing::none);
 
 std::pair<default_socket_acceptor, uint16_t>
 new_tcp_acceptor(uint16_t port, const char* addr = nullptr,
                  bool reuse_addr = false);
 
+std::pair<native_socket, uint16_t>
+new_udp_socket_impl(uint16_t port, const char* addr, bool reuse_addr);
+
+/**
+ * Connects to the Unix domain socket at `path`.
+ * @throws network_error
+ */
+native_socket new_local_connection_impl(const std::string& path);
+
+/**
+ * Creates a Unix domain socket listening at `path` and returns it along
+ * with its socket file. Replaces a stale socket file at `path` left
+ * behind by a terminated process.
+ * @throws bind_failure if another socket is listening at `path`
+ * @throws network_error
+ */
+std::pair<native_socket, local_socket_file>
+new_local_acceptor_impl(const std::string& path);
+
 } // namespace network
 } // namespace io
 } // namespace caf
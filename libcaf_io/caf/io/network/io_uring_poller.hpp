@@ -0,0 +1,118 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_NETWORK_IO_URING_POLLER_HPP
+#define CAF_IO_NETWORK_IO_URING_POLLER_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "caf/io/network/native_socket.hpp"
+
+namespace caf {
+namespace io {
+namespace network {
+
+class event_handler;
+
+/**
+ * Readiness notification based on io_uring. Tracks the interest set of each
+ * socket like epoll does, but queues all interest changes as one-shot poll
+ * requests in the submission queue. A single `io_uring_enter` call per loop
+ * iteration then submits all changes, re-arms all sockets that fired in the
+ * previous iteration and waits for new events.
+ */
+class io_uring_poller {
+ public:
+  struct event {
+    native_socket fd;
+    int mask;
+    event_handler* ptr;
+  };
+
+  ~io_uring_poller();
+
+  /**
+   * Returns a new poller or `nullptr` if the system does not
+   * support io_uring or CAF has been built without support for it.
+   */
+  static std::unique_ptr<io_uring_poller> make();
+
+  /**
+   * Sets the interest set of `fd` to `mask`, whereas `mask == 0`
+   * removes `fd` from the poller.
+   */
+  void set(native_socket fd, event_handler* ptr, int mask);
+
+  /**
+   * Waits up to `timeout` milliseconds for events or
+   * indefinitely if `timeout` is negative.
+   */
+  void wait(int timeout, std::vector<event>& result);
+
+ private:
+  struct registration {
+    event_handler* ptr;
+    int mask;
+    uint32_t gen;
+    bool armed;
+  };
+
+  io_uring_poller();
+
+  bool init();
+
+  void arm(native_socket fd, registration& reg);
+
+  void disarm(native_socket fd, registration& reg);
+
+  void* next_sqe();
+
+  void submit(unsigned min_complete, int timeout);
+
+  int m_ring_fd;
+  // memory mapped ring buffers
+  void* m_ring;
+  size_t m_ring_size;
+  void* m_sqes;
+  size_t m_sqes_size;
+  // submission queue
+  unsigned* m_sq_head;
+  unsigned* m_sq_tail;
+  unsigned* m_sq_array;
+  unsigned m_sq_mask;
+  unsigned m_sq_entries;
+  unsigned m_sq_local_tail;
+  // completion queue
+  unsigned* m_cq_head;
+  unsigned* m_cq_tail;
+  unsigned m_cq_mask;
+  void* m_cqes;
+  // interest set indexed by file descriptor
+  std::vector<registration> m_regs;
+  // sockets that need to be re-armed before waiting again
+  std::vector<native_socket> m_fired;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_NETWORK_IO_URING_POLLER_HPP
@@ -20,6 +20,7 @@
 #ifndef CAF_IO_NETWORK_MULTIPLEXER_HPP
 #define CAF_IO_NETWORK_MULTIPLEXER_HPP
 
+#include <chrono>
 #include <string>
 #include <thread>
 #include <functional>
@@ -29,6 +30,7 @@
 
 #include "caf/io/fwd.hpp"
 #include "caf/io/accept_handle.hpp"
+#include "caf/io/datagram_handle.hpp"
 #include "caf/io/connection_handle.hpp"
 
 #include "caf/io/network/protocol.hpp"
@@ -48,6 +50,18 @@ namespace caf {
 namespace io {
 namespace network {
 
+/**
+ * Controls whether a TCP doorman shares its port with other doormen.
+ */
+enum class port_sharing {
+  /// Binds the port exclusively.
+  none,
+  /// Binds the port exclusively but allows siblings to join it afterwards.
+  owner,
+  /// Joins a port bound by an owner via `SO_REUSEPORT`.
+  sibling
+};
+
 /**
  * Low-level backend for IO multiplexing.
  */
@@ -63,6 +77,24 @@ class multiplexer {
   virtual connection_handle new_tcp_scribe(const std::string& host,
                                            uint16_t port) = 0;
 
+  /**
+   * Callback for asynchronous connects. Receives an unbound connection
+   * handle on success or an invalid handle plus an error message otherwise.
+   */
+  using connect_handler = std::function<void (connection_handle,
+                                              const std::string&)>;
+
+  /**
+   * Tries to connect to `host` on given `port` without blocking the caller
+   * and invokes `f` with the result. The attempt fails if no connection has
+   * been established after `timeout`. The default implementation falls
+   * back to the blocking `new_tcp_scribe` and ignores `timeout`.
+   * @threadsafe
+   */
+  virtual void new_tcp_scribe(const std::string& host, uint16_t port,
+                              std::chrono::milliseconds timeout,
+                              connect_handler f);
+
   /**
    * Assigns an unbound scribe identified by `hdl` to `ptr`.
    * @warning Do not call from outside the multiplexer's event loop.
@@ -85,12 +117,15 @@ class multiplexer {
 
   /**
    * Tries to create an unbound TCP doorman running `port`, optionally
-   * accepting only connections from IP address `in`.
+   * accepting only connections from IP address `in`. An `owner` always
+   * binds a fresh port, whereas `sibling` doormen join the port of an
+   * owner and thus must only be used for ports this process bound itself.
    * @warning Do not call from outside the multiplexer's event loop.
    */
   virtual std::pair<accept_handle, uint16_t>
   new_tcp_doorman(uint16_t port, const char* in = nullptr,
-                  bool reuse_addr = false) = 0;
+                  bool reuse_addr = false,
+                  port_sharing sharing = port_sharing::none) = 0;
 
   /**
    * Assigns an unbound doorman identified by `hdl` to `ptr`.
@@ -113,6 +148,94 @@ class multiplexer {
   add_tcp_doorman(broker* ptr, uint16_t port, const char* in = nullptr,
                   bool reuse_addr = false) = 0;
 
+  /**
+   * Tries to connect to the Unix domain socket at `path` and
+   * returns an unbound connection handle on success.
+   * @threadsafe
+   */
+  virtual connection_handle new_local_scribe(const std::string& path) = 0;
+
+  /**
+   * Tries to connect to the Unix domain socket at `path` without blocking
+   * the caller and invokes `f` with the result. The attempt fails if no
+   * connection has been established after `timeout`. The default
+   * implementation falls back to the blocking `new_local_scribe`
+   * and ignores `timeout`.
+   * @threadsafe
+   */
+  virtual void new_local_scribe(const std::string& path,
+                                std::chrono::milliseconds timeout,
+                                connect_handler f);
+
+  /**
+   * Assigns an unbound scribe for a Unix domain
+   * socket identified by `hdl` to `ptr`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual void assign_local_scribe(broker* ptr, connection_handle hdl) = 0;
+
+  /**
+   * Tries to connect to the Unix domain socket at `path` and
+   * returns a new scribe managing the connection on success.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual connection_handle add_local_scribe(broker* ptr,
+                                             const std::string& path) = 0;
+
+  /**
+   * Tries to create an unbound doorman listening
+   * at the Unix domain socket `path`.
+   * @threadsafe
+   */
+  virtual accept_handle new_local_doorman(const std::string& path) = 0;
+
+  /**
+   * Assigns an unbound doorman for a Unix domain
+   * socket identified by `hdl` to `ptr`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual void assign_local_doorman(broker* ptr, accept_handle hdl) = 0;
+
+  /**
+   * Tries to create a new doorman listening at the Unix domain socket `path`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual accept_handle add_local_doorman(broker* ptr,
+                                          const std::string& path) = 0;
+
+  /**
+   * Tries to create an unbound UDP datagram servant bound to `port`,
+   * optionally receiving only datagrams sent to IP address `in`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual std::pair<datagram_handle, uint16_t>
+  new_udp_datagram_servant(uint16_t port, const char* in = nullptr,
+                           bool reuse_addr = false) = 0;
+
+  /**
+   * Assigns an unbound datagram servant identified by `hdl` to `ptr`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual void assign_udp_datagram_servant(broker* ptr,
+                                           datagram_handle hdl) = 0;
+
+  /**
+   * Creates a new UDP datagram servant from a native socket handle.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual datagram_handle add_udp_datagram_servant(broker* ptr,
+                                                   native_socket fd) = 0;
+
+  /**
+   * Tries to create a new UDP datagram servant bound to port `p`,
+   * optionally receiving only datagrams sent to IP address `in`.
+   * @warning Do not call from outside the multiplexer's event loop.
+   */
+  virtual std::pair<datagram_handle, uint16_t>
+  add_udp_datagram_servant(broker* ptr, uint16_t port,
+                           const char* in = nullptr,
+                           bool reuse_addr = false) = 0;
+
   /**
    * Simple wrapper for runnables
    */
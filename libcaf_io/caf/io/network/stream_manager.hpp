@@ -40,6 +40,13 @@ class stream_manager : public manager {
    * Called by the underlying IO device whenever it received data.
    */
   virtual void consume(const void* data, size_t num_bytes) = 0;
+
+  /**
+   * Called by the underlying IO device whenever the amount of unsent data
+   * exceeds its high watermark (`congested == true`) or drops to its
+   * low watermark (`congested == false`). The default does nothing.
+   */
+  virtual void backpressure(bool congested);
 };
 
 } // namespace network
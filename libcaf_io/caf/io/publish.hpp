@@ -20,6 +20,7 @@
 #ifndef CAF_IO_PUBLISH_HPP
 #define CAF_IO_PUBLISH_HPP
 
+#include <string>
 #include <cstdint>
 
 #include "caf/actor.hpp"
@@ -32,6 +33,8 @@ namespace io {
 uint16_t publish_impl(abstract_actor_ptr whom, uint16_t port,
                       const char* in, bool reuse_addr);
 
+void publish_local_impl(abstract_actor_ptr whom, const std::string& path);
+
 /**
  * Publishes `whom` at `port`. The connection is managed by the middleman.
  * @param whom Actor that should be published at `port`.
@@ -63,6 +66,31 @@ uint16_t typed_publish(typed_actor<Sigs...> whom, uint16_t port,
                       reuse_addr);
 }
 
+/**
+ * Publishes `whom` at the Unix domain socket `path`, replacing a stale
+ * socket file left behind by a terminated process. The socket file is
+ * removed once `whom` gets unpublished or terminates. Access is controlled
+ * by the file system permissions of the socket file and its directory.
+ * @param whom Actor that should be published at `path`.
+ * @param path Path of the socket file.
+ * @throws network_error if `path` is in use or cannot be bound
+ */
+inline void publish(caf::actor whom, const std::string& path) {
+  if (whom) {
+    publish_local_impl(actor_cast<abstract_actor_ptr>(whom), path);
+  }
+}
+
+/**
+ * @copydoc publish(actor,const std::string&)
+ */
+template <class... Sigs>
+void typed_publish(typed_actor<Sigs...> whom, const std::string& path) {
+  if (whom) {
+    publish_local_impl(actor_cast<abstract_actor_ptr>(whom), path);
+  }
+}
+
 } // namespace io
 } // namespace caf
 
@@ -34,6 +34,9 @@ namespace io {
 abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
                                      const std::string& host, uint16_t port);
 
+abstract_actor_ptr remote_actor_impl(std::set<std::string> ifs,
+                                     const std::string& path);
+
 /**
  * Establish a new connection to the actor at `host` on given `port`.
  * @param host Valid hostname or IP address.
@@ -64,6 +67,35 @@ ActorHandle typed_remote_actor(const std::string& host, uint16_t port) {
                                                    host, port));
 }
 
+/**
+ * Establish a new connection to the actor published at the
+ * Unix domain socket `path` on this host.
+ * @param path Path of the socket file.
+ * @returns An {@link actor_ptr} to the proxy instance
+ *          representing a remote actor.
+ * @throws network_error Thrown on connection error or
+ *                       when connecting to a typed actor.
+ */
+inline actor remote_actor(const std::string& path) {
+  auto res = remote_actor_impl(std::set<std::string>{}, path);
+  return actor_cast<actor>(res);
+}
+
+/**
+ * Establish a new connection to the typed actor published
+ * at the Unix domain socket `path` on this host.
+ * @param path Path of the socket file.
+ * @returns An {@link actor_ptr} to the proxy instance
+ *          representing a typed remote actor.
+ * @throws network_error Thrown on connection error or when connecting
+ *                       to an untyped otherwise unexpected actor.
+ */
+template <class ActorHandle>
+ActorHandle typed_remote_actor(const std::string& path) {
+  auto iface = ActorHandle::message_types();
+  return actor_cast<ActorHandle>(remote_actor_impl(std::move(iface), path));
+}
+
 } // namespace io
 } // namespace caf
 
@@ -22,6 +22,8 @@
 
 #include "caf/io/handle.hpp"
 #include "caf/io/accept_handle.hpp"
+#include "caf/io/datagram_handle.hpp"
+#include "caf/io/endpoint_handle.hpp"
 #include "caf/io/connection_handle.hpp"
 
 namespace caf {
@@ -58,7 +60,11 @@ inline bool operator!=(const new_connection_msg& lhs,
 }
 
 /**
- * Signalizes newly arrived data for a {@link broker}.
+ * Signalizes newly arrived data for a {@link broker}. Handlers taking this
+ * message by value or by rvalue reference move the buffer out of the
+ * message. Handlers keeping the message, e.g., by forwarding it to another
+ * actor, share the buffer. In both cases, the data is not copied and the
+ * connection continues reading into a new buffer.
  */
 struct new_data_msg {
   /**
@@ -111,6 +117,38 @@ inline bool operator!=(const connection_closed_msg& lhs,
   return !(lhs == rhs);
 }
 
+/**
+ * Signalizes that the amount of unsent data on a {@link broker} connection
+ * crossed one of the write watermarks configured via `write_watermarks`.
+ */
+struct connection_backpressure_msg {
+  /**
+   * Handle to the related connection.
+   */
+  connection_handle handle;
+  /**
+   * Denotes whether the unsent data exceeded the high watermark (`true`)
+   * or dropped to the low watermark (`false`).
+   */
+  bool congested;
+};
+
+/**
+ * @relates connection_backpressure_msg
+ */
+inline bool operator==(const connection_backpressure_msg& lhs,
+                       const connection_backpressure_msg& rhs) {
+  return lhs.handle == rhs.handle && lhs.congested == rhs.congested;
+}
+
+/**
+ * @relates connection_backpressure_msg
+ */
+inline bool operator!=(const connection_backpressure_msg& lhs,
+                       const connection_backpressure_msg& rhs) {
+  return !(lhs == rhs);
+}
+
 /**
  * Signalizes that a {@link broker} acceptor has been closed.
  */
@@ -137,6 +175,68 @@ inline bool operator!=(const acceptor_closed_msg& lhs,
   return !(lhs == rhs);
 }
 
+/**
+ * Signalizes a newly arrived datagram for a {@link broker}. Like
+ * `new_data_msg`, the buffer can be moved out of the message.
+ */
+struct new_datagram_msg {
+  /**
+   * Handle to the related datagram servant.
+   */
+  datagram_handle handle;
+  /**
+   * Handle to the sender of the datagram.
+   */
+  endpoint_handle endpoint;
+  /**
+   * Buffer containing the received datagram.
+   */
+  std::vector<char> buf;
+};
+
+/**
+ * @relates new_datagram_msg
+ */
+inline bool operator==(const new_datagram_msg& lhs,
+                       const new_datagram_msg& rhs) {
+  return lhs.handle == rhs.handle && lhs.endpoint == rhs.endpoint
+         && lhs.buf == rhs.buf;
+}
+
+/**
+ * @relates new_datagram_msg
+ */
+inline bool operator!=(const new_datagram_msg& lhs,
+                       const new_datagram_msg& rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * Signalizes that a {@link broker} datagram servant has been closed.
+ */
+struct datagram_servant_closed_msg {
+  /**
+   * Handle to the closed datagram servant.
+   */
+  datagram_handle handle;
+};
+
+/**
+ * @relates datagram_servant_closed_msg
+ */
+inline bool operator==(const datagram_servant_closed_msg& lhs,
+                       const datagram_servant_closed_msg& rhs) {
+  return lhs.handle == rhs.handle;
+}
+
+/**
+ * @relates datagram_servant_closed_msg
+ */
+inline bool operator!=(const datagram_servant_closed_msg& lhs,
+                       const datagram_servant_closed_msg& rhs) {
+  return !(lhs == rhs);
+}
+
 } // namespace io
 } // namespace caf
 
@@ -32,7 +32,8 @@ namespace io {
 void unpublish_impl(const actor_addr& whom, uint16_t port, bool block_caller);
 
 /**
- * Unpublishes `whom` by closing `port` or all assigned ports if `port == 0`.
+ * Unpublishes `whom` by closing `port` or all assigned ports and Unix
+ * domain sockets if `port == 0`.
  * @param whom Actor that should be unpublished at `port`.
  * @param port TCP port.
  */
@@ -19,8 +19,11 @@
 
 #include "caf/io/basp_broker.hpp"
 
+#include <algorithm>
+
 #include "caf/exception.hpp"
 #include "caf/make_counted.hpp"
+#include "caf/message_tracing.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/binary_deserializer.hpp"
 #include "caf/forwarding_actor_proxy.hpp"
@@ -67,6 +70,76 @@ functor_payload_writer<F> make_payload_writer(F fun) {
   return {fun};
 }
 
+namespace {
+
+// writes the payload of server handshakes and resolve responses
+void write_published_actor(binary_serializer& sink, const actor_addr& addr) {
+  sink << addr.id();
+  auto sigs = addr.message_types();
+  sink << static_cast<uint32_t>(sigs.size());
+  for (auto& sig : sigs) {
+    sink << sig;
+  }
+}
+
+// reads the payload of server handshakes and resolve responses
+actor_id read_published_actor(binary_deserializer& bd,
+                              std::set<string>& ifs) {
+  auto aid = bd.read<uint32_t>();
+  auto num_ifs = bd.read<uint32_t>();
+  for (uint32_t i = 0; i < num_ifs; ++i) {
+    ifs.insert(bd.read<string>());
+  }
+  return aid;
+}
+
+// returns an error message if a remote actor implementing `found`
+// does not match the interface `expected` by the client
+string interface_mismatch(const std::set<string>& expected,
+                          const std::set<string>& found) {
+  if (std::includes(expected.begin(), expected.end(),
+                    found.begin(), found.end())) {
+    return {};
+  }
+  auto tostr = [](const std::set<string>& what) -> string {
+    if (what.empty()) {
+      return "actor";
+    }
+    string tmp;
+    tmp = "typed_actor<";
+    auto i = what.begin();
+    auto e = what.end();
+    tmp += *i++;
+    while (i != e) {
+      tmp += ",";
+      tmp += *i++;
+    }
+    tmp += ">";
+    return tmp;
+  };
+  auto iface_str = tostr(found);
+  auto expected_str = tostr(expected);
+  if (expected.empty()) {
+    return "expected remote actor to be a "
+           "dynamically typed actor but found "
+           "a strongly typed actor of type "
+           + iface_str;
+  }
+  if (found.empty()) {
+    return "expected remote actor to be a "
+           "strongly typed actor of type "
+           + expected_str +
+           " but found a dynamically typed actor";
+  }
+  return "expected remote actor to be a "
+         "strongly typed actor of type "
+         + expected_str +
+         " but found a strongly typed actor of type "
+         + iface_str;
+}
+
+} // namespace <anonymous>
+
 basp_broker::basp_broker(middleman& pref) : broker(pref), m_namespace(*this) {
   m_meta_msg = uniform_typeid<message>();
   m_meta_id_type = uniform_typeid<node_id>();
@@ -96,8 +169,25 @@ behavior basp_broker::make_behavior() {
       init_handshake_as_server(ctx, m_acceptors[msg.source].first->address());
     },
     // received from underlying broker implementation
+    [=](const connection_backpressure_msg& msg) {
+      CAF_LOG_TRACE(CAF_MARG(msg.handle, id) << ", "
+                    << CAF_ARG(msg.congested));
+      if (msg.congested) {
+        m_congested.insert(msg.handle);
+      } else {
+        m_congested.erase(msg.handle);
+        unstall(msg.handle);
+      }
+      update_congested_proxies();
+    },
+    // received from underlying broker implementation
     [=](const connection_closed_msg& msg) {
       CAF_LOG_TRACE(CAF_MARG(msg.handle, id));
+      m_congested.erase(msg.handle);
+      unstall(msg.handle);
+      for (auto& kvp : m_stalled) {
+        kvp.second.erase(msg.handle);
+      }
       auto j = m_ctx.find(msg.handle);
       if (j != m_ctx.end()) {
         auto hd = j->second.handshake_data;
@@ -105,6 +195,10 @@ behavior basp_broker::make_behavior() {
           send(hd->client, error_atom::value, hd->request_id,
                "disconnect during handshake");
         }
+        // clients need to look up the actors again using a new connection
+        for (auto& kvp : j->second.pending_resolves) {
+          send(kvp.second.client, get_atom::value, kvp.first);
+        }
         m_ctx.erase(j);
       }
       // purge handle from all routes
@@ -135,6 +229,8 @@ behavior basp_broker::make_behavior() {
           p->kill_proxy(exit_reason::remote_link_unreachable);
         }
       }
+      // remaining proxies might have switched to another route
+      update_congested_proxies();
     },
     // received from underlying broker implementation
     [=](const acceptor_closed_msg& msg) {
@@ -144,7 +240,8 @@ behavior basp_broker::make_behavior() {
         CAF_LOG_INFO("accept handle no longer in use");
         return;
       }
-      if (m_open_ports.erase(i->second.second) == 0) {
+      if (i->second.second != 0
+          && !erase_open_port(i->second.second, msg.handle)) {
         CAF_LOG_INFO("accept handle was not bound to a port");
       }
       m_acceptors.erase(i);
@@ -175,8 +272,62 @@ behavior basp_broker::make_behavior() {
         CAF_LOG_DEBUG("failed to assign doorman from handle");
         return;
       }
+      auto is_new_port = m_open_ports.count(port) == 0;
       add_published_actor(hdl, actor_cast<abstract_actor_ptr>(whom), port);
-      parent().notify<hook::actor_published>(whom, port);
+      if (is_new_port) {
+        parent().notify<hook::actor_published>(whom, port);
+      }
+    },
+    [=](put_atom, int64_t request_id, const actor_addr& whom, uint16_t port,
+        std::string& reason) -> message {
+      CAF_LOG_TRACE(CAF_ARG(request_id) << ", " << CAF_TSARG(whom)
+                    << ", " << CAF_ARG(port));
+      // the middleman actor could not bind `port`, which is fine
+      // if `whom` already is the actor published at this port
+      auto i = m_open_ports.find(port);
+      if (i != m_open_ports.end()) {
+        auto j = m_acceptors.find(i->second);
+        if (j != m_acceptors.end() && j->second.first->address() == whom) {
+          return make_message(ok_atom::value, request_id, port);
+        }
+      }
+      return make_message(error_atom::value, request_id, std::move(reason));
+    },
+    [=](put_atom, accept_handle hdl, const actor_addr& whom,
+        const std::string&) {
+      CAF_LOG_TRACE(CAF_ARG(hdl.id()) << ", "<< CAF_TSARG(whom));
+      if (hdl.invalid() || whom == invalid_actor_addr) {
+        return;
+      }
+      try {
+        assign_local_doorman(hdl);
+      }
+      catch (...) {
+        CAF_LOG_DEBUG("failed to assign doorman from handle");
+        return;
+      }
+      // port 0 marks acceptors listening on a Unix domain socket
+      add_published_actor(hdl, actor_cast<abstract_actor_ptr>(whom), 0);
+    },
+    [=](get_atom, connection_handle hdl, const std::string&,
+        int64_t request_id, actor client, std::set<std::string>& expected_ifs) {
+      CAF_LOG_TRACE(CAF_ARG(hdl.id()) << ", " << CAF_ARG(request_id)
+                    << ", " << CAF_TSARG(client));
+      try {
+        assign_local_scribe(hdl);
+      }
+      catch (std::exception& e) {
+        CAF_LOG_DEBUG("failed to assign scribe from handle: " << e.what());
+        send(client, error_atom::value, request_id,
+             std::string("failed to assign scribe from handle: ") + e.what());
+        return;
+      }
+      auto& ctx = m_ctx[hdl];
+      ctx.hdl = hdl;
+      ctx.handshake_data = client_handshake_data{request_id, client,
+                                                 std::set<std::string>()};
+      ctx.handshake_data->expected_ifs.swap(expected_ifs);
+      init_handshake_as_client(ctx);
     },
     [=](get_atom, connection_handle hdl, int64_t request_id,
         actor client, std::set<std::string>& expected_ifs) {
@@ -201,6 +352,36 @@ behavior basp_broker::make_behavior() {
       ctx.handshake_data->expected_ifs.swap(expected_ifs);
       init_handshake_as_client(ctx);
     },
+    [=](get_atom, const node_id& nid, uint16_t port, int64_t request_id,
+        actor client, std::set<std::string>& expected_ifs) {
+      CAF_LOG_TRACE(CAF_TSARG(nid) << ", " << CAF_ARG(port) << ", "
+                    << CAF_ARG(request_id) << ", " << CAF_TSARG(client));
+      // re-use a direct connection to `nid` if we have one
+      auto i = m_routes.find(nid);
+      auto j = i != m_routes.end() && !i->second.first.invalid()
+               ? m_ctx.find(i->second.first.hdl)
+               : m_ctx.end();
+      if (j == m_ctx.end()) {
+        CAF_LOG_DEBUG("no direct connection to " << to_string(nid));
+        send(client, get_atom::value, request_id);
+        return;
+      }
+      if (j->second.remote_version < basp::resolve_version) {
+        CAF_LOG_DEBUG(to_string(nid) << " does not support resolve_request");
+        send(client, get_atom::value, request_id);
+        return;
+      }
+      auto& ctx = j->second;
+      auto& hd = ctx.pending_resolves[request_id];
+      hd = client_handshake_data{request_id, client, std::set<std::string>()};
+      hd.expected_ifs.swap(expected_ifs);
+      auto writer = make_payload_writer([&](binary_serializer& sink) {
+        sink << port;
+      });
+      dispatch(ctx.hdl, basp::resolve_request, node(), invalid_actor_id,
+               nid, invalid_actor_id, static_cast<uint64_t>(request_id),
+               &writer);
+    },
     [=](delete_atom, int64_t request_id, const actor_addr& whom, uint16_t port)
     -> message {
       CAF_LOG_TRACE(CAF_ARG(request_id) << ", " << CAF_TSARG(whom)
@@ -391,10 +572,24 @@ void basp_broker::dispatch(const actor_addr& from, const actor_addr& to,
     auto reg = detail::singletons::get_actor_registry();
     reg->put(from.id(), actor_cast<abstract_actor_ptr>(from));
   }
+  // proxies keep local senders from flooding congested routes,
+  // see update_congested_proxies()
+  auto route = get_route(to.node());
+  // the trace context is set while processing a traced '_Dispatch' message;
+  // nodes using an older BASP version do not understand the trace context
+  auto ctx = detail::current_trace_context();
+  if (remote_version(route.hdl) < basp::traced_message_version) {
+    ctx.trace_id = 0;
+  }
   auto writer = make_payload_writer([&](binary_serializer& sink) {
+    if (ctx.trace_id != 0) {
+      sink.write(ctx.trace_id).write(ctx.span_id);
+    }
     sink.write(msg, m_meta_msg);
   });
-  auto route_node = dispatch(basp::dispatch_message, from.node(), from.id(),
+  auto op = ctx.trace_id != 0 ? basp::dispatch_traced_message
+                              : basp::dispatch_message;
+  auto route_node = dispatch(op, from.node(), from.id(),
                              to.node(), to.id(), mid.integer_value(), &writer);
   if (route_node == invalid_node_id) {
     parent().notify<hook::message_sending_failed>(from, to, mid, msg);
@@ -454,13 +649,33 @@ basp_broker::handle_basp_header(connection_context& ctx,
                                                        hdr.dest_node, payload);
       return close_connection;
     }
+    if (m_congested.count(route.hdl) > 0) {
+      // forward the message anyway but stop reading from this
+      // connection until the next hop has caught up
+      CAF_LOG_DEBUG("connection to node " << to_string(route.node)
+                    << " is congested, stall " << ctx.hdl.id());
+      stall(ctx.hdl, route.hdl);
+    }
     CAF_LOG_DEBUG("received message that is not addressed to us -> "
                   << "forward via " << to_string(route.node));
     auto& buf = wr_buf(route.hdl);
     binary_serializer bs{std::back_inserter(buf), &m_namespace};
-    write(bs, hdr);
+    auto first = payload ? payload->begin() : buffer_type::const_iterator{};
+    if (hdr.operation == basp::dispatch_traced_message
+        && remote_version(route.hdl) < basp::traced_message_version) {
+      // the next hop does not understand traced messages
+      // => forward the message without its trace context
+      auto trace_context_size = sizeof(uint64_t) * 2;
+      auto stripped = hdr;
+      stripped.operation = basp::dispatch_message;
+      stripped.payload_len -= static_cast<uint32_t>(trace_context_size);
+      write(bs, stripped);
+      first += static_cast<ptrdiff_t>(trace_context_size);
+    } else {
+      write(bs, hdr);
+    }
     if (payload) {
-      buf.insert(buf.end(), payload->begin(), payload->end());
+      buf.insert(buf.end(), first, payload->end());
     }
     flush(route.hdl);
     parent().notify<hook::message_forwarded>(hdr.source_node,
@@ -476,7 +691,25 @@ basp_broker::handle_basp_header(connection_context& ctx,
       CAF_REQUIRE(payload != nullptr);
       binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
       message content;
-      bd.read(content, m_meta_msg);
+      { // lifetime scope of arena guard
+        detail::message_arena::scope guard{ctx.arena};
+        bd.read(content, m_meta_msg);
+      }
+      local_dispatch(ctx.hdr, std::move(content));
+      break;
+    }
+    case basp::dispatch_traced_message: {
+      CAF_REQUIRE(payload != nullptr);
+      binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
+      trace_context tctx;
+      bd.read(tctx.trace_id).read(tctx.span_id);
+      message content;
+      { // lifetime scope of arena guard
+        detail::message_arena::scope guard{ctx.arena};
+        bd.read(content, m_meta_msg);
+      }
+      // continues the trace of the sender in the receiving actor
+      detail::trace_scope guard{tctx};
       local_dispatch(ctx.hdr, std::move(content));
       break;
     }
@@ -519,6 +752,10 @@ basp_broker::handle_basp_header(connection_context& ctx,
         return close_connection;
       }
       ctx.remote_id = hdr.source_node;
+      // clients using BASP version 1 leave operation_data zeroed
+      ctx.remote_version = hdr.operation_data == 0
+                           ? 1
+                           : std::min(hdr.operation_data, basp::version);
       if (node() == ctx.remote_id) {
         CAF_LOG_INFO("incoming connection from self");
         return close_connection;
@@ -536,61 +773,26 @@ basp_broker::handle_basp_header(connection_context& ctx,
         CAF_LOG_INFO("received unexpected server handshake");
         return close_connection;
       }
-      if (hdr.operation_data != basp::version) {
-        CAF_LOG_INFO("tried to connect to a node with different BASP version");
+      if (hdr.operation_data < basp::min_version) {
+        CAF_LOG_INFO("tried to connect to a node with incompatible "
+                     "BASP version");
         return close_connection;
       }
       ctx.remote_id = hdr.source_node;
       binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
-      auto remote_aid = bd.read<uint32_t>();
-      auto remote_ifs_size = bd.read<uint32_t>();
       std::set<string> remote_ifs;
-      for (uint32_t i = 0; i < remote_ifs_size; ++i) {
-        auto str = bd.read<string>();
-        remote_ifs.insert(std::move(str));
+      auto remote_aid = read_published_actor(bd, remote_ifs);
+      // servers using BASP version 1 send no trailing version
+      auto remote_version = hdr.operation_data;
+      if (bd.remaining() >= sizeof(uint64_t)) {
+        remote_version = std::max(remote_version, bd.read<uint64_t>());
       }
+      ctx.remote_version = std::min(remote_version, basp::version);
       auto& ifs = ctx.handshake_data->expected_ifs;
       auto hsclient = ctx.handshake_data->client;
       auto hsid = ctx.handshake_data->request_id;
-      if (!std::includes(ifs.begin(), ifs.end(),
-                         remote_ifs.begin(), remote_ifs.end())) {
-        auto tostr = [](const std::set<string>& what) -> string {
-          if (what.empty()) {
-            return "actor";
-          }
-          string tmp;
-          tmp = "typed_actor<";
-          auto i = what.begin();
-          auto e = what.end();
-          tmp += *i++;
-          while (i != e) {
-            tmp += ",";
-            tmp += *i++;
-          }
-          tmp += ">";
-          return tmp;
-        };
-        auto iface_str = tostr(remote_ifs);
-        auto expected_str = tostr(ifs);
-        std::string error_msg;
-        if (ifs.empty()) {
-          error_msg = "expected remote actor to be a "
-                      "dynamically typed actor but found "
-                      "a strongly typed actor of type "
-                      + iface_str;
-        }
-        else if (remote_ifs.empty()) {
-          error_msg = "expected remote actor to be a "
-                      "strongly typed actor of type "
-                      + expected_str +
-                      " but found a dynamically typed actor";
-        } else {
-          error_msg = "expected remote actor to be a "
-                      "strongly typed actor of type "
-                      + expected_str +
-                      " but found a strongly typed actor of type "
-                      + iface_str;
-        }
+      auto error_msg = interface_mismatch(ifs, remote_ifs);
+      if (!error_msg.empty()) {
         // abort with error
         send(hsclient, error_atom::value, hsid, std::move(error_msg));
         return close_connection;
@@ -612,9 +814,11 @@ basp_broker::handle_basp_header(connection_context& ctx,
         ctx.handshake_data = none;
         return close_connection;
       }
-      // finalize handshake
+      // finalize handshake; servers using BASP version 1
+      // expect operation_data to be zeroed
       dispatch(ctx.hdl, basp::client_handshake,
-               node(), invalid_actor_id, nid, invalid_actor_id);
+               node(), invalid_actor_id, nid, invalid_actor_id,
+               ctx.remote_version > 1 ? ctx.remote_version : 0);
       // prepare to receive messages
       auto proxy = m_namespace.get_or_put(nid, remote_aid);
       ctx.published_actor = proxy;
@@ -623,6 +827,66 @@ basp_broker::handle_basp_header(connection_context& ctx,
       parent().notify<hook::new_connection_established>(nid);
       break;
     }
+    case basp::resolve_request: {
+      CAF_REQUIRE(payload != nullptr);
+      binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
+      auto port = bd.read<uint16_t>();
+      actor_addr addr;
+      auto i = m_open_ports.find(port);
+      if (i != m_open_ports.end()) {
+        auto j = m_acceptors.find(i->second);
+        if (j != m_acceptors.end()) {
+          addr = j->second.first->address();
+        }
+      }
+      CAF_LOG_DEBUG("resolve port " << port << " -> " << to_string(addr));
+      if (addr == invalid_actor_addr) {
+        dispatch(ctx.hdl, basp::resolve_response, node(), invalid_actor_id,
+                 hdr.source_node, invalid_actor_id, hdr.operation_data);
+      } else {
+        auto writer = make_payload_writer([&](binary_serializer& sink) {
+          write_published_actor(sink, addr);
+        });
+        dispatch(ctx.hdl, basp::resolve_response, node(), addr.id(),
+                 hdr.source_node, invalid_actor_id, hdr.operation_data,
+                 &writer);
+      }
+      break;
+    }
+    case basp::resolve_response: {
+      auto i = ctx.pending_resolves.find(
+                 static_cast<int64_t>(hdr.operation_data));
+      if (i == ctx.pending_resolves.end()) {
+        CAF_LOG_INFO("received unexpected resolve response");
+        break;
+      }
+      auto hd = std::move(i->second);
+      ctx.pending_resolves.erase(i);
+      if (hdr.source_actor == invalid_actor_id) {
+        // the node has no actor published at this port (anymore),
+        // i.e., the client needs to open a new connection
+        send(hd.client, get_atom::value, hd.request_id);
+        break;
+      }
+      CAF_REQUIRE(payload != nullptr);
+      binary_deserializer bd{payload->data(), payload->size(), &m_namespace};
+      std::set<string> remote_ifs;
+      auto remote_aid = read_published_actor(bd, remote_ifs);
+      auto error_msg = interface_mismatch(hd.expected_ifs, remote_ifs);
+      if (!error_msg.empty()) {
+        send(hd.client, error_atom::value, hd.request_id,
+             std::move(error_msg));
+        break;
+      }
+      auto proxy = m_namespace.get_or_put(hdr.source_node, remote_aid);
+      if (!proxy) {
+        send(hd.client, error_atom::value, hd.request_id,
+             std::string("cannot create proxy for remote actor"));
+        break;
+      }
+      send(hd.client, ok_atom::value, hd.request_id, proxy->address());
+      break;
+    }
   }
   return await_header;
 }
@@ -637,6 +901,50 @@ void basp_broker::send_kill_proxy_instance(const node_id& nid, actor_id aid,
   }
 }
 
+uint64_t basp_broker::remote_version(connection_handle hdl) const {
+  auto i = m_ctx.find(hdl);
+  return i != m_ctx.end() ? i->second.remote_version : 0;
+}
+
+void basp_broker::stall(connection_handle source, connection_handle route) {
+  CAF_LOG_TRACE(CAF_MARG(source, id) << ", " << CAF_MARG(route, id));
+  if (m_stalled[route].insert(source).second) {
+    pause_reading(source, true);
+  }
+}
+
+void basp_broker::unstall(connection_handle route) {
+  CAF_LOG_TRACE(CAF_MARG(route, id));
+  auto i = m_stalled.find(route);
+  if (i == m_stalled.end()) {
+    return;
+  }
+  auto sources = std::move(i->second);
+  m_stalled.erase(i);
+  for (auto& source : sources) {
+    // a connection may feed more than one congested route
+    auto still_stalled = false;
+    for (auto& kvp : m_stalled) {
+      still_stalled = still_stalled || kvp.second.count(source) > 0;
+    }
+    if (!still_stalled && m_ctx.count(source) > 0) {
+      pause_reading(source, false);
+    }
+  }
+}
+
+void basp_broker::update_congested_proxies() {
+  CAF_LOG_TRACE("");
+  for (auto& proxy : m_namespace.get_all()) {
+    // all proxies are created by make_proxy
+    auto ptr = static_cast<forwarding_actor_proxy*>(proxy.get());
+    auto value = m_congested.count(get_route(ptr->node()).hdl) > 0;
+    if (ptr->congested() != value) {
+      ptr->congested(value);
+    }
+  }
+}
+
 basp_broker::connection_info basp_broker::get_route(const node_id& dest) {
   connection_info res;
   auto i = m_routes.find(dest);
@@ -677,6 +985,9 @@ actor_proxy_ptr basp_broker::make_proxy(const node_id& nid, actor_id aid) {
   intrusive_ptr<basp_broker> self = this;
   auto mm = middleman::instance();
   auto res = make_counted<forwarding_actor_proxy>(aid, nid, self);
+  if (m_congested.count(route.hdl) > 0) {
+    res->congested(true);
+  }
   res->attach_functor([=](uint32_t) {
     mm->backend().dispatch([=] {
       // using res->id() instead of aid keeps this actor instance alive
@@ -742,6 +1053,8 @@ void basp_broker::init_handshake_as_client(connection_context& ctx) {
   CAF_LOG_TRACE(CAF_ARG(this));
   ctx.state = await_server_handshake;
   configure_read(ctx.hdl, receive_policy::exactly(basp::header_size));
+  auto wm = parent().write_watermarks();
+  write_watermarks(ctx.hdl, wm.first, wm.second);
 }
 
 void basp_broker::init_handshake_as_server(connection_context& ctx,
@@ -749,23 +1062,23 @@ void basp_broker::init_handshake_as_server(connection_context& ctx,
   CAF_LOG_TRACE(CAF_ARG(this));
   CAF_REQUIRE(node() != invalid_node_id);
   if (addr != invalid_actor_addr) {
+    // clients using BASP version 1 ignore the trailing version
     auto writer = make_payload_writer([&](binary_serializer& sink) {
-      sink << addr.id();
-      auto sigs = addr.message_types();
-      sink << static_cast<uint32_t>(sigs.size());
-      for (auto& sig : sigs) {
-        sink << sig;
-      }
+      write_published_actor(sink, addr);
+      sink << basp::version;
     });
     dispatch(ctx.hdl, basp::server_handshake, node(), addr.id(),
-             invalid_node_id, invalid_actor_id, basp::version, &writer);
+             invalid_node_id, invalid_actor_id, basp::handshake_version,
+             &writer);
   } else {
     dispatch(ctx.hdl, basp::server_handshake, node(), invalid_actor_id,
-             invalid_node_id, invalid_actor_id, basp::version);
+             invalid_node_id, invalid_actor_id, basp::handshake_version);
   }
   // prepare for receiving client handshake
   ctx.state = await_client_handshake;
   configure_read(ctx.hdl, receive_policy::exactly(basp::header_size));
+  auto wm = parent().write_watermarks();
+  write_watermarks(ctx.hdl, wm.first, wm.second);
 }
 
 void basp_broker::add_published_actor(accept_handle hdl,
@@ -776,7 +1089,14 @@ void basp_broker::add_published_actor(accept_handle hdl,
     return;
   }
   m_acceptors.insert(std::make_pair(hdl, std::make_pair(ptr, port)));
-  m_open_ports.insert(std::make_pair(port, hdl));
+  auto is_new_port = port == 0 || m_open_ports.count(port) == 0;
+  if (port != 0) {
+    m_open_ports.insert(std::make_pair(port, hdl));
+  }
+  if (!is_new_port) {
+    // additional SO_REUSEPORT acceptor for an already published port
+    return;
+  }
   ptr->attach_functor([port](abstract_actor* self, uint32_t) {
     unpublish_impl(self->address(), port, false);
   });
@@ -796,7 +1116,7 @@ bool basp_broker::remove_published_actor(const abstract_actor_ptr& whom) {
     if (kvp.first == whom) {
       CAF_REQUIRE(valid(i->first));
       close(i->first);
-      if (m_open_ports.erase(kvp.second) == 0) {
+      if (kvp.second != 0 && !erase_open_port(kvp.second, i->first)) {
         CAF_LOG_ERROR("inconsistent data: no open port for acceptor!");
       }
       i = m_acceptors.erase(i);
@@ -814,26 +1134,38 @@ bool basp_broker::remove_published_actor(const abstract_actor_ptr& whom,
   CAF_LOG_TRACE("");
   CAF_REQUIRE(whom != nullptr);
   CAF_REQUIRE(port != 0);
-  auto i = m_open_ports.find(port);
-  if (i == m_open_ports.end()) {
+  auto range = m_open_ports.equal_range(port);
+  if (range.first == range.second) {
     return false;
   }
-  CAF_REQUIRE(valid(i->second));
-  auto j = m_acceptors.find(i->second);
-  if (j->second.first != whom) {
+  // all acceptors of a port are bound to the same actor
+  auto j = m_acceptors.find(range.first->second);
+  if (j != m_acceptors.end() && j->second.first != whom) {
     CAF_LOG_INFO("port has been bound to a different actor");
     return false;
   }
-  close(i->second);
-  m_open_ports.erase(i);
-  if (j == m_acceptors.end()) {
-    CAF_LOG_ERROR("inconsistent data: accept handle for port " << port
-                  << " not found in m_published_actors");
-  } else {
-    m_acceptors.erase(j);
+  for (auto i = range.first; i != range.second; ++i) {
+    CAF_REQUIRE(valid(i->second));
+    close(i->second);
+    if (m_acceptors.erase(i->second) == 0) {
+      CAF_LOG_ERROR("inconsistent data: accept handle for port " << port
+                    << " not found in m_published_actors");
+    }
   }
+  m_open_ports.erase(range.first, range.second);
   return true;
 }
 
+bool basp_broker::erase_open_port(uint16_t port, accept_handle hdl) {
+  auto range = m_open_ports.equal_range(port);
+  for (auto i = range.first; i != range.second; ++i) {
+    if (i->second == hdl) {
+      m_open_ports.erase(i);
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace io
 } // namespace caf
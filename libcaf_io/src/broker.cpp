@@ -95,8 +95,28 @@ void broker::scribe::consume(const void*, size_t num_bytes) {
   read_msg().buf.swap(buf);                    // swap into message
   m_broker->invoke_message(invalid_actor_addr, // call client
                            invalid_message_id, m_read_msg);
-  read_msg().buf.swap(buf); // swap buffer back to stream
-  flush();                  // implicit flush of wr_buf()
+  if (!m_read_msg.empty() && m_read_msg.cvals()->unique()) {
+    read_msg().buf.swap(buf); // swap buffer back to stream
+  } else {
+    // the broker kept the message, e.g., by forwarding it to another actor
+    // or by skipping it, i.e., the message now owns the buffer and the
+    // stream borrows a fresh buffer for the next read
+    m_read_msg = make_message(new_data_msg{m_hdl, buffer_type{}});
+  }
+  flush(); // implicit flush of wr_buf()
+}
+
+void broker::scribe::backpressure(bool congested) {
+  CAF_LOG_TRACE(CAF_ARG(congested));
+  if (m_disconnected) {
+    return;
+  }
+  // we might get called from within a message handler of the broker,
+  // hence we must not invoke the broker directly
+  m_broker->enqueue(invalid_actor_addr, invalid_message_id,
+                    make_message(connection_backpressure_msg{hdl(),
+                                                             congested}),
+                    nullptr);
 }
 
 void broker::scribe::io_failure(network::operation op) {
@@ -134,6 +154,56 @@ void broker::doorman::io_failure(network::operation op) {
   disconnect(true);
 }
 
+broker::datagram_servant::datagram_servant(broker* ptr, datagram_handle hdl)
+    : servant(ptr),
+      m_hdl(hdl) {
+  m_read_msg = make_message(new_datagram_msg{m_hdl, endpoint_handle{},
+                                             buffer_type{}});
+}
+
+broker::datagram_servant::~datagram_servant() {
+  CAF_LOG_TRACE("");
+}
+
+void broker::datagram_servant::remove_from_broker() {
+  CAF_LOG_TRACE("hdl = " << hdl().id());
+  m_broker->m_datagram_servants.erase(hdl());
+}
+
+message broker::datagram_servant::disconnect_message() {
+  return make_message(datagram_servant_closed_msg{hdl()});
+}
+
+void broker::datagram_servant::consume(endpoint_handle ep, buffer_type& buf) {
+  CAF_LOG_TRACE(CAF_MARG(ep, id) << ", size = " << buf.size());
+  if (m_disconnected) {
+    // see broker::scribe::consume
+    return;
+  }
+  read_msg().endpoint = ep;
+  read_msg().buf.swap(buf);
+  m_broker->invoke_message(invalid_actor_addr, invalid_message_id,
+                           m_read_msg);
+  if (!m_read_msg.empty() && m_read_msg.cvals()->unique()) {
+    read_msg().buf.swap(buf);
+  } else {
+    // the broker kept the message, i.e., the message now owns the buffer
+    // and the datagram socket borrows a fresh buffer for the next read
+    m_read_msg = make_message(new_datagram_msg{m_hdl, endpoint_handle{},
+                                               buffer_type{}});
+  }
+  // no implicit flush here, the datagram socket sends all datagrams
+  // enqueued by the broker at once after processing a batch of reads
+}
+
+void broker::datagram_servant::io_failure(network::operation op) {
+  CAF_LOG_TRACE("id = " << hdl().id() << ", "
+                        << CAF_TARG(op, static_cast<int>));
+  // keep compiler happy when compiling w/o logging
+  static_cast<void>(op);
+  disconnect(true);
+}
+
 class broker::continuation {
  public:
   continuation(broker_ptr bptr, mailbox_element_ptr mptr)
@@ -246,6 +316,11 @@ void broker::write(connection_handle hdl, size_t bs, const void* buf) {
   out.insert(out.end(), first, last);
 }
 
+void broker::write(datagram_handle hdl, endpoint_handle ep, size_t bs,
+                   const void* buf) {
+  by_id(hdl).write(ep, buf, bs);
+}
+
 void broker::enqueue(mailbox_element_ptr ptr, execution_unit*) {
   parent().backend().post(continuation{this, std::move(ptr)});
 }
@@ -270,6 +345,7 @@ void broker::cleanup(uint32_t reason) {
   close_all();
   CAF_REQUIRE(m_doormen.empty());
   CAF_REQUIRE(m_scribes.empty());
+  CAF_REQUIRE(m_datagram_servants.empty());
   CAF_REQUIRE(current_mailbox_element() == nullptr);
   m_cache.clear();
   super::cleanup(reason);
@@ -296,6 +372,9 @@ void broker::launch(execution_unit*, bool, bool is_hidden) {
       for (auto& kvp : m_doormen) {
         kvp.second->launch();
       }
+      for (auto& kvp : m_datagram_servants) {
+        kvp.second->launch();
+      }
       is_initialized(true);
       // run user-defined initialization code
       auto bhvr = make_behavior();
@@ -314,6 +393,18 @@ void broker::configure_read(connection_handle hdl, receive_policy::config cfg) {
   by_id(hdl).configure_read(cfg);
 }
 
+void broker::write_watermarks(connection_handle hdl, size_t low,
+                              size_t high) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(low) << ", "
+                << CAF_ARG(high));
+  by_id(hdl).write_watermarks(low, high);
+}
+
+void broker::pause_reading(connection_handle hdl, bool paused) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(paused));
+  by_id(hdl).pause_reading(paused);
+}
+
 void broker::flush(connection_handle hdl) {
   by_id(hdl).flush();
 }
@@ -322,6 +413,33 @@ broker::buffer_type& broker::wr_buf(connection_handle hdl) {
   return by_id(hdl).wr_buf();
 }
 
+void broker::max_datagram_size(datagram_handle hdl, size_t num_bytes) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(num_bytes));
+  by_id(hdl).max_datagram_size(num_bytes);
+}
+
+void broker::max_udp_endpoints(datagram_handle hdl, size_t num_endpoints) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(num_endpoints));
+  by_id(hdl).max_endpoints(num_endpoints);
+}
+
+endpoint_handle broker::add_udp_endpoint(datagram_handle hdl,
+                                         const std::string& host,
+                                         uint16_t port) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_ARG(host)
+                << ", " << CAF_ARG(port));
+  return by_id(hdl).add_endpoint(host, port);
+}
+
+void broker::release_udp_endpoint(datagram_handle hdl, endpoint_handle ep) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id) << ", " << CAF_MARG(ep, id));
+  by_id(hdl).release_endpoint(ep);
+}
+
+void broker::flush(datagram_handle hdl) {
+  by_id(hdl).flush();
+}
+
 broker::~broker() {
   CAF_LOG_TRACE("");
 }
@@ -334,6 +452,10 @@ void broker::close(accept_handle hdl) {
   by_id(hdl).stop_reading();
 }
 
+void broker::close(datagram_handle hdl) {
+  by_id(hdl).stop_reading();
+}
+
 void broker::close_all() {
   CAF_LOG_TRACE("");
   while (!m_doormen.empty()) {
@@ -344,6 +466,10 @@ void broker::close_all() {
     // stop_reading will remove the scribe from m_scribes
     m_scribes.begin()->second->stop_reading();
   }
+  while (!m_datagram_servants.empty()) {
+    // stop_reading will remove the servant from m_datagram_servants
+    m_datagram_servants.begin()->second->stop_reading();
+  }
 }
 
 bool broker::valid(connection_handle hdl) {
@@ -354,6 +480,10 @@ bool broker::valid(accept_handle hdl) {
   return m_doormen.count(hdl) > 0;
 }
 
+bool broker::valid(datagram_handle hdl) {
+  return m_datagram_servants.count(hdl) > 0;
+}
+
 std::vector<connection_handle> broker::connections() const {
   std::vector<connection_handle> result;
   for (auto& kvp : m_scribes) {
@@ -410,5 +540,43 @@ accept_handle broker::add_tcp_doorman(network::native_socket fd) {
   return backend().add_tcp_doorman(this, fd);
 }
 
+connection_handle broker::add_local_scribe(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  return backend().add_local_scribe(this, path);
+}
+
+void broker::assign_local_scribe(connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id));
+  backend().assign_local_scribe(this, hdl);
+}
+
+accept_handle broker::add_local_doorman(const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  return backend().add_local_doorman(this, path);
+}
+
+void broker::assign_local_doorman(accept_handle hdl) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id));
+  backend().assign_local_doorman(this, hdl);
+}
+
+std::pair<datagram_handle, uint16_t>
+broker::add_udp_datagram_servant(uint16_t port, const char* in,
+                                 bool reuse_addr) {
+  CAF_LOG_TRACE(CAF_ARG(port) << ", in = " << (in ? in : "nullptr")
+                << ", " << CAF_ARG(reuse_addr));
+  return backend().add_udp_datagram_servant(this, port, in, reuse_addr);
+}
+
+void broker::assign_udp_datagram_servant(datagram_handle hdl) {
+  CAF_LOG_TRACE(CAF_MARG(hdl, id));
+  backend().assign_udp_datagram_servant(this, hdl);
+}
+
+datagram_handle broker::add_udp_datagram_servant(network::native_socket fd) {
+  CAF_LOG_TRACE(CAF_ARG(fd));
+  return backend().add_udp_datagram_servant(this, fd);
+}
+
 } // namespace io
 } // namespace caf
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/buffer_pool.hpp"
+
+#include <algorithm>
+
+namespace caf {
+namespace io {
+namespace network {
+
+constexpr size_t buffer_pool::min_capacity;
+constexpr size_t buffer_pool::max_capacity;
+constexpr size_t buffer_pool::max_fallback_classes;
+constexpr size_t buffer_pool::default_max_cached_bytes;
+constexpr size_t buffer_pool::num_classes;
+
+buffer_pool::buffer_pool()
+    : m_cached_bytes(0),
+      m_high_water_mark(0),
+      m_max_cached_bytes(default_max_cached_bytes) {
+  // nop
+}
+
+buffer_pool::buffer_type buffer_pool::take(size_t size) {
+  auto result = take_impl(size);
+  result.clear();
+  return result;
+}
+
+buffer_pool::buffer_type buffer_pool::take_initialized(size_t size) {
+  auto result = take_impl(size);
+  // zero-fills only memory that no previous user has initialized
+  result.resize(result.capacity());
+  return result;
+}
+
+buffer_pool::buffer_type buffer_pool::take_impl(size_t size) {
+  buffer_type result;
+  if (size > max_capacity) {
+    result.reserve(size);
+    return result;
+  }
+  // pick the smallest class guaranteeing a sufficient capacity
+  size_t idx = 0;
+  size_t capacity = min_capacity;
+  while (capacity < size) {
+    capacity *= 2;
+    ++idx;
+  }
+  // fall back to somewhat larger buffers before allocating new memory
+  auto last = std::min(idx + max_fallback_classes + 1, num_classes);
+  for (; idx < last; ++idx) {
+    auto& xs = m_classes[idx];
+    if (!xs.empty()) {
+      result.swap(xs.back());
+      xs.pop_back();
+      auto cached = cached_bytes() - result.capacity();
+      m_cached_bytes.store(cached, std::memory_order_relaxed);
+      return result;
+    }
+  }
+  result.reserve(capacity);
+  return result;
+}
+
+void buffer_pool::release(buffer_type& buf) {
+  auto capacity = buf.capacity();
+  auto cached = cached_bytes() + capacity;
+  if (capacity < min_capacity || capacity >= 2 * max_capacity
+      || cached > max_cached_bytes()) {
+    buffer_type{}.swap(buf);
+    return;
+  }
+  // pick the largest class not exceeding the capacity of buf
+  size_t idx = 0;
+  while ((min_capacity << (idx + 1)) <= capacity) {
+    ++idx;
+  }
+  auto& xs = m_classes[idx];
+  xs.emplace_back();
+  xs.back().swap(buf);
+  m_cached_bytes.store(cached, std::memory_order_relaxed);
+  if (cached > high_water_mark()) {
+    m_high_water_mark.store(cached, std::memory_order_relaxed);
+  }
+}
+
+} // namespace network
+} // namespace io
+} // namespace caf
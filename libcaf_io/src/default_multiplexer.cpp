@@ -19,6 +19,10 @@
 
 #include "caf/io/network/default_multiplexer.hpp"
 
+#include <array>
+#include <memory>
+#include <algorithm>
+
 #include "caf/config.hpp"
 #include "caf/optional.hpp"
 #include "caf/exception.hpp"
@@ -39,6 +43,8 @@
 # include <errno.h>
 # include <netdb.h>
 # include <fcntl.h>
+# include <sys/un.h>
+# include <sys/stat.h>
 # include <sys/types.h>
 # include <arpa/inet.h>
 # include <sys/socket.h>
@@ -119,7 +125,9 @@ namespace network {
     auto rf = ccall(cc_not_minus1, "cannot read flags", fcntl, fd, F_GETFL, 0);
     // calculate and set new flags
     auto wf = new_value ? (rf | O_NONBLOCK) : (rf & (~(O_NONBLOCK)));
-    ccall(cc_not_minus1, "cannot set flags", fcntl, fd, F_SETFL, wf);
+    if (wf != rf) {
+      ccall(cc_not_minus1, "cannot set flags", fcntl, fd, F_SETFL, wf);
+    }
   }
 
   std::pair<native_socket, native_socket> create_pipe() {
@@ -255,10 +263,27 @@ namespace network {
   // In this implementation, m_shadow is the number of sockets we have
   // registered to epoll.
 
+  // maximum number of times handlers are dispatched from the ready
+  // list in edge-triggered mode before calling epoll_wait() again
+  constexpr size_t max_dispatch_rounds = 16;
+
   default_multiplexer::default_multiplexer()
       : m_epollfd(invalid_native_socket),
-        m_shadow(1) {
+        m_edge_triggered(false),
+        m_shadow(1),
+        m_resolver_done(false) {
     init();
+    m_pipe = create_pipe();
+    auto backend = getenv("CAF_MULTIPLEXER");
+    if (backend != nullptr && strcmp(backend, "io_uring") == 0) {
+      m_uring = io_uring_poller::make();
+      if (m_uring) {
+        m_uring->set(m_pipe.first, nullptr, input_mask);
+        return;
+      }
+      CAF_LOG_WARNING("io_uring not available, fall back to epoll");
+    }
+    m_edge_triggered = backend != nullptr && strcmp(backend, "epoll_et") == 0;
     m_epollfd = epoll_create1(EPOLL_CLOEXEC);
     if (m_epollfd == -1) {
       CAF_LOG_ERROR("epoll_create1: " << strerror(errno));
@@ -266,7 +291,6 @@ namespace network {
     }
     // handle at most 64 events at a time
     m_pollset.resize(64);
-    m_pipe = create_pipe();
     epoll_event ee;
     ee.events = input_mask;
     ee.data.ptr = nullptr;
@@ -277,10 +301,30 @@ namespace network {
   }
 
   void default_multiplexer::run() {
-    CAF_LOG_TRACE("epoll()-based multiplexer");
+    if (m_uring) {
+      CAF_LOG_TRACE("io_uring-based multiplexer");
+      std::vector<io_uring_poller::event> events;
+      while (m_shadow > 0) {
+        m_uring->wait(next_timeout(), events);
+        for (auto& e : events) {
+          handle_socket_event(e.fd, e.mask, e.ptr);
+        }
+        events.clear();
+        fire_timers(timer_clock::now());
+        for (auto& me : m_events) {
+          handle(me);
+        }
+        m_events.clear();
+      }
+      return;
+    }
+    CAF_LOG_TRACE("epoll()-based multiplexer; "
+                  << CAF_ARG(m_edge_triggered));
     while (m_shadow > 0) {
+      // don't block if some handlers are still ready for IO
       int presult = epoll_wait(m_epollfd, m_pollset.data(),
-                               static_cast<int>(m_pollset.size()), -1);
+                               static_cast<int>(m_pollset.size()),
+                               m_ready.empty() ? next_timeout() : 0);
       CAF_LOG_DEBUG("epoll_wait() on " << m_shadow << " sockets reported "
                     << presult << " event(s)");
       if (presult < 0) {
@@ -301,12 +345,32 @@ namespace network {
       for (; iter != last; ++iter) {
         auto ptr = reinterpret_cast<event_handler*>(iter->data.ptr);
         auto fd = ptr ? ptr->fd() : m_pipe.first;
-        handle_socket_event(fd, static_cast<int>(iter->events), ptr);
-      }
-      for (auto& me : m_events) {
-        handle(me);
+        auto mask = static_cast<int>(iter->events);
+        if (ptr && m_edge_triggered) {
+          // epoll reports each state change only once, hence we need
+          // to remember which operations won't block until the handler
+          // calls would_block()
+          ptr->m_readiness |= mask & (input_mask | output_mask);
+          if (ptr->m_readiness & ptr->eventbf()) {
+            schedule(ptr);
+          } else if (mask & error_mask) {
+            handle_socket_event(fd, mask & error_mask, ptr);
+          }
+        } else {
+          handle_socket_event(fd, mask, ptr);
+        }
       }
-      m_events.clear();
+      fire_timers(timer_clock::now());
+      // give handlers that remain ready a few more rounds before polling
+      // again, applying their registration changes in between
+      size_t rounds = 0;
+      do {
+        dispatch_ready();
+        for (auto& me : m_events) {
+          handle(me);
+        }
+        m_events.clear();
+      } while (!m_ready.empty() && ++rounds < max_dispatch_rounds);
     }
   }
 
@@ -340,7 +404,24 @@ namespace network {
                     << ": " << old << " -> " << e.mask);
       op = EPOLL_CTL_MOD;
     }
-    if (epoll_ctl(m_epollfd, op, e.fd, &ee) < 0) {
+    if (m_edge_triggered && e.ptr) {
+      if (op == EPOLL_CTL_DEL) {
+        unschedule(e.ptr);
+      } else {
+        // sockets are registered for reading and writing permanently,
+        // i.e., starting or stopping to write requires no epoll_ctl()
+        ee.events = input_mask | output_mask | EPOLLET;
+        if (e.ptr->m_readiness & e.mask) {
+          schedule(e.ptr);
+        }
+      }
+    }
+    if (m_uring) {
+      // registration changes are submitted along with the next wait
+      m_uring->set(e.fd, e.ptr, e.mask);
+    } else if (m_edge_triggered && e.ptr && op == EPOLL_CTL_MOD) {
+      // nop
+    } else if (epoll_ctl(m_epollfd, op, e.fd, &ee) < 0) {
       switch (last_socket_error()) {
         // supplied file descriptor is already registered
         case EEXIST:
@@ -388,7 +469,10 @@ namespace network {
   // are sorted by the file descriptor. This allows us to quickly,
   // i.e., O(1), access the actual object when handling socket events.
 
-  default_multiplexer::default_multiplexer() : m_epollfd(-1) {
+  default_multiplexer::default_multiplexer()
+      : m_epollfd(-1),
+        m_edge_triggered(false),
+        m_resolver_done(false) {
     init();
     // initial setup
     m_pipe = create_pipe();
@@ -417,10 +501,12 @@ namespace network {
       int presult;
       CAF_LOG_DEBUG("poll() " << m_pollset.size() << " sockets");
 #     ifdef CAF_WINDOWS
-        presult = ::WSAPoll(m_pollset.data(), m_pollset.size(), -1);
+        presult = ::WSAPoll(m_pollset.data(), m_pollset.size(),
+                            next_timeout());
 #     else
         presult = ::poll(m_pollset.data(),
-                         static_cast<nfds_t>(m_pollset.size()), -1);
+                         static_cast<nfds_t>(m_pollset.size()),
+                         next_timeout());
 #     endif
       if (presult < 0) {
         switch (last_socket_error()) {
@@ -462,6 +548,7 @@ namespace network {
         // operations possible on the socket
         handle_socket_event(e.fd, e.mask, e.ptr);
       }
+      fire_timers(timer_clock::now());
       CAF_LOG_DEBUG("handle " << m_events.size() << " generated events");
       poll_res.clear();
       for (auto& me : m_events) {
@@ -639,6 +726,77 @@ multiplexer::supervisor_ptr default_multiplexer::make_supervisor() {
 void default_multiplexer::close_pipe() {
   CAF_LOG_TRACE("");
   del(operation::read, m_pipe.first, nullptr);
+  // abort pending connects etc. instead of delaying the shutdown
+  fire_timers(timer_clock::time_point::max());
+}
+
+default_multiplexer::timer_map::iterator
+default_multiplexer::add_timer(timer_clock::time_point tp,
+                               std::function<void ()> f) {
+  return m_timers.emplace(tp, std::move(f));
+}
+
+void default_multiplexer::cancel_timer(timer_map::iterator i) {
+  m_timers.erase(i);
+}
+
+int default_multiplexer::next_timeout() const {
+  if (m_timers.empty()) {
+    return -1;
+  }
+  using std::chrono::milliseconds;
+  auto now = timer_clock::now();
+  auto tp = m_timers.begin()->first;
+  if (tp <= now) {
+    return 0;
+  }
+  // round up to not wake up right before the timer expires
+  auto ms = std::chrono::duration_cast<milliseconds>(tp - now).count() + 1;
+  return static_cast<int>(std::min<decltype(ms)>(ms, 60000));
+}
+
+void default_multiplexer::fire_timers(timer_clock::time_point now) {
+  // timers may add or cancel other timers while running
+  while (!m_timers.empty() && m_timers.begin()->first <= now) {
+    auto i = m_timers.begin();
+    auto f = std::move(i->second);
+    m_timers.erase(i);
+    f();
+  }
+}
+
+void default_multiplexer::schedule(event_handler* ptr) {
+  if (!ptr->m_scheduled) {
+    ptr->m_scheduled = true;
+    m_ready.push_back(ptr);
+  }
+}
+
+void default_multiplexer::unschedule(event_handler* ptr) {
+  ptr->m_readiness = 0;
+  if (ptr->m_scheduled) {
+    ptr->m_scheduled = false;
+    m_ready.erase(std::find(m_ready.begin(), m_ready.end(), ptr));
+  }
+}
+
+void default_multiplexer::dispatch_ready() {
+  // handlers that remain ready are dispatched again in the next
+  // iteration to not starve sockets that are waiting in epoll
+  m_dispatching.swap(m_ready);
+  for (auto ptr : m_dispatching) {
+    ptr->m_scheduled = false;
+  }
+  for (auto ptr : m_dispatching) {
+    auto mask = ptr->m_readiness & ptr->eventbf();
+    if (mask != 0) {
+      handle_socket_event(ptr->fd(), mask, ptr);
+      if (ptr->m_readiness & ptr->eventbf()) {
+        schedule(ptr);
+      }
+    }
+  }
+  m_dispatching.clear();
 }
 
 bool default_multiplexer::socket_had_rd_shutdown_event(native_socket fd) {
@@ -705,6 +863,16 @@ void default_multiplexer::init() {
 }
 
 default_multiplexer::~default_multiplexer() {
+  // waits for a pending name lookup, the runnable it dispatches
+  // with its result is deleted below
+  if (m_resolver.joinable()) {
+    { // lifetime scope of guard
+      std::lock_guard<std::mutex> guard{m_resolver_mtx};
+      m_resolver_done = true;
+    }
+    m_resolver_cv.notify_all();
+    m_resolver.join();
+  }
   if (m_epollfd != invalid_native_socket) {
     closesocket(m_epollfd);
   }
@@ -727,87 +895,141 @@ void default_multiplexer::dispatch_runnable(runnable_ptr ptr) {
   wr_dispatch_request(ptr.release());
 }
 
+#ifndef CAF_WINDOWS
+bool unlink_local_socket(const std::string& path,
+                         const local_socket_file& file);
+#endif // CAF_WINDOWS
+
+namespace {
+
+// manages a connection for a broker, works with any socket type of `stream`
+template <class Socket>
+class scribe_impl : public broker::scribe {
+ public:
+  scribe_impl(broker* ptr, Socket&& s)
+      : scribe(ptr, network::conn_hdl_from_socket(s)),
+        m_launched(false),
+        m_stream(s.backend()) {
+    m_stream.init(std::move(s));
+  }
+  void configure_read(receive_policy::config config) override {
+    CAF_LOG_TRACE("");
+    m_stream.configure_read(config);
+    if (!m_launched) launch();
+  }
+  broker::buffer_type& wr_buf() override {
+    return m_stream.wr_buf();
+  }
+  void write_watermarks(size_t low, size_t high) override {
+    m_stream.write_watermarks(low, high);
+  }
+  void pause_reading(bool paused) override {
+    CAF_LOG_TRACE(CAF_ARG(paused));
+    m_stream.pause_reading(paused);
+  }
+  broker::buffer_type& rd_buf() override {
+    return m_stream.rd_buf();
+  }
+  void stop_reading() override {
+    CAF_LOG_TRACE("");
+    m_stream.stop_reading();
+    disconnect(false);
+  }
+  void flush() override {
+    CAF_LOG_TRACE("");
+    m_stream.flush(this);
+  }
+  void launch() {
+    CAF_LOG_TRACE("");
+    CAF_REQUIRE(!m_launched);
+    m_launched = true;
+    m_stream.start(this);
+  }
+ private:
+  bool m_launched;
+  stream<Socket> m_stream;
+};
+
+template <class Socket>
+connection_handle add_stream_scribe(broker* self, Socket&& sock) {
+  broker::scribe_pointer ptr = make_counted<scribe_impl<Socket>>(
+                                 self, std::move(sock));
+  self->add_scribe(ptr);
+  return ptr->hdl();
+}
+
+// TCP acceptors release their port when closing the socket
+void release_address(default_socket_acceptor&) {
+  // nop
+}
+
+// removes the socket file of a Unix domain socket acceptor unless
+// another process has replaced it in the meantime
+void release_address(local_socket_acceptor& sock) {
+# ifndef CAF_WINDOWS
+    sockaddr_un sa;
+    socklen_t len = sizeof(sa);
+    if (getsockname(sock.fd(), reinterpret_cast<sockaddr*>(&sa), &len) == 0
+        && sa.sun_family == AF_UNIX && sa.sun_path[0] != '\0') {
+      unlink_local_socket(sa.sun_path, sock.file());
+    }
+# else
+    static_cast<void>(sock);
+# endif
+}
+
+// accepts connections for a broker, works with any socket type of `acceptor`
+template <class SocketAcceptor>
+class doorman_impl : public broker::doorman {
+ public:
+  doorman_impl(broker* ptr, SocketAcceptor&& s)
+      : doorman(ptr, network::accept_hdl_from_socket(s)),
+        m_acceptor(s.backend()) {
+    m_acceptor.init(std::move(s));
+  }
+  void new_connection() override {
+    CAF_LOG_TRACE("");
+    accept_msg().handle
+      = add_stream_scribe(parent(), std::move(m_acceptor.accepted_socket()));
+    parent()->invoke_message(invalid_actor_addr, invalid_message_id,
+                             m_accept_msg);
+  }
+  void stop_reading() override {
+    CAF_LOG_TRACE("");
+    release_address(m_acceptor.socket_handle());
+    m_acceptor.stop_reading();
+    disconnect(false);
+  }
+  void launch() override {
+    CAF_LOG_TRACE("");
+    m_acceptor.start(this);
+  }
+ private:
+  network::acceptor<SocketAcceptor> m_acceptor;
+};
+
+template <class SocketAcceptor>
+accept_handle add_stream_doorman(broker* self, SocketAcceptor&& sock) {
+  CAF_REQUIRE(sock.fd() != network::invalid_native_socket);
+  broker::doorman_pointer ptr = make_counted<doorman_impl<SocketAcceptor>>(
+                                  self, std::move(sock));
+  self->add_doorman(ptr);
+  return ptr->hdl();
+}
+
+} // namespace <anonymous>
+
 connection_handle default_multiplexer::add_tcp_scribe(broker* self,
                                                       default_socket&& sock) {
   CAF_LOG_TRACE("");
-  class impl : public broker::scribe {
-   public:
-    impl(broker* ptr, default_socket&& s)
-        : scribe(ptr, network::conn_hdl_from_socket(s)),
-          m_launched(false),
-          m_stream(s.backend()) {
-      m_stream.init(std::move(s));
-    }
-    void configure_read(receive_policy::config config) override {
-      CAF_LOG_TRACE("");
-      m_stream.configure_read(config);
-      if (!m_launched) launch();
-    }
-    broker::buffer_type& wr_buf() override {
-      return m_stream.wr_buf();
-    }
-    broker::buffer_type& rd_buf() override {
-      return m_stream.rd_buf();
-    }
-    void stop_reading() override {
-      CAF_LOG_TRACE("");
-      m_stream.stop_reading();
-      disconnect(false);
-    }
-    void flush() override {
-      CAF_LOG_TRACE("");
-      m_stream.flush(this);
-    }
-    void launch() {
-      CAF_LOG_TRACE("");
-      CAF_REQUIRE(!m_launched);
-      m_launched = true;
-      m_stream.start(this);
-    }
-   private:
-    bool m_launched;
-    stream<default_socket> m_stream;
-  };
-  broker::scribe_pointer ptr = make_counted<impl>(self, std::move(sock));
-  self->add_scribe(ptr);
-  return ptr->hdl();
+  return add_stream_scribe(self, std::move(sock));
 }
 
 accept_handle
 default_multiplexer::add_tcp_doorman(broker* self,
                                      default_socket_acceptor&& sock) {
   CAF_LOG_TRACE("sock.fd = " << sock.fd());
-  CAF_REQUIRE(sock.fd() != network::invalid_native_socket);
-  class impl : public broker::doorman {
-   public:
-    impl(broker* ptr, default_socket_acceptor&& s)
-        : doorman(ptr, network::accept_hdl_from_socket(s)),
-          m_acceptor(s.backend()) {
-      m_acceptor.init(std::move(s));
-    }
-    void new_connection() override {
-      CAF_LOG_TRACE("");
-      auto& dm = m_acceptor.backend();
-      accept_msg().handle
-        = dm.add_tcp_scribe(parent(), std::move(m_acceptor.accepted_socket()));
-      parent()->invoke_message(invalid_actor_addr, invalid_message_id,
-                               m_accept_msg);
-    }
-    void stop_reading() override {
-      CAF_LOG_TRACE("");
-      m_acceptor.stop_reading();
-      disconnect(false);
-    }
-    void launch() override {
-      CAF_LOG_TRACE("");
-      m_acceptor.start(this);
-    }
-   private:
-    network::acceptor<default_socket_acceptor> m_acceptor;
-  };
-  broker::doorman_pointer ptr = make_counted<impl>(self, std::move(sock));
-  self->add_doorman(ptr);
-  return ptr->hdl();
+  return add_stream_doorman(self, std::move(sock));
 }
 
 connection_handle default_multiplexer::new_tcp_scribe(const std::string& host,
@@ -838,8 +1060,8 @@ connection_handle default_multiplexer::add_tcp_scribe(broker* self,
 
 std::pair<accept_handle, uint16_t>
 default_multiplexer::new_tcp_doorman(uint16_t port, const char* in,
-                                     bool reuse_addr) {
-  auto res = new_tcp_acceptor_impl(port, in, reuse_addr);
+                                     bool reuse_addr, port_sharing sharing) {
+  auto res = new_tcp_acceptor_impl(port, in, reuse_addr, sharing);
   return {accept_handle::from_int(int64_from_native_socket(res.first)),
           res.second};
 }
@@ -861,6 +1083,146 @@ default_multiplexer::add_tcp_doorman(broker* self, uint16_t port,
   return {add_tcp_doorman(self, std::move(acceptor.first)), bound_port};
 }
 
+connection_handle
+default_multiplexer::new_local_scribe(const std::string& path) {
+  auto fd = new_local_connection_impl(path);
+  return connection_handle::from_int(int64_from_native_socket(fd));
+}
+
+void default_multiplexer::assign_local_scribe(broker* self,
+                                              connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(self) << ", " << CAF_MARG(hdl, id));
+  add_local_scribe(self, local_socket{*this,
+                                      static_cast<native_socket>(hdl.id())});
+}
+
+connection_handle default_multiplexer::add_local_scribe(broker* self,
+                                                        local_socket&& sock) {
+  CAF_LOG_TRACE("");
+  return add_stream_scribe(self, std::move(sock));
+}
+
+connection_handle
+default_multiplexer::add_local_scribe(broker* self, const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(self) << ", " << CAF_ARG(path));
+  return add_local_scribe(self, local_socket{*this,
+                                             new_local_connection_impl(path)});
+}
+
+accept_handle
+default_multiplexer::new_local_doorman(const std::string& path) {
+  auto res = new_local_acceptor_impl(path);
+  std::unique_lock<std::mutex> guard{m_local_files_mtx};
+  m_local_files[res.first] = res.second;
+  return accept_handle::from_int(int64_from_native_socket(res.first));
+}
+
+void default_multiplexer::assign_local_doorman(broker* self,
+                                               accept_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(self) << ", " << CAF_MARG(hdl, id));
+  auto fd = static_cast<native_socket>(hdl.id());
+  // an unknown file never matches, i.e., the doorman keeps its file
+  local_socket_file file{0, 0};
+  std::unique_lock<std::mutex> guard{m_local_files_mtx};
+  auto i = m_local_files.find(fd);
+  if (i != m_local_files.end()) {
+    file = i->second;
+    m_local_files.erase(i);
+  }
+  guard.unlock();
+  add_local_doorman(self, local_socket_acceptor{*this, fd, file});
+}
+
+accept_handle
+default_multiplexer::add_local_doorman(broker* self,
+                                       local_socket_acceptor&& sock) {
+  CAF_LOG_TRACE("sock.fd = " << sock.fd());
+  return add_stream_doorman(self, std::move(sock));
+}
+
+accept_handle
+default_multiplexer::add_local_doorman(broker* self, const std::string& path) {
+  CAF_LOG_TRACE(CAF_ARG(self) << ", " << CAF_ARG(path));
+  auto res = new_local_acceptor_impl(path);
+  return add_local_doorman(self, local_socket_acceptor{*this, res.first,
+                                                       res.second});
+}
+
+std::pair<datagram_handle, uint16_t>
+default_multiplexer::new_udp_datagram_servant(uint16_t port, const char* in,
+                                              bool reuse_addr) {
+  auto res = new_udp_socket_impl(port, in, reuse_addr);
+  return {datagram_handle::from_int(int64_from_native_socket(res.first)),
+          res.second};
+}
+
+void default_multiplexer::assign_udp_datagram_servant(broker* ptr,
+                                                      datagram_handle hdl) {
+  add_udp_datagram_servant(ptr, static_cast<native_socket>(hdl.id()));
+}
+
+datagram_handle default_multiplexer::add_udp_datagram_servant(broker* self,
+                                                              native_socket fd) {
+  CAF_LOG_TRACE(CAF_ARG(fd));
+  CAF_REQUIRE(fd != network::invalid_native_socket);
+  class impl : public broker::datagram_servant {
+   public:
+    impl(broker* ptr, default_multiplexer& dm, native_socket sockfd)
+        : datagram_servant(ptr, datagram_handle::from_int(
+                                  int64_from_native_socket(sockfd))),
+          m_launched(false),
+          m_handler(dm, sockfd) {
+      // nop
+    }
+    void max_datagram_size(size_t num_bytes) override {
+      m_handler.max_datagram_size(num_bytes);
+    }
+    void max_endpoints(size_t num_endpoints) override {
+      m_handler.max_endpoints(num_endpoints);
+    }
+    endpoint_handle add_endpoint(const std::string& host,
+                                 uint16_t port) override {
+      return m_handler.add_endpoint(host, port);
+    }
+    void release_endpoint(endpoint_handle ep) override {
+      m_handler.release_endpoint(ep);
+    }
+    void write(endpoint_handle ep, const void* buf,
+               size_t num_bytes) override {
+      m_handler.write(ep, buf, num_bytes);
+    }
+    void flush() override {
+      CAF_LOG_TRACE("");
+      m_handler.flush(this);
+    }
+    void stop_reading() override {
+      CAF_LOG_TRACE("");
+      m_handler.stop_reading();
+      disconnect(false);
+    }
+    void launch() override {
+      CAF_LOG_TRACE("");
+      CAF_REQUIRE(!m_launched);
+      m_launched = true;
+      m_handler.start(this);
+    }
+   private:
+    bool m_launched;
+    network::datagram_handler m_handler;
+  };
+  broker::datagram_servant_pointer ptr = make_counted<impl>(self, *this, fd);
+  self->add_datagram_servant(ptr);
+  return ptr->hdl();
+}
+
+std::pair<datagram_handle, uint16_t>
+default_multiplexer::add_udp_datagram_servant(broker* self, uint16_t port,
+                                              const char* in,
+                                              bool reuse_addr) {
+  auto res = new_udp_socket_impl(port, in, reuse_addr);
+  return {add_udp_datagram_servant(self, res.first), res.second};
+}
+
 /******************************************************************************
  *               platform-independent implementations (finally)               *
  ******************************************************************************/
@@ -915,7 +1277,11 @@ bool try_accept(native_socket& result, native_socket fd) {
   sockaddr addr;
   memset(&addr, 0, sizeof(addr));
   socklen_t addrlen = sizeof(addr);
-  result = ::accept(fd, &addr, &addrlen);
+# ifdef CAF_LINUX
+    result = ::accept4(fd, &addr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+# else
+    result = ::accept(fd, &addr, &addrlen);
+# endif
   CAF_LOGF_DEBUG("tried to accept a new connection from from socket "
                  << fd << ", accept returned " << result);
   if (result == invalid_native_socket) {
@@ -929,7 +1295,9 @@ bool try_accept(native_socket& result, native_socket fd) {
 
 event_handler::event_handler(default_multiplexer& dm)
     : m_backend(dm),
-      m_eventbf(0) {
+      m_eventbf(0),
+      m_readiness(0),
+      m_scheduled(false) {
   // nop
 }
 
@@ -937,14 +1305,26 @@ event_handler::~event_handler() {
   // nop
 }
 
+void event_handler::would_block(operation op) {
+  m_readiness = del_flag(op, m_readiness);
+}
+
 default_socket::default_socket(default_multiplexer& ref, native_socket sockfd)
+    : default_socket(ref, sockfd, true) {
+  // nop
+}
+
+default_socket::default_socket(default_multiplexer& ref, native_socket sockfd,
+                               bool tcp_socket)
     : m_parent(ref),
       m_fd(sockfd) {
-  CAF_LOG_TRACE(CAF_ARG(sockfd));
+  CAF_LOG_TRACE(CAF_ARG(sockfd) << ", " << CAF_ARG(tcp_socket));
   if (sockfd != invalid_native_socket) {
     // enable nonblocking IO & disable Nagle's algorithm
     nonblocking(m_fd, true);
-    tcp_nodelay(m_fd, true);
+    if (tcp_socket) {
+      tcp_nodelay(m_fd, true);
+    }
   }
 }
 
@@ -972,6 +1352,19 @@ void default_socket::close_read() {
   }
 }
 
+local_socket::local_socket(default_multiplexer& ref, native_socket sockfd)
+    : default_socket(ref, sockfd, false) {
+  // nop
+}
+
+local_socket_acceptor::local_socket_acceptor(default_multiplexer& ref,
+                                             native_socket sockfd,
+                                             local_socket_file file)
+    : local_socket(ref, sockfd),
+      m_file(file) {
+  // nop
+}
+
 class socket_guard {
  public:
   socket_guard(native_socket fd) : m_fd(fd) {
@@ -1095,60 +1488,516 @@ default_socket new_tcp_connection(const std::string& host, uint16_t port) {
   return default_socket{backend, new_tcp_connection_impl(host, port)};
 }
 
-template <class SockAddrType>
-void read_port(native_socket fd, SockAddrType& sa) {
-  socklen_t len = sizeof(SockAddrType);
-  ccall(cc_zero, "read_port failed", getsockname, fd,
-        reinterpret_cast<sockaddr*>(&sa), &len);
-}
+#ifndef CAF_WINDOWS
 
-void set_inaddr_any(native_socket, sockaddr_in& sa) {
-  sa.sin_addr.s_addr = INADDR_ANY;
+sockaddr_un local_address(const std::string& path) {
+  sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  if (path.empty() || path.size() >= sizeof(sa.sun_path)) {
+    throw network_error("invalid Unix domain socket path: " + path);
+  }
+  sa.sun_family = AF_UNIX;
+  memcpy(sa.sun_path, path.c_str(), path.size());
+  return sa;
 }
 
-void set_inaddr_any(native_socket fd, sockaddr_in6& sa) {
-  sa.sin6_addr = in6addr_any;
-  // also accept ipv4 requests on this socket
-  int off = 0;
-  ccall(cc_zero, "unable to unset IPV6_V6ONLY", setsockopt, fd, IPPROTO_IPV6,
-        IPV6_V6ONLY, reinterpret_cast<setsockopt_ptr>(&off),
-        socklen_t{sizeof(off)});
+// stores the socket file at `path` in `result`, returns
+// false if `path` does not exist or is no socket file
+bool local_socket_file_at(const std::string& path, local_socket_file& result) {
+  struct stat st;
+  if (lstat(path.c_str(), &st) != 0 || !S_ISSOCK(st.st_mode)) {
+    return false;
+  }
+  result.dev = static_cast<uint64_t>(st.st_dev);
+  result.ino = static_cast<uint64_t>(st.st_ino);
+  return true;
 }
 
-template <int Family>
-uint16_t new_ip_acceptor_impl(native_socket fd, uint16_t port,
-                              const char* addr) {
-  static_assert(Family == AF_INET || Family == AF_INET6, "invalid family");
-  CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
-# ifdef CAF_WINDOWS
-    // make sure TCP has been initialized via WSAStartup
-    get_multiplexer_singleton();
-# endif
-  using sockaddr_type =
-    typename std::conditional<
-      Family == AF_INET,
-      sockaddr_in,
-      sockaddr_in6
-    >::type;
-  sockaddr_type sa;
-  memset(&sa, 0, sizeof(sockaddr_type));
-  family_of(sa) = Family;
-  if (!addr) {
-    set_inaddr_any(fd, sa);
-  } else {
-    ccall(cc_one, "invalid IP address", inet_pton, Family, addr, &addr_of(sa));
+// removes the socket file at `path` if it still is `file`
+bool unlink_local_socket(const std::string& path,
+                         const local_socket_file& file) {
+  local_socket_file x;
+  if (!local_socket_file_at(path, x)
+      || x.dev != file.dev || x.ino != file.ino) {
+    CAF_LOGF_DEBUG("keep replaced socket file " << path);
+    return false;
   }
-  port_of(sa) = htons(port);
-  ccall(cc_zero, "cannot bind socket", bind, fd,
-        reinterpret_cast<sockaddr*>(&sa), socklen_t{sizeof(sa)});
-  read_port(fd, sa);
-  return ntohs(port_of(sa));
+  CAF_LOGF_DEBUG("unlink " << path);
+  return unlink(path.c_str()) == 0;
 }
 
-std::pair<native_socket, uint16_t>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
-  CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
-# ifdef CAF_WINDOWS
+// checks whether `path` is a socket file without a listening
+// socket and stores the socket file in `file` if so
+bool is_stale_local_socket(const std::string& path, const sockaddr_un& sa,
+                           local_socket_file& file) {
+  if (!local_socket_file_at(path, file)) {
+    return false;
+  }
+  auto fd = ccall(cc_valid_socket, "socket creation failed", socket,
+                  AF_UNIX, SOCK_STREAM, 0);
+  socket_guard sguard(fd);
+  return connect(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0
+         && last_socket_error() == ECONNREFUSED;
+}
+
+#endif // CAF_WINDOWS
+
+namespace {
+
+// delay between two connection attempts as recommended by RFC 8305
+constexpr std::chrono::milliseconds connection_attempt_delay{250};
+
+bool connect_in_progress(int errcode) {
+# ifdef CAF_WINDOWS
+    return errcode == WSAEWOULDBLOCK || errcode == WSAEINPROGRESS;
+# else
+    return errcode == EINPROGRESS;
+# endif
+}
+
+std::string socket_error_as_string(int errcode) {
+# ifdef CAF_WINDOWS
+    return "error code " + std::to_string(errcode);
+# else
+    return strerror(errcode);
+# endif
+}
+
+struct resolved_address {
+  sockaddr_storage addr;
+  socklen_t len;
+};
+
+// resolves `host` and orders the results by alternating between IPv6
+// and IPv4 addresses, starting with IPv6; passing `AI_NUMERICHOST` as
+// `flags` accepts only IP addresses, i.e., never performs a name lookup
+std::vector<resolved_address> resolve(const std::string& host,
+                                      uint16_t port, int flags = 0) {
+  addrinfo hint;
+  memset(&hint, 0, sizeof(hint));
+  hint.ai_socktype = SOCK_STREAM;
+  hint.ai_flags = flags;
+  addrinfo* tmp = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hint, &tmp) != 0) {
+    return {};
+  }
+  std::unique_ptr<addrinfo, decltype(freeaddrinfo)*> addrs{tmp, freeaddrinfo};
+  std::vector<resolved_address> v4;
+  std::vector<resolved_address> v6;
+  for (auto i = addrs.get(); i != nullptr; i = i->ai_next) {
+    if (i->ai_family != AF_INET && i->ai_family != AF_INET6) {
+      continue;
+    }
+    resolved_address x;
+    memset(&x.addr, 0, sizeof(x.addr));
+    memcpy(&x.addr, i->ai_addr, i->ai_addrlen);
+    x.len = static_cast<socklen_t>(i->ai_addrlen);
+    port_of(reinterpret_cast<sockaddr&>(x.addr)) = htons(port);
+    (i->ai_family == AF_INET ? v4 : v6).push_back(x);
+  }
+  std::vector<resolved_address> result;
+  for (size_t i = 0; i < std::max(v4.size(), v6.size()); ++i) {
+    if (i < v6.size()) {
+      result.push_back(v6[i]);
+    }
+    if (i < v4.size()) {
+      result.push_back(v4[i]);
+    }
+  }
+  return result;
+}
+
+class connect_attempt;
+
+// manages all connection attempts for a single `new_tcp_scribe`
+// or `new_local_scribe` request, `target` describes the remote
+// endpoint in log and error messages
+class connector : public std::enable_shared_from_this<connector> {
+ public:
+  using connect_handler = multiplexer::connect_handler;
+
+  connector(default_multiplexer& dm, std::string target,
+            std::vector<resolved_address> addrs, connect_handler f)
+      : m_backend(dm),
+        m_target(std::move(target)),
+        m_addrs(std::move(addrs)),
+        m_next_addr(0),
+        m_f(std::move(f)),
+        m_done(false),
+        m_has_timeout(false),
+        m_has_delay(false) {
+    // nop
+  }
+
+  // starts connecting unless `addrs` was empty, in which case
+  // the connector waits for a call to `resolved`
+  void start(std::chrono::milliseconds timeout) {
+    auto self = shared_from_this();
+    m_timeout = m_backend.add_timer(default_multiplexer::timer_clock::now()
+                                    + timeout, [self] {
+      self->m_has_timeout = false;
+      self->fail("connection to " + self->m_target + " timed out");
+    });
+    m_has_timeout = true;
+    if (!m_addrs.empty()) {
+      next();
+    }
+  }
+
+  // called with the result of the name lookup for `m_target`
+  void resolved(std::vector<resolved_address> addrs) {
+    if (m_done) {
+      // timed out while resolving
+      return;
+    }
+    m_addrs = std::move(addrs);
+    next();
+  }
+
+  // starts connection attempts until one is in flight
+  void next();
+
+  // called by an attempt that established a connection
+  void connected(connect_attempt* ptr, native_socket fd);
+
+  // called by an attempt that could not establish a connection
+  void failed(connect_attempt* ptr, std::string reason);
+
+  void fail(std::string reason);
+
+ private:
+  void finalize();
+
+  default_multiplexer& m_backend;
+  std::string m_target;
+  std::vector<resolved_address> m_addrs;
+  size_t m_next_addr;
+  connect_handler m_f;
+  bool m_done;
+  std::string m_last_error;
+  std::vector<connect_attempt*> m_attempts;
+  bool m_has_timeout;
+  default_multiplexer::timer_map::iterator m_timeout;
+  bool m_has_delay;
+  default_multiplexer::timer_map::iterator m_delay;
+};
+
+// waits for a single non-blocking connect() to complete
+class connect_attempt : public event_handler {
+ public:
+  connect_attempt(default_multiplexer& dm, native_socket fd,
+                  std::shared_ptr<connector> parent)
+      : event_handler(dm),
+        m_fd(fd),
+        m_parent(std::move(parent)) {
+    // nop
+  }
+
+  ~connect_attempt() {
+    if (m_fd != invalid_native_socket) {
+      closesocket(m_fd);
+    }
+  }
+
+  void handle_event(operation op) override {
+    if (!m_parent) {
+      // already aborted
+      return;
+    }
+    auto parent = std::move(m_parent);
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (op == operation::propagate_error
+        || getsockopt(m_fd, SOL_SOCKET, SO_ERROR,
+                      reinterpret_cast<socket_recv_ptr>(&err), &len) != 0) {
+      err = last_socket_error();
+    }
+    m_backend.del(operation::write, m_fd, this);
+    if (op == operation::write && err == 0) {
+      auto fd = m_fd;
+      m_fd = invalid_native_socket;
+      parent->connected(this, fd);
+    } else {
+      parent->failed(this, socket_error_as_string(err));
+    }
+  }
+
+  void removed_from_loop(operation op) override {
+    if (op == operation::write) {
+      delete this;
+    }
+  }
+
+  native_socket fd() const override {
+    return m_fd;
+  }
+
+  // stops this attempt and closes its socket
+  void abort() {
+    m_parent.reset();
+    if (eventbf() == 0) {
+      // never made it into the event loop; our del() only
+      // cancels the pending add(), i.e., we won't receive a
+      // removed_from_loop() callback
+      m_backend.del(operation::write, m_fd, this);
+      delete this;
+      return;
+    }
+    m_backend.del(operation::write, m_fd, this);
+  }
+
+ private:
+  native_socket m_fd;
+  std::shared_ptr<connector> m_parent;
+};
+
+void connector::next() {
+  CAF_LOGF_TRACE(CAF_ARG(m_target));
+  while (!m_done && m_next_addr < m_addrs.size()) {
+    auto& x = m_addrs[m_next_addr++];
+    auto sa = reinterpret_cast<const sockaddr*>(&x.addr);
+    auto fd = socket(sa->sa_family, SOCK_STREAM, 0);
+    if (fd == invalid_native_socket) {
+      m_last_error = last_socket_error_as_string();
+      continue;
+    }
+    socket_guard sguard{fd};
+    try {
+      nonblocking(fd, true);
+    }
+    catch (network_error& err) {
+      m_last_error = err.what();
+      continue;
+    }
+    if (connect(fd, sa, x.len) != 0
+        && !connect_in_progress(last_socket_error())) {
+      m_last_error = last_socket_error_as_string();
+      continue;
+    }
+    // even if connect() succeeded immediately, we report
+    // the result asynchronously via the event loop
+    auto ptr = new connect_attempt(m_backend, sguard.release(),
+                                   shared_from_this());
+    m_attempts.push_back(ptr);
+    m_backend.add(operation::write, ptr->fd(), ptr);
+    if (m_next_addr < m_addrs.size()) {
+      // give this attempt a head start before trying the next address
+      auto self = shared_from_this();
+      m_delay = m_backend.add_timer(default_multiplexer::timer_clock::now()
+                                    + connection_attempt_delay, [self] {
+        self->m_has_delay = false;
+        self->next();
+      });
+      m_has_delay = true;
+    }
+    return;
+  }
+  if (!m_done && m_attempts.empty()) {
+    fail("could not connect to " + m_target + ": "
+         + (m_last_error.empty() ? "no such host" : m_last_error));
+  }
+}
+
+void connector::connected(connect_attempt* ptr, native_socket fd) {
+  CAF_LOGF_TRACE(CAF_ARG(fd));
+  m_attempts.erase(std::find(m_attempts.begin(), m_attempts.end(), ptr));
+  finalize();
+  CAF_LOGF_INFO("successfully connected to " << m_target);
+  m_f(connection_handle::from_int(int64_from_native_socket(fd)),
+      std::string{});
+}
+
+void connector::failed(connect_attempt* ptr, std::string reason) {
+  CAF_LOGF_TRACE(CAF_ARG(reason));
+  m_attempts.erase(std::find(m_attempts.begin(), m_attempts.end(), ptr));
+  m_last_error = std::move(reason);
+  // happy eyeballs: start the next attempt right away on failure
+  if (m_has_delay) {
+    m_has_delay = false;
+    m_backend.cancel_timer(m_delay);
+  }
+  next();
+}
+
+void connector::fail(std::string reason) {
+  if (m_done) {
+    return;
+  }
+  finalize();
+  CAF_LOGF_INFO(reason);
+  m_f(connection_handle{}, "network_error: " + reason);
+}
+
+void connector::finalize() {
+  m_done = true;
+  if (m_has_timeout) {
+    m_has_timeout = false;
+    m_backend.cancel_timer(m_timeout);
+  }
+  if (m_has_delay) {
+    m_has_delay = false;
+    m_backend.cancel_timer(m_delay);
+  }
+  // keep ourselves alive while aborting the remaining attempts
+  auto self = shared_from_this();
+  auto attempts = std::move(m_attempts);
+  m_attempts.clear();
+  for (auto ptr : attempts) {
+    ptr->abort();
+  }
+}
+
+} // namespace <anonymous>
+
+void default_multiplexer::new_tcp_scribe(const std::string& host,
+                                         uint16_t port,
+                                         std::chrono::milliseconds timeout,
+                                         connect_handler f) {
+  CAF_LOG_TRACE(CAF_ARG(host) << ", " << CAF_ARG(port));
+  // IP addresses resolve without any name lookup, whereas host names are
+  // resolved by the resolver thread in order to never block the caller
+  auto addrs = resolve(host, port, AI_NUMERICHOST);
+  auto lookup = addrs.empty();
+  dispatch([=]() mutable {
+    auto target = host + " on port " + std::to_string(port);
+    auto ptr = std::make_shared<connector>(*this, std::move(target),
+                                           std::move(addrs), std::move(f));
+    ptr->start(timeout);
+    if (lookup) {
+      run_resolver_job([=] {
+        auto res = resolve(host, port);
+        dispatch([=]() mutable {
+          ptr->resolved(std::move(res));
+        });
+      });
+    }
+  });
+}
+
+void default_multiplexer::run_resolver_job(std::function<void ()> f) {
+  std::lock_guard<std::mutex> guard{m_resolver_mtx};
+  m_resolver_jobs.push_back(std::move(f));
+  if (m_resolver.joinable()) {
+    m_resolver_cv.notify_one();
+    return;
+  }
+  m_resolver = std::thread([this] {
+    std::unique_lock<std::mutex> guard{m_resolver_mtx};
+    for (;;) {
+      m_resolver_cv.wait(guard, [this] {
+        return m_resolver_done || !m_resolver_jobs.empty();
+      });
+      if (m_resolver_done) {
+        // the multiplexer discards all further results anyway
+        return;
+      }
+      auto job = std::move(m_resolver_jobs.front());
+      m_resolver_jobs.pop_front();
+      guard.unlock();
+      job();
+      // destroy captured state before acquiring the lock again
+      job = nullptr;
+      guard.lock();
+    }
+  });
+}
+
+void default_multiplexer::new_local_scribe(const std::string& path,
+                                           std::chrono::milliseconds timeout,
+                                           connect_handler f) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+# ifdef CAF_WINDOWS
+    static_cast<void>(timeout);
+    f(connection_handle{},
+      "network_error: Unix domain sockets are not supported on Windows");
+# else
+    std::vector<resolved_address> addrs(1);
+    try {
+      auto sa = local_address(path);
+      memset(&addrs.front().addr, 0, sizeof(sockaddr_storage));
+      memcpy(&addrs.front().addr, &sa, sizeof(sa));
+      addrs.front().len = sizeof(sa);
+    }
+    catch (network_error& err) {
+      f(connection_handle{}, std::string("network_error: ") + err.what());
+      return;
+    }
+    dispatch([=]() mutable {
+      auto ptr = std::make_shared<connector>(*this, path, std::move(addrs),
+                                             std::move(f));
+      ptr->start(timeout);
+    });
+# endif
+}
+
+template <class SockAddrType>
+void read_port(native_socket fd, SockAddrType& sa) {
+  socklen_t len = sizeof(SockAddrType);
+  ccall(cc_zero, "read_port failed", getsockname, fd,
+        reinterpret_cast<sockaddr*>(&sa), &len);
+}
+
+void set_inaddr_any(native_socket, sockaddr_in& sa) {
+  sa.sin_addr.s_addr = INADDR_ANY;
+}
+
+void set_inaddr_any(native_socket fd, sockaddr_in6& sa) {
+  sa.sin6_addr = in6addr_any;
+  // also accept ipv4 requests on this socket
+  int off = 0;
+  ccall(cc_zero, "unable to unset IPV6_V6ONLY", setsockopt, fd, IPPROTO_IPV6,
+        IPV6_V6ONLY, reinterpret_cast<setsockopt_ptr>(&off),
+        socklen_t{sizeof(off)});
+}
+
+template <int Family>
+uint16_t new_ip_acceptor_impl(native_socket fd, uint16_t port,
+                              const char* addr) {
+  static_assert(Family == AF_INET || Family == AF_INET6, "invalid family");
+  CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
+# ifdef CAF_WINDOWS
+    // make sure TCP has been initialized via WSAStartup
+    get_multiplexer_singleton();
+# endif
+  using sockaddr_type =
+    typename std::conditional<
+      Family == AF_INET,
+      sockaddr_in,
+      sockaddr_in6
+    >::type;
+  sockaddr_type sa;
+  memset(&sa, 0, sizeof(sockaddr_type));
+  family_of(sa) = Family;
+  if (!addr) {
+    set_inaddr_any(fd, sa);
+  } else {
+    ccall(cc_one, "invalid IP address", inet_pton, Family, addr, &addr_of(sa));
+  }
+  port_of(sa) = htons(port);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&sa), socklen_t{sizeof(sa)}) != 0) {
+    // callers distinguish ports in use from other errors
+#   ifdef CAF_WINDOWS
+      auto in_use = last_socket_error() == WSAEADDRINUSE;
+#   else
+      auto in_use = last_socket_error() == EADDRINUSE;
+#   endif
+    std::ostringstream oss;
+    oss << "cannot bind socket: " << last_socket_error_as_string()
+        << " [errno: " << last_socket_error() << "]";
+    if (in_use) {
+      throw bind_failure(oss.str());
+    }
+    throw network_error(oss.str());
+  }
+  read_port(fd, sa);
+  return ntohs(port_of(sa));
+}
+
+std::pair<native_socket, uint16_t>
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      port_sharing sharing) {
+  CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
+# ifdef CAF_WINDOWS
     // make sure TCP has been initialized via WSAStartup
     get_multiplexer_singleton();
 # endif
@@ -1173,14 +2022,128 @@ new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
           SO_REUSEADDR, reinterpret_cast<setsockopt_ptr>(&on),
           socklen_t{sizeof(on)});
   }
+  // an owner enables SO_REUSEPORT only after binding, because setting it
+  // before would silently share a port some other socket already uses
+  auto enable_reuse_port = [&] {
+#   ifdef SO_REUSEPORT
+      int on = 1;
+      ccall(cc_zero, "unable to set SO_REUSEPORT", setsockopt, fd, SOL_SOCKET,
+            SO_REUSEPORT, reinterpret_cast<setsockopt_ptr>(&on),
+            socklen_t{sizeof(on)});
+#   else
+      throw network_error("SO_REUSEPORT is not supported on this platform");
+#   endif
+  };
+  if (sharing == port_sharing::sibling) {
+    enable_reuse_port();
+  }
   auto p = proto == ipv4 ? new_ip_acceptor_impl<AF_INET>(fd, port, addr)
                          : new_ip_acceptor_impl<AF_INET6>(fd, port, addr);
+  if (sharing == port_sharing::owner) {
+    enable_reuse_port();
+  }
   ccall(cc_zero, "listen() failed", listen, fd, SOMAXCONN);
   // ok, no exceptions so far
   CAF_LOGF_DEBUG("sockfd = " << fd << ", port = " << p);
   return {sguard.release(), p};
 }
 
+std::pair<native_socket, uint16_t>
+new_udp_socket_impl(uint16_t port, const char* addr, bool reuse_addr) {
+  CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
+# ifdef CAF_WINDOWS
+    // make sure the network has been initialized via WSAStartup
+    get_multiplexer_singleton();
+# endif
+  protocol proto = ipv6;
+  if (addr) {
+    auto addrs = interfaces::native_address(addr);
+    if (!addrs) {
+      std::string errmsg = "invalid IP address: ";
+      errmsg += addr;
+      throw network_error(errmsg);
+    }
+    proto = addrs->second;
+    CAF_REQUIRE(proto == ipv4 || proto == ipv6);
+  }
+  auto fd = ccall(cc_valid_socket, "could not create datagram socket", socket,
+                  proto == ipv4 ? AF_INET : AF_INET6, SOCK_DGRAM, 0);
+  // sguard closes the socket in case of exception
+  socket_guard sguard(fd);
+  if (reuse_addr) {
+    int on = 1;
+    ccall(cc_zero, "unable to set SO_REUSEADDR", setsockopt, fd, SOL_SOCKET,
+          SO_REUSEADDR, reinterpret_cast<setsockopt_ptr>(&on),
+          socklen_t{sizeof(on)});
+  }
+  auto p = proto == ipv4 ? new_ip_acceptor_impl<AF_INET>(fd, port, addr)
+                         : new_ip_acceptor_impl<AF_INET6>(fd, port, addr);
+  CAF_LOGF_DEBUG("sockfd = " << fd << ", port = " << p);
+  return {sguard.release(), p};
+}
+
+native_socket new_local_connection_impl(const std::string& path) {
+  CAF_LOGF_TRACE(CAF_ARG(path));
+# ifdef CAF_WINDOWS
+    throw network_error("Unix domain sockets are not supported on Windows");
+# else
+    auto sa = local_address(path);
+    auto fd = ccall(cc_valid_socket, "socket creation failed", socket,
+                    AF_UNIX, SOCK_STREAM, 0);
+    socket_guard sguard(fd);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+      CAF_LOGF_INFO("could not connect to " << path << ": "
+                    << last_socket_error_as_string());
+      throw network_error("could not connect to " + path + ": "
+                          + last_socket_error_as_string());
+    }
+    return sguard.release();
+# endif
+}
+
+std::pair<native_socket, local_socket_file>
+new_local_acceptor_impl(const std::string& path) {
+  CAF_LOGF_TRACE(CAF_ARG(path));
+# ifdef CAF_WINDOWS
+    throw network_error("Unix domain sockets are not supported on Windows");
+# else
+    auto sa = local_address(path);
+    auto fd = ccall(cc_valid_socket, "could not create server socket", socket,
+                    AF_UNIX, SOCK_STREAM, 0);
+    // sguard closes the socket in case of exception
+    socket_guard sguard(fd);
+    auto do_bind = [&] {
+      return bind(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+    };
+    if (do_bind() != 0) {
+      if (last_socket_error() != EADDRINUSE) {
+        throw network_error("cannot bind socket to " + path + ": "
+                            + last_socket_error_as_string());
+      }
+      // a terminated process might have left its socket file behind,
+      // which we must not confuse with a file another process
+      // creates after our check
+      local_socket_file stale;
+      if (!is_stale_local_socket(path, sa, stale)
+          || !unlink_local_socket(path, stale)) {
+        throw bind_failure(path + " is in use");
+      }
+      CAF_LOGF_INFO("replaced stale socket file " << path);
+      if (do_bind() != 0) {
+        // another process bound `path` after we removed the stale file
+        throw bind_failure(path + " is in use");
+      }
+    }
+    local_socket_file file;
+    if (!local_socket_file_at(path, file)) {
+      throw network_error("cannot stat socket file " + path);
+    }
+    ccall(cc_zero, "listen() failed", listen, fd, SOMAXCONN);
+    CAF_LOGF_DEBUG("sockfd = " << fd << ", path = " << path);
+    return {sguard.release(), file};
+# endif
+}
+
 std::pair<default_socket_acceptor, uint16_t>
 new_tcp_acceptor(uint16_t port, const char* addr, bool reuse) {
   CAF_LOGF_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr")
@@ -1193,6 +2156,406 @@ new_tcp_acceptor(uint16_t port, const char* addr, bool reuse) {
                                   bound_port};
 }
 
+constexpr size_t datagram_handler::max_batch_size;
+
+constexpr size_t datagram_handler::max_batches_per_event;
+
+constexpr size_t datagram_handler::default_max_datagram_size;
+
+constexpr size_t datagram_handler::default_max_endpoints;
+
+datagram_handler::datagram_handler(default_multiplexer& backend_ref,
+                                   native_socket sockfd)
+    : event_handler(backend_ref),
+      m_fd(invalid_native_socket),
+      m_family(AF_INET6),
+      m_next_endpoint(0),
+      m_max_endpoints(default_max_endpoints),
+      m_reading(false),
+      m_max_size(default_max_datagram_size),
+      m_rd_queue(max_batch_size),
+      m_writing(false),
+      m_wr_sent(0) {
+  CAF_LOG_TRACE(CAF_ARG(sockfd));
+  // sguard closes the socket in case of exception
+  socket_guard sguard(sockfd);
+  nonblocking(sockfd, true);
+  sockaddr_storage sa;
+  socklen_t len = sizeof(sa);
+  ccall(cc_zero, "getsockname failed", getsockname, sockfd,
+        reinterpret_cast<sockaddr*>(&sa), &len);
+  m_family = sa.ss_family;
+  m_fd = sguard.release();
+}
+
+datagram_handler::~datagram_handler() {
+  if (m_fd != invalid_native_socket) {
+    CAF_LOG_DEBUG("close socket " << m_fd);
+    closesocket(m_fd);
+  }
+}
+
+void datagram_handler::start(const manager_ptr& mgr) {
+  CAF_LOG_TRACE(CAF_ARG(m_fd));
+  CAF_REQUIRE(mgr != nullptr);
+  m_reader = mgr;
+  m_reading = true;
+  backend().add(operation::read, m_fd, this);
+}
+
+void datagram_handler::max_datagram_size(size_t num_bytes) {
+  m_max_size = num_bytes;
+}
+
+void datagram_handler::max_endpoints(size_t num_endpoints) {
+  m_max_endpoints = num_endpoints;
+  evict_endpoints();
+}
+
+endpoint_handle datagram_handler::add_endpoint(const std::string& host,
+                                               uint16_t port) {
+  CAF_LOG_TRACE(CAF_ARG(host) << ", " << CAF_ARG(port));
+  optional<protocol> preferred;
+  if (m_family == AF_INET) {
+    preferred = ipv4;
+  }
+  auto res = interfaces::native_address(host, preferred);
+  if (!res) {
+    throw network_error("no such host: " + host);
+  }
+  endpoint x;
+  memset(&x, 0, sizeof(endpoint));
+  if (m_family == AF_INET) {
+    auto& sa = reinterpret_cast<sockaddr_in&>(x.addr);
+    family_of(sa) = AF_INET;
+    ccall(cc_one, "invalid IP address", inet_pton, AF_INET,
+          res->first.c_str(), &addr_of(sa));
+    port_of(sa) = htons(port);
+    x.len = sizeof(sockaddr_in);
+  } else {
+    auto& sa = reinterpret_cast<sockaddr_in6&>(x.addr);
+    // IPv6 sockets reach IPv4 hosts via IPv4-mapped addresses
+    auto addr = res->second == ipv4 ? "::ffff:" + res->first : res->first;
+    family_of(sa) = AF_INET6;
+    ccall(cc_one, "invalid IP address", inet_pton, AF_INET6,
+          addr.c_str(), &addr_of(sa));
+    port_of(sa) = htons(port);
+#   ifdef SIN6_LEN
+      sa.sin6_len = sizeof(sockaddr_in6);
+#   endif
+    x.len = sizeof(sockaddr_in6);
+  }
+  return endpoint_of(x, true);
+}
+
+void datagram_handler::release_endpoint(endpoint_handle ep) {
+  CAF_LOG_TRACE(CAF_MARG(ep, id));
+  auto i = m_endpoints.find(ep.id());
+  if (i == m_endpoints.end()) {
+    return;
+  }
+  if (!i->second.pinned) {
+    m_lru.erase(i->second.lru_pos);
+  }
+  m_ids.erase(i->second.addr);
+  m_endpoints.erase(i);
+}
+
+void datagram_handler::write(endpoint_handle ep, const void* buf,
+                             size_t num_bytes) {
+  CAF_LOG_TRACE(CAF_MARG(ep, id) << ", " << CAF_ARG(num_bytes));
+  if (ep.id() < 0 || ep.id() >= m_next_endpoint) {
+    throw std::invalid_argument("invalid endpoint handle");
+  }
+  auto i = m_endpoints.find(ep.id());
+  if (i == m_endpoints.end()) {
+    CAF_LOG_DEBUG("drop datagram for released or evicted endpoint");
+    return;
+  }
+  touch(i->second);
+  if (m_wr_buf.capacity() == 0) {
+    m_wr_buf = backend().buffers().take(num_bytes);
+  }
+  auto first = reinterpret_cast<const char*>(buf);
+  m_wr_queue.push_back(outgoing{i->second.addr, m_wr_buf.size(), num_bytes});
+  m_wr_buf.insert(m_wr_buf.end(), first, first + num_bytes);
+}
+
+void datagram_handler::flush(const manager_ptr& mgr) {
+  CAF_LOG_TRACE("queued datagrams: " << (m_wr_queue.size() - m_wr_sent));
+  CAF_REQUIRE(mgr != nullptr);
+  // datagram sockets are usually ready for writing, hence we
+  // only register for write events if the socket would block
+  if (m_writing || write_loop()) {
+    return;
+  }
+  backend().add(operation::write, m_fd, this);
+  m_writer = mgr;
+  m_writing = true;
+}
+
+void datagram_handler::stop_reading() {
+  CAF_LOG_TRACE("");
+  m_reading = false;
+  backend().del(operation::read, m_fd, this);
+}
+
+void datagram_handler::handle_event(operation op) {
+  CAF_LOG_TRACE("op = " << static_cast<int>(op));
+  switch (op) {
+    case operation::read: {
+      // the manager might stop reading from within `consume`
+      for (size_t i = 0; i < max_batches_per_event && m_reading; ++i) {
+        size_t num;
+        if (!read_batch(num)) {
+          m_reader->io_failure(operation::read);
+          backend().del(operation::read, m_fd, this);
+          return;
+        }
+        auto max_size = m_max_size;
+        for (size_t j = 0; j < num && m_reading; ++j) {
+          auto& x = m_rd_queue[j];
+          if (x.size > max_size) {
+            CAF_LOG_DEBUG("drop datagram exceeding " << max_size << " bytes");
+            continue;
+          }
+          auto first = m_rd_buf.data() + j * (max_size + 1);
+          m_rd_dgram.assign(first, first + x.size);
+          m_reader->consume(endpoint_of(x.from, false), m_rd_dgram);
+        }
+        if (num < max_batch_size) {
+          // a short batch drained the socket
+          would_block(operation::read);
+          break;
+        }
+      }
+      // send all datagrams the manager enqueued while processing the batch
+      if (!m_writing && m_wr_sent < m_wr_queue.size()) {
+        flush(m_reader);
+      }
+      break;
+    }
+    case operation::write:
+      if (write_loop()) {
+        m_writing = false;
+        backend().del(operation::write, m_fd, this);
+      }
+      break;
+    case operation::propagate_error:
+      if (m_reader) {
+        m_reader->io_failure(operation::read);
+      }
+      if (m_writer) {
+        m_writer->io_failure(operation::write);
+      }
+      // backend will delete this handler anyway,
+      // no need to call backend().del() here
+      break;
+  }
+}
+
+void datagram_handler::removed_from_loop(operation op) {
+  switch (op) {
+    case operation::read:
+      backend().buffers().release(m_rd_buf);
+      backend().buffers().release(m_rd_dgram);
+      // releasing the reader might destroy this handler
+      m_reader.reset();
+      break;
+    case operation::write: m_writer.reset(); break;
+    case operation::propagate_error: break;
+  }
+}
+
+native_socket datagram_handler::fd() const {
+  return m_fd;
+}
+
+size_t datagram_handler::endpoint_hash::operator()(const endpoint& x) const {
+  // FNV-1a
+  auto bytes = reinterpret_cast<const unsigned char*>(&x.addr);
+  size_t result = 2166136261u;
+  for (socklen_t i = 0; i < x.len; ++i) {
+    result = (result ^ bytes[i]) * 16777619u;
+  }
+  return result;
+}
+
+bool datagram_handler::endpoint_equal::operator()(const endpoint& x,
+                                                  const endpoint& y) const {
+  return x.len == y.len && memcmp(&x.addr, &y.addr, x.len) == 0;
+}
+
+endpoint_handle datagram_handler::endpoint_of(const endpoint& x, bool pin) {
+  auto i = m_ids.find(x);
+  if (i != m_ids.end()) {
+    auto& entry = m_endpoints[i->second];
+    if (pin && !entry.pinned) {
+      m_lru.erase(entry.lru_pos);
+      entry.pinned = true;
+    } else {
+      touch(entry);
+    }
+    return endpoint_handle::from_int(i->second);
+  }
+  auto id = m_next_endpoint++;
+  auto& entry = m_endpoints[id];
+  entry.addr = x;
+  entry.pinned = pin;
+  m_ids.emplace(x, id);
+  if (!pin) {
+    entry.lru_pos = m_lru.insert(m_lru.begin(), id);
+    evict_endpoints();
+  }
+  return endpoint_handle::from_int(id);
+}
+
+void datagram_handler::touch(endpoint_entry& x) {
+  if (!x.pinned) {
+    m_lru.splice(m_lru.begin(), m_lru, x.lru_pos);
+  }
+}
+
+void datagram_handler::evict_endpoints() {
+  // always keep the most recently used endpoint, because the
+  // manager is about to receive a datagram from it
+  while (m_lru.size() > std::max(m_max_endpoints, size_t{1})) {
+    auto id = m_lru.back();
+    CAF_LOG_DEBUG("evict endpoint " << id);
+    m_lru.pop_back();
+    auto i = m_endpoints.find(id);
+    m_ids.erase(i->second.addr);
+    m_endpoints.erase(i);
+  }
+}
+
+bool datagram_handler::read_batch(size_t& result) {
+  result = 0;
+  // an extra byte per slot tells truncated datagrams apart
+  auto slot_size = m_max_size + 1;
+  auto rd_size = max_batch_size * slot_size;
+  if (m_rd_buf.size() < rd_size) {
+    auto& pool = backend().buffers();
+    pool.release(m_rd_buf);
+    m_rd_buf = pool.take_initialized(rd_size);
+  }
+# ifdef CAF_LINUX
+    std::array<mmsghdr, max_batch_size> hdrs;
+    std::array<iovec, max_batch_size> iov;
+    memset(hdrs.data(), 0, sizeof(hdrs));
+    for (size_t i = 0; i < max_batch_size; ++i) {
+      iov[i].iov_base = m_rd_buf.data() + i * slot_size;
+      iov[i].iov_len = slot_size;
+      auto& hdr = hdrs[i].msg_hdr;
+      hdr.msg_name = &m_rd_queue[i].from.addr;
+      hdr.msg_namelen = sizeof(sockaddr_storage);
+      hdr.msg_iov = &iov[i];
+      hdr.msg_iovlen = 1;
+    }
+    auto res = ::recvmmsg(m_fd, hdrs.data(), max_batch_size, 0, nullptr);
+    CAF_LOG_DEBUG("recvmmsg returned " << res);
+    if (res < 0) {
+      return !is_error(res, true);
+    }
+    result = static_cast<size_t>(res);
+    for (size_t i = 0; i < result; ++i) {
+      auto& x = m_rd_queue[i];
+      x.from.len = hdrs[i].msg_hdr.msg_namelen;
+      x.size = (hdrs[i].msg_hdr.msg_flags & MSG_TRUNC) ? slot_size
+                                                       : hdrs[i].msg_len;
+    }
+# else
+    for (; result < max_batch_size; ++result) {
+      auto& x = m_rd_queue[result];
+      x.from.len = sizeof(sockaddr_storage);
+      auto res = ::recvfrom(m_fd, reinterpret_cast<socket_recv_ptr>(
+                                    m_rd_buf.data() + result * slot_size),
+                            slot_size, 0,
+                            reinterpret_cast<sockaddr*>(&x.from.addr),
+                            &x.from.len);
+      if (res < 0) {
+#       ifdef CAF_WINDOWS
+          if (last_socket_error() == WSAEMSGSIZE) {
+            x.size = slot_size;
+            continue;
+          }
+#       endif
+        return !is_error(res, true);
+      }
+      x.size = static_cast<size_t>(res);
+    }
+# endif
+  return true;
+}
+
+size_t datagram_handler::write_batch() {
+  auto num = std::min(max_batch_size, m_wr_queue.size() - m_wr_sent);
+  auto first = m_wr_queue.data() + m_wr_sent;
+# ifdef CAF_LINUX
+    std::array<mmsghdr, max_batch_size> hdrs;
+    std::array<iovec, max_batch_size> iov;
+    memset(hdrs.data(), 0, sizeof(hdrs));
+    for (size_t i = 0; i < num; ++i) {
+      auto& ep = first[i].to;
+      iov[i].iov_base = m_wr_buf.data() + first[i].offset;
+      iov[i].iov_len = first[i].size;
+      auto& hdr = hdrs[i].msg_hdr;
+      hdr.msg_name = &ep.addr;
+      hdr.msg_namelen = ep.len;
+      hdr.msg_iov = &iov[i];
+      hdr.msg_iovlen = 1;
+    }
+    auto res = ::sendmmsg(m_fd, hdrs.data(), static_cast<unsigned>(num),
+                          no_sigpipe_flag);
+    CAF_LOG_DEBUG("sendmmsg returned " << res);
+    if (res > 0) {
+      return static_cast<size_t>(res);
+    }
+# else
+    size_t sent = 0;
+    for (; sent < num; ++sent) {
+      auto& ep = first[sent].to;
+      auto res = ::sendto(m_fd, reinterpret_cast<socket_send_ptr>(
+                                  m_wr_buf.data() + first[sent].offset),
+                          first[sent].size, no_sigpipe_flag,
+                          reinterpret_cast<const sockaddr*>(&ep.addr),
+                          ep.len);
+      if (res < 0) {
+        break;
+      }
+    }
+    if (sent > 0) {
+      // errors are reported by the next batch
+      return sent;
+    }
+# endif
+  auto err = last_socket_error();
+  if (would_block_or_temporarily_unavailable(err)) {
+    return 0;
+  }
+  // the first datagram of the batch cannot be sent to its
+  // endpoint, e.g., due to its size, so we drop it and move on
+  CAF_LOG_DEBUG("drop datagram: " << last_socket_error_as_string());
+  return 1;
+}
+
+bool datagram_handler::write_loop() {
+  while (m_wr_sent < m_wr_queue.size()) {
+    auto num = write_batch();
+    if (num == 0) {
+      // the send buffer of the socket is full
+      would_block(operation::write);
+      return false;
+    }
+    m_wr_sent += num;
+  }
+  m_wr_queue.clear();
+  m_wr_sent = 0;
+  // don't hold on to a buffer while the socket is idle
+  backend().buffers().release(m_wr_buf);
+  return true;
+}
+
 } // namespace network
 } // namespace io
 } // namespace caf
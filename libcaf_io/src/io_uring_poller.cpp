@@ -0,0 +1,284 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/io_uring_poller.hpp"
+
+#include "caf/detail/logging.hpp"
+
+#ifdef CAF_HAS_IO_URING
+# include <cerrno>
+# include <poll.h>
+# include <cstring>
+# include <unistd.h>
+# include <algorithm>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+# include <linux/time_types.h>
+#endif
+
+namespace caf {
+namespace io {
+namespace network {
+
+#ifdef CAF_HAS_IO_URING
+
+namespace {
+
+// user data for completions of poll removals, which we ignore
+constexpr uint64_t removal_token = ~uint64_t{0};
+
+// number of entries in the submission queue
+constexpr unsigned sq_entries = 1024;
+
+// the lower 32 bits identify the socket, the upper 32 bits allow us
+// to detect stale completions of previous poll requests on a socket
+inline uint64_t make_token(native_socket fd, uint32_t gen) {
+  return (static_cast<uint64_t>(gen) << 32) | static_cast<uint32_t>(fd);
+}
+
+template <class T>
+T* ring_ptr(void* base, uint32_t offset) {
+  return reinterpret_cast<T*>(reinterpret_cast<char*>(base) + offset);
+}
+
+} // namespace <anonymous>
+
+io_uring_poller::io_uring_poller()
+    : m_ring_fd(-1),
+      m_ring(MAP_FAILED),
+      m_ring_size(0),
+      m_sqes(MAP_FAILED),
+      m_sqes_size(0),
+      m_sq_local_tail(0) {
+  // nop
+}
+
+io_uring_poller::~io_uring_poller() {
+  if (m_sqes != MAP_FAILED) {
+    munmap(m_sqes, m_sqes_size);
+  }
+  if (m_ring != MAP_FAILED) {
+    munmap(m_ring, m_ring_size);
+  }
+  if (m_ring_fd != -1) {
+    close(m_ring_fd);
+  }
+}
+
+std::unique_ptr<io_uring_poller> io_uring_poller::make() {
+  std::unique_ptr<io_uring_poller> result{new io_uring_poller};
+  if (!result->init()) {
+    return nullptr;
+  }
+  return result;
+}
+
+bool io_uring_poller::init() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  m_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, sq_entries,
+                                       &params));
+  if (m_ring_fd < 0) {
+    CAF_LOG_INFO("io_uring_setup failed: " << strerror(errno));
+    return false;
+  }
+  // we rely on a single mapping for both rings, on not losing completions
+  // when the completion queue overflows and on waiting with a timeout
+  auto required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP
+                  | IORING_FEAT_EXT_ARG;
+  if ((params.features & required) != required) {
+    CAF_LOG_INFO("io_uring lacks required features");
+    return false;
+  }
+  auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  auto cq_size = params.cq_off.cqes
+                 + params.cq_entries * sizeof(io_uring_cqe);
+  m_ring_size = std::max<size_t>(sq_size, cq_size);
+  m_ring = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+  m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  m_sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+  if (m_ring == MAP_FAILED || m_sqes == MAP_FAILED) {
+    CAF_LOG_INFO("cannot map io_uring buffers: " << strerror(errno));
+    return false;
+  }
+  m_sq_head = ring_ptr<unsigned>(m_ring, params.sq_off.head);
+  m_sq_tail = ring_ptr<unsigned>(m_ring, params.sq_off.tail);
+  m_sq_array = ring_ptr<unsigned>(m_ring, params.sq_off.array);
+  m_sq_mask = *ring_ptr<unsigned>(m_ring, params.sq_off.ring_mask);
+  m_sq_entries = params.sq_entries;
+  m_sq_local_tail = *m_sq_tail;
+  m_cq_head = ring_ptr<unsigned>(m_ring, params.cq_off.head);
+  m_cq_tail = ring_ptr<unsigned>(m_ring, params.cq_off.tail);
+  m_cq_mask = *ring_ptr<unsigned>(m_ring, params.cq_off.ring_mask);
+  m_cqes = ring_ptr<void>(m_ring, params.cq_off.cqes);
+  return true;
+}
+
+void io_uring_poller::set(native_socket fd, event_handler* ptr, int mask) {
+  CAF_LOG_TRACE(CAF_ARG(fd) << ", " << CAF_ARG(mask));
+  auto idx = static_cast<size_t>(fd);
+  if (idx >= m_regs.size()) {
+    m_regs.resize(idx + 1, registration{nullptr, 0, 0, false});
+  }
+  auto& reg = m_regs[idx];
+  if (reg.armed && reg.mask != mask) {
+    disarm(fd, reg);
+  }
+  reg.ptr = ptr;
+  reg.mask = mask;
+  if (mask != 0 && !reg.armed) {
+    arm(fd, reg);
+  }
+}
+
+void io_uring_poller::wait(int timeout, std::vector<event>& result) {
+  // sockets are armed for a single event only
+  for (auto fd : m_fired) {
+    auto& reg = m_regs[static_cast<size_t>(fd)];
+    if (reg.mask != 0 && !reg.armed) {
+      arm(fd, reg);
+    }
+  }
+  m_fired.clear();
+  submit(timeout == 0 ? 0 : 1, timeout);
+  auto cqes = reinterpret_cast<io_uring_cqe*>(m_cqes);
+  auto head = *m_cq_head;
+  auto tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+    auto& cqe = cqes[head & m_cq_mask];
+    if (cqe.user_data == removal_token) {
+      continue;
+    }
+    auto fd = static_cast<native_socket>(cqe.user_data & 0xFFFFFFFF);
+    auto gen = static_cast<uint32_t>(cqe.user_data >> 32);
+    auto idx = static_cast<size_t>(fd);
+    if (idx >= m_regs.size() || m_regs[idx].gen != gen
+        || !m_regs[idx].armed) {
+      // completion of a poll request we have removed in the meantime
+      continue;
+    }
+    auto& reg = m_regs[idx];
+    reg.armed = false;
+    m_fired.push_back(fd);
+    // a negative result is an error code for the poll request itself
+    auto mask = cqe.res < 0 ? static_cast<int>(POLLERR)
+                            : static_cast<int>(cqe.res);
+    result.push_back(event{fd, mask, reg.ptr});
+  }
+  __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+}
+
+void io_uring_poller::arm(native_socket fd, registration& reg) {
+  auto sqe = reinterpret_cast<io_uring_sqe*>(next_sqe());
+  ++reg.gen;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = static_cast<uint32_t>(reg.mask);
+  sqe->user_data = make_token(fd, reg.gen);
+  reg.armed = true;
+}
+
+void io_uring_poller::disarm(native_socket fd, registration& reg) {
+  auto sqe = reinterpret_cast<io_uring_sqe*>(next_sqe());
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = make_token(fd, reg.gen);
+  sqe->user_data = removal_token;
+  reg.armed = false;
+}
+
+void* io_uring_poller::next_sqe() {
+  if (m_sq_local_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE)
+      == m_sq_entries) {
+    // submission queue is full, flush it without waiting for events
+    submit(0, 0);
+  }
+  auto idx = m_sq_local_tail & m_sq_mask;
+  auto sqe = reinterpret_cast<io_uring_sqe*>(m_sqes) + idx;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  m_sq_array[idx] = idx;
+  ++m_sq_local_tail;
+  return sqe;
+}
+
+void io_uring_poller::submit(unsigned min_complete, int timeout) {
+  __atomic_store_n(m_sq_tail, m_sq_local_tail, __ATOMIC_RELEASE);
+  __kernel_timespec ts;
+  io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  if (timeout >= 0) {
+    ts.tv_sec = timeout / 1000;
+    ts.tv_nsec = (timeout % 1000) * 1000000;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+  }
+  auto to_submit = m_sq_local_tail - *m_sq_head;
+  long res;
+  if (min_complete > 0) {
+    res = syscall(__NR_io_uring_enter, m_ring_fd, to_submit, min_complete,
+                  IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                  &arg, sizeof(arg));
+  } else {
+    res = syscall(__NR_io_uring_enter, m_ring_fd, to_submit, 0, 0,
+                  nullptr, 0);
+  }
+  if (res < 0) {
+    switch (errno) {
+      case EINTR:
+      case ETIME:
+      case EAGAIN:
+      case EBUSY:
+        // try again in the next iteration
+        break;
+      default:
+        perror("io_uring_enter() failed");
+        CAF_CRITICAL("io_uring_enter() failed");
+    }
+  }
+}
+
+#else // CAF_HAS_IO_URING
+
+io_uring_poller::io_uring_poller() {
+  // nop
+}
+
+io_uring_poller::~io_uring_poller() {
+  // nop
+}
+
+std::unique_ptr<io_uring_poller> io_uring_poller::make() {
+  return nullptr;
+}
+
+void io_uring_poller::set(native_socket, event_handler*, int) {
+  // nop
+}
+
+void io_uring_poller::wait(int, std::vector<event>&) {
+  // nop
+}
+
+#endif // CAF_HAS_IO_URING
+
+} // namespace network
+} // namespace io
+} // namespace caf
@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 #include <tuple>
+#include <vector>
 #include <cerrno>
 #include <memory>
 #include <cstring>
@@ -25,6 +26,7 @@
 #include <stdexcept>
 
 #include "caf/on.hpp"
+#include "caf/send.hpp"
 #include "caf/actor.hpp"
 #include "caf/config.hpp"
 #include "caf/node_id.hpp"
@@ -78,10 +80,9 @@ inline void deserialize_impl(new_connection_msg& msg, deserializer* source) {
   deserialize_impl(msg.handle, source);
 }
 
-inline void serialize_impl(const new_data_msg& msg, serializer* sink) {
-  serialize_impl(msg.handle, sink);
-  auto buf_size = static_cast<uint32_t>(msg.buf.size());
-  if (buf_size != msg.buf.size()) { // narrowing error
+inline void serialize_buf(const std::vector<char>& buf, serializer* sink) {
+  auto buf_size = static_cast<uint32_t>(buf.size());
+  if (buf_size != buf.size()) { // narrowing error
     std::ostringstream oss;
     oss << "attempted to send more than "
         << std::numeric_limits<uint32_t>::max() << " bytes";
@@ -90,32 +91,71 @@ inline void serialize_impl(const new_data_msg& msg, serializer* sink) {
     throw std::ios_base::failure(std::move(errstr));
   }
   sink->write_value(buf_size);
-  sink->write_raw(msg.buf.size(), msg.buf.data());
+  sink->write_raw(buf.size(), buf.data());
+}
+
+inline void deserialize_buf(std::vector<char>& buf, deserializer* source) {
+  auto buf_size = source->read<uint32_t>();
+  buf.resize(buf_size);
+  source->read_raw(buf.size(), buf.data());
+}
+
+inline void serialize_impl(const new_data_msg& msg, serializer* sink) {
+  serialize_impl(msg.handle, sink);
+  serialize_buf(msg.buf, sink);
 }
 
 inline void deserialize_impl(new_data_msg& msg, deserializer* source) {
   deserialize_impl(msg.handle, source);
-  auto buf_size = source->read<uint32_t>();
-  msg.buf.resize(buf_size);
-  source->read_raw(msg.buf.size(), msg.buf.data());
+  deserialize_buf(msg.buf, source);
 }
 
-// connection_closed_msg & acceptor_closed_msg have the same fields
+inline void serialize_impl(const new_datagram_msg& msg, serializer* sink) {
+  serialize_impl(msg.handle, sink);
+  serialize_impl(msg.endpoint, sink);
+  serialize_buf(msg.buf, sink);
+}
+
+inline void deserialize_impl(new_datagram_msg& msg, deserializer* source) {
+  deserialize_impl(msg.handle, source);
+  deserialize_impl(msg.endpoint, source);
+  deserialize_buf(msg.buf, source);
+}
+
+// connection_closed_msg, acceptor_closed_msg, and
+// datagram_servant_closed_msg have the same fields
 template <class T>
 typename std::enable_if<std::is_same<T, connection_closed_msg>::value
-                        || std::is_same<T, acceptor_closed_msg>::value>::type
+                        || std::is_same<T, acceptor_closed_msg>::value
+                        || std::is_same<T,
+                                        datagram_servant_closed_msg>::value>::type
 serialize_impl(const T& dm, serializer* sink) {
   serialize_impl(dm.handle, sink);
 }
 
-// connection_closed_msg & acceptor_closed_msg have the same fields
+// connection_closed_msg, acceptor_closed_msg, and
+// datagram_servant_closed_msg have the same fields
 template <class T>
 typename std::enable_if<std::is_same<T, connection_closed_msg>::value
-                        || std::is_same<T, acceptor_closed_msg>::value>::type
+                        || std::is_same<T, acceptor_closed_msg>::value
+                        || std::is_same<T,
+                                        datagram_servant_closed_msg>::value>::type
 deserialize_impl(T& dm, deserializer* source) {
   deserialize_impl(dm.handle, source);
 }
 
+inline void serialize_impl(const connection_backpressure_msg& msg,
+                           serializer* sink) {
+  serialize_impl(msg.handle, sink);
+  sink->write_value(static_cast<uint8_t>(msg.congested ? 1 : 0));
+}
+
+inline void deserialize_impl(connection_backpressure_msg& msg,
+                             deserializer* source) {
+  deserialize_impl(msg.handle, source);
+  msg.congested = source->read<uint8_t>() != 0;
+}
+
 template <class T>
 class uti_impl : public detail::abstract_uniform_type_info<T> {
  public:
@@ -142,8 +182,13 @@ void do_announce(const char* tname) {
 } // namespace <anonymous>
 
 using middleman_actor_base = middleman_actor::extend<
+                               reacts_to<get_atom, int64_t>,
                                reacts_to<ok_atom, int64_t>,
                                reacts_to<ok_atom, int64_t, actor_addr>,
+                               reacts_to<ok_atom, int64_t, connection_handle>,
+                               reacts_to<ok_atom, int64_t, connection_handle,
+                                         std::string, std::set<std::string>>,
+                               reacts_to<ok_atom, int64_t, uint16_t>,
                                reacts_to<error_atom, int64_t, std::string>
                              >::type;
 
@@ -160,11 +205,20 @@ class middleman_actor_impl : public middleman_actor_base::base {
 
   void on_exit() {
     CAF_LOG_TRACE("");
+    m_pending_puts.clear();
     m_pending_gets.clear();
     m_pending_deletes.clear();
+    m_lookups.clear();
+    m_connecting.clear();
+    m_endpoints.clear();
     m_broker = invalid_actor;
   }
 
+  using put_op_result = either<ok_atom, uint16_t>
+                        ::or_else<error_atom, std::string>;
+
+  using put_op_promise = typed_response_promise<put_op_result>;
+
   using get_op_result = either<ok_atom, actor_addr>
                         ::or_else<error_atom, std::string>;
 
@@ -192,6 +246,9 @@ class middleman_actor_impl : public middleman_actor_base::base {
       [=](put_atom, const actor_addr& whom, uint16_t port) {
         return put(whom, port);
       },
+      [=](put_atom, const actor_addr& whom, const std::string& path) {
+        return put_local(whom, path);
+      },
       [=](get_atom, const std::string& hostname, uint16_t port,
           std::set<std::string>& expected_ifs) {
         return get(hostname, port, std::move(expected_ifs));
@@ -199,6 +256,10 @@ class middleman_actor_impl : public middleman_actor_base::base {
       [=](get_atom, const std::string& hostname, uint16_t port) {
         return get(hostname, port, std::set<std::string>());
       },
+      [=](get_atom, const std::string& path,
+          std::set<std::string>& expected_ifs) {
+        return get_local(path, std::move(expected_ifs));
+      },
       [=](delete_atom, const actor_addr& whom) {
         return del(whom);
       },
@@ -213,61 +274,240 @@ class middleman_actor_impl : public middleman_actor_base::base {
       [=](ok_atom, int64_t request_id, actor_addr& result) {
         // not legal for delete results
         CAF_REQUIRE(m_pending_deletes.count(request_id) == 0);
+        auto node = result.node();
         handle_ok<get_op_result>(m_pending_gets, request_id, std::move(result));
+        lookup_done(request_id, node, nullptr);
+      },
+      [=](ok_atom, int64_t request_id, connection_handle hdl) {
+        connected(request_id, hdl);
+      },
+      [=](ok_atom, int64_t request_id, connection_handle hdl,
+          const std::string& path, std::set<std::string>& expected_ifs) {
+        // connected to a Unix domain socket, see `get_local`
+        send(m_broker, get_atom::value, hdl, path, request_id,
+             actor{this}, std::move(expected_ifs));
+      },
+      [=](ok_atom, int64_t request_id, uint16_t port) {
+        // the BASP broker confirmed that the port belongs to the actor
+        handle_ok<put_op_result>(m_pending_puts, request_id, port);
+      },
+      [=](get_atom, int64_t request_id) {
+        // the BASP broker cannot reach the cached node via an open connection
+        auto i = m_lookups.find(request_id);
+        if (i != m_lookups.end()) {
+          CAF_LOG_DEBUG("cached node not reachable, open new connection");
+          connect_or_wait(request_id);
+        }
       },
       [=](error_atom, int64_t request_id, std::string& reason) {
+        lookup_done(request_id, invalid_node_id, &reason);
         handle_error(request_id, reason);
       }
     };
   }
 
  private:
-  either<ok_atom, uint16_t>::or_else<error_atom, std::string>
-  put(const actor_addr& whom, uint16_t port,
-      const char* in = nullptr, bool reuse_addr = false) {
+  put_op_promise put(const actor_addr& whom, uint16_t port,
+                     const char* in = nullptr, bool reuse_addr = false) {
     CAF_LOG_TRACE(CAF_TSARG(whom) << ", " << CAF_ARG(port)
                   << ", " << CAF_ARG(reuse_addr));
-    accept_handle hdl;
+    auto result = make_response_promise();
+    std::vector<accept_handle> hdls;
     uint16_t actual_port;
+    auto num_acceptors = m_parent.acceptors_per_port();
+    auto& backend = m_parent.backend();
     try {
       // treat empty strings like nullptr
       if (in != nullptr && in[0] == '\0') {
         in = nullptr;
       }
-      auto res = m_parent.backend().new_tcp_doorman(port, in, reuse_addr);
-      hdl = res.first;
+      // siblings may only join a port we have bound ourselves
+      auto sharing = num_acceptors > 1 ? network::port_sharing::owner
+                                       : network::port_sharing::none;
+      auto res = backend.new_tcp_doorman(port, in, reuse_addr, sharing);
+      hdls.push_back(res.first);
       actual_port = res.second;
     }
     catch (bind_failure& err) {
-      return {error_atom::value, std::string("bind_failure: ") + err.what()};
+      auto reason = std::string("bind_failure: ") + err.what();
+      if (port == 0) {
+        result.deliver(put_op_result{error_atom::value,
+                                     std::move(reason)}.value);
+        return result;
+      }
+      // publishing an actor at its own port again is not an error,
+      // but only the BASP broker knows which actor owns the port
+      auto req_id = m_next_request_id++;
+      m_pending_puts.insert(std::make_pair(req_id, result));
+      send(m_broker, put_atom::value, req_id, whom, port, reason);
+      return result;
     }
     catch (network_error& err) {
-      return {error_atom::value, std::string("network_error: ") + err.what()};
+      result.deliver(put_op_result{error_atom::value,
+                                   std::string("network_error: ")
+                                   + err.what()}.value);
+      return result;
+    }
+    // additional acceptors are optional, i.e., we publish
+    // the actor as long as the first acceptor succeeded
+    for (size_t i = 1; i < num_acceptors; ++i) {
+      try {
+        hdls.push_back(backend.new_tcp_doorman(actual_port, in, reuse_addr,
+                                               network::port_sharing::sibling)
+                       .first);
+      }
+      catch (network_error& err) {
+        CAF_LOG_WARNING("cannot open additional acceptor for port "
+                        << actual_port << ": " << err.what());
+        break;
+      }
+    }
+    for (auto& hdl : hdls) {
+      send(m_broker, put_atom::value, hdl, whom, actual_port);
     }
-    send(m_broker, put_atom::value, hdl, whom, actual_port);
-    return {ok_atom::value, actual_port};
+    result.deliver(put_op_result{ok_atom::value, actual_port}.value);
+    return result;
   }
 
   get_op_promise get(const std::string& hostname, uint16_t port,
                      std::set<std::string> expected_ifs) {
     CAF_LOG_TRACE(CAF_ARG(hostname) << ", " << CAF_ARG(port));
     auto result = make_response_promise();
+    auto req_id = m_next_request_id++;
+    m_pending_gets.insert(std::make_pair(req_id, result));
+    auto& lookup = m_lookups[req_id];
+    lookup.ep = endpoint{hostname, port};
+    lookup.expected_ifs = std::move(expected_ifs);
+    lookup.state = resolving;
+    // ask the node we already know at this endpoint before connecting to it
+    auto i = m_endpoints.find(lookup.ep);
+    if (i == m_endpoints.end()) {
+      connect_or_wait(req_id);
+    } else {
+      CAF_LOG_DEBUG("resolve via known node " << to_string(i->second));
+      send(m_broker, get_atom::value, i->second, port, req_id,
+           actor{this}, lookup.expected_ifs);
+    }
+    return result;
+  }
+
+  either<ok_atom>::or_else<error_atom, std::string>
+  put_local(const actor_addr& whom, const std::string& path) {
+    CAF_LOG_TRACE(CAF_TSARG(whom) << ", " << CAF_ARG(path));
+    accept_handle hdl;
     try {
-      auto hdl = m_parent.backend().new_tcp_scribe(hostname, port);
-      auto req_id = m_next_request_id++;
-      send(m_broker, get_atom::value, hdl, req_id,
-           actor{this}, std::move(expected_ifs));
-      m_pending_gets.insert(std::make_pair(req_id, result));
+      hdl = m_parent.backend().new_local_doorman(path);
+    }
+    catch (bind_failure& err) {
+      return {error_atom::value, std::string("bind_failure: ") + err.what()};
     }
     catch (network_error& err) {
-      // fullfil promise immediately
-      std::string msg = "network_error: ";
-      msg += err.what();
-      result.deliver(get_op_result{error_atom::value, std::move(msg)}.value);
+      return {error_atom::value, std::string("network_error: ") + err.what()};
     }
+    send(m_broker, put_atom::value, hdl, whom, path);
+    return {ok_atom::value};
+  }
+
+  // lookups by path bypass the lookup cache of `get`, because
+  // connecting to a Unix domain socket needs no network roundtrip
+  get_op_promise get_local(const std::string& path,
+                           std::set<std::string> expected_ifs) {
+    CAF_LOG_TRACE(CAF_ARG(path));
+    auto result = make_response_promise();
+    auto req_id = m_next_request_id++;
+    m_pending_gets.insert(std::make_pair(req_id, result));
+    // a listener with a full backlog stalls a blocking connect
+    actor self{this};
+    m_parent.backend().new_local_scribe(
+      path, m_parent.connect_timeout(),
+      [=](connection_handle hdl, const std::string& error) {
+        if (hdl.invalid()) {
+          anon_send(self, error_atom::value, req_id, error);
+        } else {
+          anon_send(self, ok_atom::value, req_id, hdl, path, expected_ifs);
+        }
+      });
     return result;
   }
 
+  // opens a new connection for `request_id` unless another
+  // request is already connecting to the same endpoint
+  void connect_or_wait(int64_t request_id) {
+    CAF_LOG_TRACE(CAF_ARG(request_id));
+    auto& lookup = m_lookups[request_id];
+    auto i = m_connecting.find(lookup.ep);
+    if (i != m_connecting.end()) {
+      CAF_LOG_DEBUG("wait for pending connect");
+      i->second.push_back(request_id);
+      return;
+    }
+    m_connecting[lookup.ep];
+    lookup.state = connecting;
+    // connect asynchronously to not stall other requests while
+    // waiting for slow or unreachable hosts
+    actor self{this};
+    m_parent.backend().new_tcp_scribe(
+      lookup.ep.first, lookup.ep.second, m_parent.connect_timeout(),
+      [=](connection_handle hdl, const std::string& error) {
+        if (hdl.invalid()) {
+          anon_send(self, error_atom::value, request_id, error);
+        } else {
+          anon_send(self, ok_atom::value, request_id, hdl);
+        }
+      });
+  }
+
+  void connected(int64_t request_id, connection_handle hdl) {
+    CAF_LOG_TRACE(CAF_ARG(request_id) << ", " << CAF_MARG(hdl, id));
+    auto i = m_lookups.find(request_id);
+    if (i == m_lookups.end()) {
+      CAF_LOG_ERROR("request id not found: " << request_id);
+      return;
+    }
+    i->second.state = handshaking;
+    send(m_broker, get_atom::value, hdl, request_id,
+         actor{this}, i->second.expected_ifs);
+  }
+
+  // updates the cache and resumes requests waiting for `request_id`
+  void lookup_done(int64_t request_id, const node_id& nid,
+                   const std::string* error) {
+    CAF_LOG_TRACE(CAF_ARG(request_id) << ", " << CAF_TSARG(nid));
+    auto i = m_lookups.find(request_id);
+    if (i == m_lookups.end()) {
+      return;
+    }
+    auto ep = std::move(i->second.ep);
+    auto state = i->second.state;
+    m_lookups.erase(i);
+    if (nid != invalid_node_id && nid != detail::singletons::get_node_id()) {
+      m_endpoints[ep] = nid;
+    }
+    if (state == resolving) {
+      return;
+    }
+    auto j = m_connecting.find(ep);
+    if (j == m_connecting.end()) {
+      return;
+    }
+    auto waiting = std::move(j->second);
+    m_connecting.erase(j);
+    for (auto req_id : waiting) {
+      if (error && state == connecting) {
+        // the endpoint is not reachable, no need to try again
+        auto reason = *error;
+        m_lookups.erase(req_id);
+        handle_error(req_id, reason);
+      } else if (m_endpoints.count(ep) > 0) {
+        auto& lookup = m_lookups[req_id];
+        send(m_broker, get_atom::value, m_endpoints[ep], ep.second, req_id,
+             actor{this}, lookup.expected_ifs);
+      } else {
+        connect_or_wait(req_id);
+      }
+    }
+  }
+
   del_op_promise del(const actor_addr& whom, uint16_t port = 0) {
     CAF_LOG_TRACE(CAF_TSARG(whom) << ", " << CAF_ARG(port));
     auto result = make_response_promise();
@@ -304,13 +544,17 @@ class middleman_actor_impl : public middleman_actor_base::base {
 
   void handle_error(int64_t request_id, std::string& reason) {
     CAF_LOG_TRACE(CAF_ARG(request_id) << ", " << CAF_ARG(reason));
+    auto fput = [&](response_promise& rp) {
+      rp.deliver(put_op_result{error_atom::value, std::move(reason)}.value);
+    };
     auto fget = [&](response_promise& rp) {
       rp.deliver(get_op_result{error_atom::value, std::move(reason)}.value);
     };
     auto fdel = [&](response_promise& rp) {
       rp.deliver(del_op_result{error_atom::value, std::move(reason)}.value);
     };
-    if (!finalize_request(m_pending_gets, request_id, fget)
+    if (!finalize_request(m_pending_puts, request_id, fput)
+        && !finalize_request(m_pending_gets, request_id, fget)
         && !finalize_request(m_pending_deletes, request_id, fdel)) {
       CAF_LOG_ERROR("invalid request id: " << request_id);
     }
@@ -319,8 +563,30 @@ class middleman_actor_impl : public middleman_actor_base::base {
   actor m_broker;
   middleman& m_parent;
   int64_t m_next_request_id;
+  map_type m_pending_puts;
   map_type m_pending_gets;
   map_type m_pending_deletes;
+  // host and port of a published actor
+  using endpoint = std::pair<std::string, uint16_t>;
+  enum lookup_state {
+    // asked the BASP broker to use an existing connection
+    resolving,
+    // waiting for a new connection
+    connecting,
+    // waiting for the handshake on a new connection
+    handshaking
+  };
+  struct lookup_data {
+    endpoint ep;
+    std::set<std::string> expected_ifs;
+    lookup_state state;
+  };
+  // state of pending gets
+  std::map<int64_t, lookup_data> m_lookups;
+  // requests waiting for a pending connect to the same endpoint
+  std::map<endpoint, std::vector<int64_t>> m_connecting;
+  // caches the node found at an endpoint
+  std::map<endpoint, node_id> m_endpoints;
 };
 
 middleman_actor_impl::~middleman_actor_impl() {
@@ -356,10 +622,17 @@ void middleman::initialize() {
   do_announce<connection_closed_msg>("caf::io::connection_closed_msg");
   do_announce<accept_handle>("caf::io::accept_handle");
   do_announce<acceptor_closed_msg>("caf::io::acceptor_closed_msg");
+  do_announce<connection_backpressure_msg>(
+    "caf::io::connection_backpressure_msg");
   do_announce<connection_closed_msg>("caf::io::connection_closed_msg");
   do_announce<connection_handle>("caf::io::connection_handle");
+  do_announce<datagram_handle>("caf::io::datagram_handle");
+  do_announce<datagram_servant_closed_msg>(
+    "caf::io::datagram_servant_closed_msg");
+  do_announce<endpoint_handle>("caf::io::endpoint_handle");
   do_announce<new_connection_msg>("caf::io::new_connection_msg");
   do_announce<new_data_msg>("caf::io::new_data_msg");
+  do_announce<new_datagram_msg>("caf::io::new_datagram_msg");
   actor mgr = get_named_broker<basp_broker>(atom("_BASP"));
   m_manager = spawn_typed<middleman_actor_impl, detached + hidden>(*this, mgr);
 }
@@ -393,7 +666,11 @@ void middleman::dispose() {
   delete this;
 }
 
-middleman::middleman() {
+middleman::middleman()
+    : m_connect_timeout(30000),
+      m_acceptors_per_port(1),
+      m_write_low_watermark(0),
+      m_write_high_watermark(0) {
   // nop
 }
 
@@ -19,6 +19,10 @@
 
 #include "caf/io/network/multiplexer.hpp"
 
+#include "caf/exception.hpp"
+
+#include "caf/detail/logging.hpp"
+
 #ifdef CAF_USE_ASIO
 # include "caf/io/network/asio_multiplexer.hpp"
   using caf_multiplexer_impl = caf::io::network::asio_multiplexer;
@@ -39,6 +43,35 @@ boost::asio::io_service* pimpl() {
   return nullptr;
 }
 
+void multiplexer::new_tcp_scribe(const std::string& host, uint16_t port,
+                                 std::chrono::milliseconds, connect_handler f) {
+  CAF_LOG_TRACE(CAF_ARG(host) << ", " << CAF_ARG(port));
+  connection_handle hdl;
+  try {
+    hdl = new_tcp_scribe(host, port);
+  }
+  catch (network_error& err) {
+    f(connection_handle{}, std::string("network_error: ") + err.what());
+    return;
+  }
+  f(hdl, std::string{});
+}
+
+void multiplexer::new_local_scribe(const std::string& path,
+                                   std::chrono::milliseconds,
+                                   connect_handler f) {
+  CAF_LOG_TRACE(CAF_ARG(path));
+  connection_handle hdl;
+  try {
+    hdl = new_local_scribe(path);
+  }
+  catch (network_error& err) {
+    f(connection_handle{}, std::string("network_error: ") + err.what());
+    return;
+  }
+  f(hdl, std::string{});
+}
+
 multiplexer_ptr multiplexer::make() {
   CAF_LOGF_TRACE("");
   return multiplexer_ptr{new caf_multiplexer_impl};
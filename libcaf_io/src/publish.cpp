@@ -61,5 +61,23 @@ uint16_t publish_impl(abstract_actor_ptr whom, uint16_t port,
   return result;
 }
 
+void publish_local_impl(abstract_actor_ptr whom, const std::string& path) {
+  if (whom == nullptr) {
+    throw std::invalid_argument("cannot publish an invalid actor");
+  }
+  CAF_LOGF_TRACE("whom = " << to_string(whom->address())
+                 << ", " << CAF_ARG(path));
+  auto mm = get_middleman_actor();
+  scoped_actor self;
+  self->sync_send(mm, put_atom::value, whom->address(), path).await(
+    [](ok_atom) {
+      // success
+    },
+    [&](error_atom, std::string& msg) {
+      throw network_error(std::move(msg));
+    }
+  );
+}
+
 } // namespace io
 } // namespace caf
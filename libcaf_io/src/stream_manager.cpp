@@ -27,6 +27,10 @@ stream_manager::~stream_manager() {
   // nop
 }
 
+void stream_manager::backpressure(bool) {
+  // nop
+}
+
 } // namespace network
 } // namespace io
 } // namespace caf
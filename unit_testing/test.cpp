@@ -1,12 +1,16 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <cstdlib>
 #include <condition_variable>
 
 #include "test.hpp"
 #include "caf/all.hpp"
 #include "caf/string_algorithms.hpp"
 
+#include "caf/io/middleman.hpp"
+#include "caf/io/network/default_multiplexer.hpp"
+
 using namespace std;
 using namespace caf;
 
@@ -126,6 +130,25 @@ void set_default_test_settings() {
   cout.unsetf(ios_base::unitbuf);
 }
 
+bool caf_uses_requested_multiplexer() {
+  auto backend = getenv("CAF_MULTIPLEXER");
+  if (backend == nullptr) {
+    return true;
+  }
+  auto mpx = dynamic_cast<io::network::default_multiplexer*>(
+               &io::middleman::instance()->backend());
+  if (mpx == nullptr) {
+    return false;
+  }
+  if (strcmp(backend, "io_uring") == 0) {
+    return mpx->uses_io_uring();
+  }
+  if (strcmp(backend, "epoll_et") == 0) {
+    return mpx->edge_triggered();
+  }
+  return true;
+}
+
 std::thread run_program_impl(actor rc, const char* cpath, vector<string> args) {
   string path = cpath;
   replace_all(path, "'", "\\'");
@@ -211,6 +211,10 @@ caf::optional<T> spro(const std::string& str) {
 
 std::thread run_program_impl(caf::actor, const char*, std::vector<std::string>);
 
+// returns whether the middleman runs the multiplexer backend
+// selected via the environment variable `CAF_MULTIPLEXER`
+bool caf_uses_requested_multiplexer();
+
 template <class T>
 typename std::enable_if<
   std::is_arithmetic<T>::value,
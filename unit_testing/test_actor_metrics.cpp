@@ -0,0 +1,116 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/singletons.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior testee() {
+  return {
+    [](int x) {
+      return x;
+    },
+    [](const std::string&) {
+      return skip_message();
+    }
+  };
+}
+
+optional<actor_metrics> metrics_of(const actor& whom) {
+  for (auto& x : actor_metrics_snapshot()) {
+    if (x.id == whom.id()) {
+      return x;
+    }
+  }
+  return none;
+}
+
+// counters get updated after a handler returns, i.e., after the
+// testee sent its response; hence we poll for the expected value
+optional<actor_metrics> await_processed(const actor& whom, uint64_t n) {
+  for (int i = 0; i < 100; ++i) {
+    auto res = metrics_of(whom);
+    if (!res || res->processed_messages >= n) {
+      return res;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return metrics_of(whom);
+}
+
+} // namespace <anonymous>
+
+void test_actor_metrics() {
+  CAF_CHECK(!actor_metrics_enabled());
+  set_actor_metrics_enabled(true);
+  CAF_CHECK(actor_metrics_enabled());
+  scoped_actor self;
+  auto t = spawn(testee);
+  self->send(t, std::string{"skipped"});
+  for (int i = 0; i < 10; ++i) {
+    self->sync_send(t, i).await(
+      [&](int res) {
+        CAF_CHECK_EQUAL(res, i);
+      }
+    );
+  }
+  auto m = await_processed(t, 10);
+  CAF_CHECK(m);
+  if (m) {
+    CAF_CHECK_EQUAL(m->processed_messages, 10);
+    // the testee re-tries skipped messages after each processed message
+    CAF_CHECK(m->skipped_messages >= 1);
+    CAF_CHECK_EQUAL(m->mailbox_size, 0);
+    CAF_CHECK(m->processing_time.count() > 0);
+  }
+  auto server = detail::singletons::get_scheduling_coordinator()
+                ->metrics_server();
+  self->sync_send(server, get_atom::value).await(
+    [&](const std::string& table) {
+      CAF_CHECK(table.find("mailbox") != std::string::npos);
+      CAF_CHECK(table.find(std::to_string(t.id())) != std::string::npos);
+    }
+  );
+  self->send_exit(t, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+  CAF_CHECK(!metrics_of(t));
+  set_actor_metrics_enabled(false);
+  auto t2 = spawn(testee);
+  self->sync_send(t2, 42).await(
+    [](int res) {
+      CAF_CHECK_EQUAL(res, 42);
+    }
+  );
+  CAF_CHECK(!metrics_of(t2));
+  self->send_exit(t2, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_actor_metrics);
+  test_actor_metrics();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -17,6 +17,11 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+
 #include "test.hpp"
 
 #include "caf/all.hpp"
@@ -28,6 +33,35 @@ namespace {
 std::atomic<size_t> s_ctors;
 std::atomic<size_t> s_dtors;
 
+// blocks workers of elastic pools until the test opens the gate
+std::mutex s_gate_mtx;
+std::condition_variable s_gate_cv;
+bool s_gate_open = false;
+
+void open_gate() {
+  std::lock_guard<std::mutex> guard{s_gate_mtx};
+  s_gate_open = true;
+  s_gate_cv.notify_all();
+}
+
+void close_gate() {
+  std::lock_guard<std::mutex> guard{s_gate_mtx};
+  s_gate_open = false;
+}
+
+// returns whether `pred` became true within one second
+template <class Predicate>
+bool poll_until(Predicate pred) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
 } // namespace <anonymous>
 
 class worker : public event_based_actor {
@@ -57,6 +91,19 @@ actor spawn_worker() {
   return spawn<worker>();
 }
 
+// queued messages pile up in the mailbox while the gate is closed
+actor spawn_gated_worker() {
+  return spawn<detached>([]() -> behavior {
+    return {
+      [](int x, int y) {
+        std::unique_lock<std::mutex> guard{s_gate_mtx};
+        s_gate_cv.wait(guard, [] { return s_gate_open; });
+        return x + y;
+      }
+    };
+  });
+}
+
 void test_actor_pool() {
   scoped_actor self;
   auto w = actor_pool::make(5, spawn_worker, actor_pool::round_robin{});
@@ -172,11 +219,160 @@ void test_random_actor_pool() {
   self->await_all_other_actors_done();
 }
 
+void test_load_aware_actor_pool(actor_pool::policy pol) {
+  scoped_actor self;
+  auto w = actor_pool::make(5, spawn_worker, std::move(pol));
+  for (int i = 0; i < 10; ++i) {
+    self->sync_send(w, i, i).await(
+      [&](int res) {
+        CAF_CHECK_EQUAL(res, i + i);
+      },
+      after(std::chrono::milliseconds(250)) >> [] {
+        CAF_PRINTERR("didn't receive a result");
+      }
+    );
+  }
+  self->send_exit(w, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+}
+
+void test_load_aware_routing(actor_pool::policy pol) {
+  constexpr int num_messages = 20;
+  scoped_actor self;
+  auto blocked = spawn_gated_worker();
+  auto load = [&] { return blocked->mailbox_size_hint(); };
+  // the first message blocks the worker, the others remain in its mailbox,
+  // i.e., the blocked worker has a higher load than any idle worker can
+  // reach by receiving all messages sent to the pool
+  for (int i = 0; i < num_messages + 1; ++i) {
+    self->send(blocked, 1, 2);
+  }
+  CAF_CHECK(poll_until([&] { return load() == num_messages; }));
+  self->send(blocked, 1, 2);
+  CAF_CHECK_EQUAL(load(), num_messages + 1);
+  auto w = actor_pool::make(4, spawn_worker, std::move(pol));
+  self->send(w, sys_atom::value, put_atom::value, blocked);
+  for (int i = 0; i < num_messages; ++i) {
+    self->send(w, i, i);
+  }
+  // the blocked worker cannot reply before opening the gate
+  int i = 0;
+  self->receive_for(i, num_messages)(
+    [&](int) {
+      CAF_CHECK(self->current_sender() != blocked.address());
+    },
+    after(std::chrono::milliseconds(500)) >> [&] {
+      CAF_FAILURE("pool routed a message to the blocked worker");
+      i = num_messages;
+    }
+  );
+  open_gate();
+  self->receive_for(i = 0, num_messages + 2)(
+    [&](int) {
+      CAF_CHECK(self->current_sender() == blocked.address());
+    }
+  );
+  CAF_CHECK(poll_until([&] { return load() == 0; }));
+  close_gate();
+  self->send_exit(w, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+}
+
+void test_consistent_hash_actor_pool() {
+  scoped_actor self;
+  auto key = [](const message& msg) -> size_t {
+    return msg.match_elements<int, int>() ? msg.get_as<int>(0) : 0;
+  };
+  auto w = actor_pool::make(5, spawn_worker, actor_pool::consistent_hash{key});
+  std::map<int, actor_addr> selected;
+  for (int i = 0; i < 30; ++i) {
+    auto x = i % 3;
+    self->sync_send(w, x, 1).await(
+      [&](int res) {
+        CAF_CHECK_EQUAL(res, x + 1);
+        auto sender = self->current_sender();
+        auto j = selected.find(x);
+        if (j == selected.end()) {
+          selected.emplace(x, sender);
+        } else {
+          CAF_CHECK(j->second == sender);
+        }
+      },
+      after(std::chrono::milliseconds(250)) >> [] {
+        CAF_PRINTERR("didn't receive a result");
+      }
+    );
+  }
+  CAF_CHECK_EQUAL(selected.size(), 3);
+  self->send_exit(w, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+}
+
+void test_elastic_actor_pool() {
+  scoped_actor self;
+  actor_pool::elasticity cfg{1, 4, 2, std::chrono::milliseconds(10)};
+  auto w = actor_pool::make(cfg, spawn_gated_worker,
+                            actor_pool::round_robin{});
+  auto num_workers = [&]() -> size_t {
+    size_t result = 0;
+    self->sync_send(w, sys_atom::value, get_atom::value).await(
+      [&](std::vector<actor>& ws) {
+        result = ws.size();
+      }
+    );
+    return result;
+  };
+  CAF_CHECK_EQUAL(num_workers(), 1);
+  // system messages never cause the pool to grow
+  for (int i = 0; i < 100; ++i) {
+    num_workers();
+  }
+  CAF_CHECK_EQUAL(num_workers(), 1);
+  // all workers are blocked, i.e., each check observes a growing backlog
+  // until the pool reaches its maximum size
+  for (int i = 0; i < 100; ++i) {
+    self->send(w, 1, 2);
+  }
+  CAF_CHECK_EQUAL(num_workers(), 4);
+  open_gate();
+  int i = 0;
+  self->receive_for(i, 100)(
+    [&](int res) {
+      CAF_CHECK_EQUAL(res, 3);
+    }
+  );
+  // the pool retires one idle worker per cool-down period
+  while (num_workers() > 1) {
+    self->receive(
+      after(std::chrono::milliseconds(10)) >> [] {
+        // nop
+      }
+    );
+  }
+  CAF_CHECK_EQUAL(num_workers(), 1);
+  // invalid configurations are rejected
+  try {
+    actor_pool::elasticity zero_cooldown{1, 4, 2, duration{}};
+    actor_pool::make(zero_cooldown, spawn_worker, actor_pool::round_robin{});
+    CAF_FAILURE("unexpected: accepted an elastic pool without cooldown");
+  } catch (std::invalid_argument&) {
+    CAF_CHECKPOINT();
+  }
+  self->send_exit(w, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+}
+
 int main() {
   CAF_TEST(test_actor_pool);
   test_actor_pool();
   test_broadcast_actor_pool();
   test_random_actor_pool();
+  test_load_aware_actor_pool(actor_pool::least_loaded{});
+  test_load_aware_actor_pool(actor_pool::power_of_two_choices{});
+  test_load_aware_routing(actor_pool::least_loaded{});
+  test_load_aware_routing(actor_pool::power_of_two_choices{});
+  test_consistent_hash_actor_pool();
+  test_elastic_actor_pool();
   await_all_actors_done();
   shutdown();
   CAF_CHECK_EQUAL(s_dtors.load(), s_ctors.load());
@@ -0,0 +1,226 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/forwarding_actor_proxy.hpp"
+
+#include "caf/detail/singletons.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+constexpr size_t low_watermark = 64 * 1024;
+constexpr size_t high_watermark = 256 * 1024;
+constexpr size_t payload_size = 1024 * 1024;
+
+using resume_atom = atom_constant<atom("resume")>;
+
+behavior flooding(broker* self, const actor& buddy) {
+  auto port = self->add_tcp_doorman(uint16_t{0}).second;
+  self->send(buddy, port);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->write_watermarks(msg.handle, low_watermark, high_watermark);
+      std::vector<char> buf(payload_size, 'x');
+      self->write(msg.handle, buf.size(), buf.data());
+      self->flush(msg.handle);
+    },
+    [=](const connection_backpressure_msg& msg) {
+      self->send(buddy, msg);
+    }
+  };
+}
+
+behavior pausing(broker* self, const actor& buddy) {
+  auto port = self->add_tcp_doorman(uint16_t{0}).second;
+  self->send(buddy, port);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->configure_read(msg.handle, receive_policy::at_most(1024));
+      self->pause_reading(msg.handle, true);
+      self->send(buddy, msg.handle);
+    },
+    [=](const new_data_msg& msg) {
+      self->send(buddy, std::string(msg.buf.begin(), msg.buf.end()));
+    },
+    [=](resume_atom, connection_handle hdl) {
+      self->pause_reading(hdl, false);
+    }
+  };
+}
+
+int connect_to(uint16_t port) {
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sa.sin_port = htons(port);
+  auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  CAF_CHECK(connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) == 0);
+  return fd;
+}
+
+} // namespace <anonymous>
+
+void test_backpressure() {
+  scoped_actor self;
+  auto server = spawn_io(flooding, self);
+  uint16_t port = 0;
+  self->receive(
+    [&](uint16_t x) {
+      port = x;
+    }
+  );
+  // the broker writes more than the high watermark while nobody reads
+  auto fd = connect_to(port);
+  self->receive(
+    [&](const connection_backpressure_msg& msg) {
+      CAF_CHECK_EQUAL(msg.congested, true);
+    }
+  );
+  // draining the socket lets the broker drop below its low watermark
+  std::vector<char> buf(64 * 1024);
+  size_t received = 0;
+  while (received < payload_size) {
+    auto rb = read(fd, buf.data(), buf.size());
+    if (rb <= 0) {
+      break;
+    }
+    received += static_cast<size_t>(rb);
+  }
+  CAF_CHECK_EQUAL(received, payload_size);
+  self->receive(
+    [&](const connection_backpressure_msg& msg) {
+      CAF_CHECK_EQUAL(msg.congested, false);
+    }
+  );
+  close(fd);
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+void test_pause_reading() {
+  scoped_actor self;
+  auto server = spawn_io(pausing, self);
+  uint16_t port = 0;
+  self->receive(
+    [&](uint16_t x) {
+      port = x;
+    }
+  );
+  auto fd = connect_to(port);
+  connection_handle hdl;
+  self->receive(
+    [&](connection_handle x) {
+      hdl = x;
+    }
+  );
+  CAF_CHECK(write(fd, "hello", 5) == 5);
+  // the broker does not receive data while reading is paused
+  self->receive(
+    [&](const std::string& str) {
+      CAF_FAILURE("received data while paused: " << str);
+    },
+    after(std::chrono::milliseconds(100)) >> [] {
+      CAF_CHECKPOINT();
+    }
+  );
+  self->send(server, resume_atom::value, hdl);
+  self->receive(
+    [&](const std::string& str) {
+      CAF_CHECK_EQUAL(str, "hello");
+    }
+  );
+  close(fd);
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+// returns the integer carried by the next message forwarded by a proxy
+int next_forwarded(scoped_actor& self) {
+  int result = 0;
+  self->receive(
+    on(atom("_Dispatch"), arg_match) >> [&](const actor_addr&,
+                                            const actor_addr&, message_id,
+                                            const message& msg) {
+      result = msg.get_as<int>(0);
+    }
+  );
+  return result;
+}
+
+void test_congested_proxy() {
+  scoped_actor self;
+  auto proxy = make_counted<forwarding_actor_proxy>(
+                 42, detail::singletons::get_node_id(), self);
+  // this thread acts as the manager of the proxy
+  proxy->congested(true);
+  std::atomic<bool> sent{false};
+  std::thread sender{[&] {
+    proxy->enqueue(invalid_actor_addr, invalid_message_id,
+                   make_message(1), nullptr);
+    sent = true;
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CAF_CHECK(!sent);
+  // the manager never blocks itself
+  proxy->enqueue(invalid_actor_addr, invalid_message_id,
+                 make_message(2), nullptr);
+  CAF_CHECK_EQUAL(next_forwarded(self), 2);
+  proxy->congested(false);
+  sender.join();
+  CAF_CHECK(sent);
+  CAF_CHECK_EQUAL(next_forwarded(self), 1);
+  // killing a proxy releases blocked senders
+  proxy->congested(true);
+  sent = false;
+  std::thread other{[&] {
+    proxy->enqueue(invalid_actor_addr, invalid_message_id,
+                   make_message(3), nullptr);
+    sent = true;
+  }};
+  proxy->kill_proxy(exit_reason::remote_link_unreachable);
+  other.join();
+  CAF_CHECK(sent);
+}
+
+int main() {
+  CAF_TEST(test_backpressure);
+  test_backpressure();
+  test_pause_reading();
+  test_congested_proxy();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,248 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
+
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+#include "caf/io/basp.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using buffer = std::vector<char>;
+
+// node ID of the simulated peer using BASP version 1
+node_id v1_node() {
+  node_id::host_id_type hid;
+  hid.fill(0x2a);
+  return {42, hid};
+}
+
+void write_header(buffer& buf, const basp::header& hdr) {
+  binary_serializer bs{std::back_inserter(buf)};
+  bs.write(hdr.source_node, uniform_typeid<node_id>())
+    .write(hdr.dest_node, uniform_typeid<node_id>())
+    .write(hdr.source_actor)
+    .write(hdr.dest_actor)
+    .write(hdr.payload_len)
+    .write(hdr.operation)
+    .write(hdr.operation_data);
+}
+
+// a blocking TCP connection speaking BASP version 1
+class v1_peer {
+ public:
+  explicit v1_peer(int fd) : m_fd(fd) {
+    timeval tv{5, 0};
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  }
+
+  ~v1_peer() {
+    close(m_fd);
+  }
+
+  static int connect_to(uint16_t port) {
+    auto fd = socket(AF_INET, SOCK_STREAM, 0);
+    CAF_CHECK(fd >= 0);
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port = htons(port);
+    CAF_CHECK(connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) == 0);
+    return fd;
+  }
+
+  buffer receive(size_t num_bytes) {
+    buffer buf(num_bytes);
+    size_t pos = 0;
+    while (pos < num_bytes) {
+      auto res = recv(m_fd, buf.data() + pos, num_bytes - pos, 0);
+      if (res <= 0) {
+        CAF_FAILURE("connection closed or receive timed out");
+        buf.resize(pos);
+        return buf;
+      }
+      pos += static_cast<size_t>(res);
+    }
+    return buf;
+  }
+
+  basp::header receive_header() {
+    basp::header hdr;
+    auto buf = receive(basp::header_size);
+    if (buf.size() != basp::header_size) {
+      hdr.operation = 0xFFFFFFFF;
+      return hdr;
+    }
+    binary_deserializer bd{buf.data(), buf.size()};
+    bd.read(hdr.source_node, uniform_typeid<node_id>())
+      .read(hdr.dest_node, uniform_typeid<node_id>())
+      .read(hdr.source_actor)
+      .read(hdr.dest_actor)
+      .read(hdr.payload_len)
+      .read(hdr.operation)
+      .read(hdr.operation_data);
+    return hdr;
+  }
+
+  void send(const buffer& buf) {
+    auto res = ::send(m_fd, buf.data(), buf.size(), 0);
+    CAF_CHECK_EQUAL(res, static_cast<ssize_t>(buf.size()));
+  }
+
+ private:
+  int m_fd;
+};
+
+behavior reporter(event_based_actor* self, const actor& buddy) {
+  return {
+    others >> [=] {
+      self->forward_to(buddy);
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+void test_v1_client() {
+  scoped_actor self;
+  auto server = spawn(reporter, self);
+  auto port = publish(server, 0, "127.0.0.1");
+  CAF_CHECK(port != 0);
+  v1_peer peer{v1_peer::connect_to(port)};
+  // clients using BASP version 1 close the connection unless the
+  // server announces version 1 in operation_data
+  auto hdr = peer.receive_header();
+  CAF_CHECK_EQUAL(hdr.operation, basp::server_handshake);
+  CAF_CHECK_EQUAL(hdr.operation_data, 1);
+  CAF_CHECK(basp::server_handshake_valid(hdr));
+  auto payload = peer.receive(hdr.payload_len);
+  binary_deserializer bd{payload.data(), payload.size()};
+  CAF_CHECK_EQUAL(bd.read<uint32_t>(), server->id());
+  auto num_ifs = bd.read<uint32_t>();
+  for (uint32_t i = 0; i < num_ifs; ++i) {
+    bd.read<std::string>();
+  }
+  // version 1 clients ignore the trailing version of the server
+  CAF_CHECK_EQUAL(bd.remaining(), sizeof(uint64_t));
+  CAF_CHECK_EQUAL(bd.read<uint64_t>(), basp::version);
+  auto server_node = hdr.source_node;
+  // finish the handshake like a version 1 client and send a message
+  buffer buf;
+  write_header(buf, {v1_node(), server_node, invalid_actor_id,
+                     invalid_actor_id, 0, basp::client_handshake, 0});
+  buffer msg_buf;
+  binary_serializer bs{std::back_inserter(msg_buf)};
+  bs.write(make_message(42), uniform_typeid<message>());
+  write_header(buf, {v1_node(), server_node, invalid_actor_id, server->id(),
+                     static_cast<uint32_t>(msg_buf.size()),
+                     basp::dispatch_message, 0});
+  buf.insert(buf.end(), msg_buf.begin(), msg_buf.end());
+  peer.send(buf);
+  self->receive(
+    [](int value) {
+      CAF_CHECK_EQUAL(value, 42);
+    },
+    after(std::chrono::seconds(5)) >> [] {
+      CAF_FAILURE("server dropped the connection to a version 1 client");
+    }
+  );
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+void test_v1_server() {
+  auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  CAF_CHECK(fd >= 0);
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sa.sin_port = 0;
+  CAF_CHECK(bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) == 0);
+  CAF_CHECK(listen(fd, 1) == 0);
+  socklen_t len = sizeof(sa);
+  getsockname(fd, reinterpret_cast<sockaddr*>(&sa), &len);
+  auto port = ntohs(sa.sin_port);
+  constexpr actor_id remote_aid = 7;
+  std::thread client{[=] {
+    auto proxy = remote_actor("127.0.0.1", port);
+    CAF_CHECK(proxy != invalid_actor);
+    anon_send(proxy, 42);
+  }};
+  v1_peer peer{accept(fd, nullptr, nullptr)};
+  close(fd);
+  // a version 1 server announces its version and sends no trailing version
+  buffer payload;
+  binary_serializer bs{std::back_inserter(payload)};
+  bs << static_cast<uint32_t>(remote_aid) << static_cast<uint32_t>(0);
+  buffer buf;
+  write_header(buf, {v1_node(), invalid_node_id, remote_aid,
+                     invalid_actor_id, static_cast<uint32_t>(payload.size()),
+                     basp::server_handshake, 1});
+  buf.insert(buf.end(), payload.begin(), payload.end());
+  peer.send(buf);
+  // servers using BASP version 1 close the connection unless the
+  // client leaves operation_data zeroed
+  auto hdr = peer.receive_header();
+  CAF_CHECK_EQUAL(hdr.operation, basp::client_handshake);
+  CAF_CHECK_EQUAL(hdr.operation_data, 0);
+  CAF_CHECK(hdr.dest_node == v1_node());
+  // the client only uses operations known to version 1
+  for (;;) {
+    hdr = peer.receive_header();
+    if (hdr.payload_len > 0) {
+      peer.receive(hdr.payload_len);
+    }
+    if (hdr.operation != basp::announce_proxy_instance) {
+      break;
+    }
+  }
+  CAF_CHECK_EQUAL(hdr.operation, basp::dispatch_message);
+  CAF_CHECK_EQUAL(hdr.dest_actor, remote_aid);
+  client.join();
+}
+
+int main() {
+  CAF_TEST(test_basp_handshake);
+  test_v1_client();
+  test_v1_server();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -169,6 +169,7 @@ void run_server(bool spawn_client, const char* bin_path) {
 
 int main(int argc, char** argv) {
   CAF_TEST(test_broker);
+  CAF_CHECK(caf_uses_requested_multiplexer());
   message_builder{argv + 1, argv + argc}.apply({
      on("-c", arg_match) >> [&](const std::string& portstr) {
       auto port = static_cast<uint16_t>(std::stoi(portstr));
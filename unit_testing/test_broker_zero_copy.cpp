@@ -0,0 +1,167 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using buffer = std::vector<char>;
+
+constexpr size_t frame_size = 4;
+constexpr size_t num_frames = 8;
+
+uintptr_t addr_of(const buffer& buf) {
+  return reinterpret_cast<uintptr_t>(buf.data());
+}
+
+behavior forwarding(broker* self, const actor& buddy, bool by_value);
+
+// moves the buffer out of `new_data_msg` and sends it to `buddy` along
+// with the address of the buffer the stream has read into, i.e., the
+// buffer stored in the received message rather than the argument
+behavior moving(broker* self, const actor& buddy) {
+  return {
+    [=](new_data_msg&& msg) {
+      auto& received = self->current_message().get_as<new_data_msg>(0);
+      auto addr = addr_of(received.buf);
+      self->send(buddy, addr, std::move(msg.buf));
+      self->become(forwarding(self, buddy, true));
+    }
+  };
+}
+
+// like `moving`, but takes `new_data_msg` by value, i.e., the buffer
+// has been moved out of the received message already
+behavior moving_by_value(broker* self, const actor& buddy) {
+  return {
+    [=](new_data_msg msg) {
+      auto& received = self->current_message().get_as<new_data_msg>(0);
+      CAF_CHECK(received.buf.empty());
+      auto addr = addr_of(msg.buf);
+      self->send(buddy, addr, std::move(msg.buf));
+      self->become(forwarding(self, buddy, false));
+    }
+  };
+}
+
+// forwards `new_data_msg` to `buddy` after sending
+// the address of the received buffer
+behavior forwarding(broker* self, const actor& buddy, bool by_value) {
+  return {
+    [=](const new_data_msg& msg) {
+      self->send(buddy, addr_of(msg.buf));
+      self->send(buddy, self->current_message());
+      self->become(by_value ? moving_by_value(self, buddy)
+                            : moving(self, buddy));
+    }
+  };
+}
+
+behavior gateway(broker* self, const actor& buddy) {
+  auto port = self->add_tcp_doorman(uint16_t{0}).second;
+  self->send(buddy, port);
+  return {
+    [=](const new_connection_msg& msg) {
+      self->configure_read(msg.handle, receive_policy::exactly(frame_size));
+      self->become(moving(self, buddy));
+    }
+  };
+}
+
+void write_frames(uint16_t port) {
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sa.sin_port = htons(port);
+  auto fd = socket(AF_INET, SOCK_STREAM, 0);
+  CAF_CHECK(connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) == 0);
+  std::string data;
+  for (size_t i = 0; i < num_frames; ++i) {
+    data += "f" + std::to_string(i) + "__";
+  }
+  CAF_CHECK_EQUAL(write(fd, data.data(), data.size()),
+                  static_cast<ssize_t>(data.size()));
+  close(fd);
+}
+
+} // namespace <anonymous>
+
+void test_broker_zero_copy() {
+  scoped_actor self;
+  auto gw = spawn_io(gateway, self);
+  uint16_t port = 0;
+  self->receive(
+    [&](uint16_t x) {
+      port = x;
+    }
+  );
+  write_frames(port);
+  auto expected = [](size_t i) {
+    return "f" + std::to_string(i) + "__";
+  };
+  for (size_t i = 0; i < num_frames; i += 2) {
+    // moved buffer
+    self->receive(
+      [&](uintptr_t addr, const buffer& buf) {
+        CAF_CHECK_EQUAL(addr_of(buf), addr);
+        CAF_CHECK_EQUAL(std::string(buf.begin(), buf.end()), expected(i));
+      }
+    );
+    // forwarded message
+    uintptr_t addr = 0;
+    self->receive(
+      [&](uintptr_t x) {
+        addr = x;
+      }
+    );
+    self->receive(
+      [&](const new_data_msg& msg) {
+        CAF_CHECK_EQUAL(addr_of(msg.buf), addr);
+        CAF_CHECK_EQUAL(std::string(msg.buf.begin(), msg.buf.end()),
+                        expected(i + 1));
+      }
+    );
+  }
+  anon_send_exit(gw, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_broker_zero_copy);
+  test_broker_zero_copy();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/io/network/buffer_pool.hpp"
+
+using namespace caf;
+
+using io::network::buffer_pool;
+
+void test_size_classes() {
+  buffer_pool pool;
+  auto buf = pool.take(100);
+  CAF_CHECK(buf.empty());
+  CAF_CHECK_EQUAL(buf.capacity(), buffer_pool::min_capacity);
+  buf.resize(100);
+  auto data = buf.data();
+  pool.release(buf);
+  CAF_CHECK_EQUAL(buf.capacity(), 0);
+  CAF_CHECK_EQUAL(pool.cached_bytes(), buffer_pool::min_capacity);
+  // too large for the cached buffer
+  auto large = pool.take(1000);
+  CAF_CHECK(large.capacity() >= 1000);
+  CAF_CHECK(large.data() != data);
+  // the cached buffer is large enough
+  buf = pool.take(200);
+  CAF_CHECK(buf.empty());
+  CAF_CHECK(buf.data() == data);
+  CAF_CHECK_EQUAL(pool.cached_bytes(), 0);
+  // smaller requests fall back to larger buffers
+  auto large_data = large.data();
+  pool.release(large);
+  auto small = pool.take(0);
+  CAF_CHECK(small.data() == large_data);
+  // buffers exceeding the largest class are dropped
+  std::vector<char> huge;
+  huge.reserve(buffer_pool::max_capacity * 4);
+  pool.release(huge);
+  CAF_CHECK_EQUAL(huge.capacity(), 0);
+  CAF_CHECK_EQUAL(pool.cached_bytes(), 0);
+  // small requests never take buffers of the largest class
+  auto max_buf = pool.take(buffer_pool::max_capacity);
+  auto max_data = max_buf.data();
+  pool.release(max_buf);
+  auto wr_buf = pool.take(0);
+  CAF_CHECK(wr_buf.data() != max_data);
+  CAF_CHECK(wr_buf.capacity() < buffer_pool::max_capacity);
+  CAF_CHECK_EQUAL(pool.cached_bytes(), buffer_pool::max_capacity);
+}
+
+void test_bounded_cache() {
+  buffer_pool pool;
+  pool.max_cached_bytes(4 * 1024);
+  std::vector<std::vector<char>> bufs;
+  for (int i = 0; i < 8; ++i) {
+    bufs.push_back(pool.take(1024));
+  }
+  for (auto& buf : bufs) {
+    pool.release(buf);
+    CAF_CHECK_EQUAL(buf.capacity(), 0);
+  }
+  CAF_CHECK_EQUAL(pool.cached_bytes(), 4 * 1024);
+  CAF_CHECK_EQUAL(pool.high_water_mark(), 4 * 1024);
+  for (auto& buf : bufs) {
+    buf = pool.take(1024);
+  }
+  CAF_CHECK_EQUAL(pool.cached_bytes(), 0);
+  CAF_CHECK_EQUAL(pool.high_water_mark(), 4 * 1024);
+  // disables caching
+  pool.max_cached_bytes(0);
+  pool.release(bufs.front());
+  CAF_CHECK_EQUAL(pool.cached_bytes(), 0);
+}
+
+void test_initialized_buffers() {
+  buffer_pool pool;
+  auto buf = pool.take_initialized(100);
+  CAF_CHECK_EQUAL(buf.size(), buffer_pool::min_capacity);
+  CAF_CHECK_EQUAL(buf.size(), buf.capacity());
+  buf[0] = 'a';
+  auto data = buf.data();
+  pool.release(buf);
+  // readers get the buffer back without zero-filling it again
+  buf = pool.take_initialized(200);
+  CAF_CHECK(buf.data() == data);
+  CAF_CHECK_EQUAL(buf.size(), buffer_pool::min_capacity);
+  CAF_CHECK_EQUAL(buf[0], 'a');
+  pool.release(buf);
+  // writers always get empty buffers
+  buf = pool.take(0);
+  CAF_CHECK(buf.data() == data);
+  CAF_CHECK(buf.empty());
+}
+
+int main() {
+  CAF_TEST(test_buffer_pool);
+  test_size_classes();
+  test_bounded_cache();
+  test_initialized_buffers();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
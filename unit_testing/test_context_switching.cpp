@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/singletons.hpp"
+#include "caf/detail/detached_thread_pool.hpp"
+
+using namespace caf;
+
+namespace {
+
+constexpr size_t num_actors = 200;
+
+void blocking_counter(blocking_actor* self) {
+  int count = 0;
+  bool done = false;
+  self->receive_while([&] { return !done; })(
+    [&](int x) {
+      count += x;
+    },
+    on(atom("get")) >> [&] {
+      done = true;
+      return count;
+    }
+  );
+}
+
+void blocking_forwarder(blocking_actor* self, actor worker, actor client) {
+  self->receive_loop(
+    [=](int x) {
+      // sync_send from one context-switching actor to another
+      self->sync_send(worker, x).await(
+        [=](int res) {
+          self->send(client, res);
+        }
+      );
+    },
+    after(std::chrono::milliseconds(10)) >> [=] {
+      self->quit(exit_reason::user_shutdown);
+    }
+  );
+}
+
+void doubler(blocking_actor* self) {
+  self->receive_loop(
+    [](int x) {
+      return x * 2;
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+void test_many_blocking_actors() {
+  auto pool = detail::singletons::get_detached_thread_pool();
+  auto before = pool->stats();
+  scoped_actor self;
+  std::vector<actor> counters;
+  for (size_t i = 0; i < num_actors; ++i) {
+    counters.push_back(spawn<blocking_api + context_switching>(blocking_counter));
+  }
+  for (int i = 0; i < 100; ++i) {
+    for (auto& c : counters) {
+      self->send(c, 1);
+    }
+  }
+  for (auto& c : counters) {
+    self->sync_send(c, atom("get")).await(
+      [](int res) {
+        CAF_CHECK_EQUAL(res, 100);
+      }
+    );
+  }
+  self->await_all_other_actors_done();
+  auto after = pool->stats();
+  // none of the actors above must run in its own thread
+  CAF_CHECK(after.hits + after.misses - before.hits - before.misses
+            < num_actors);
+}
+
+void test_sync_send_between_fibers() {
+  scoped_actor self;
+  auto d = spawn<blocking_api + context_switching>(doubler);
+  auto f = spawn<blocking_api + context_switching>(blocking_forwarder, d,
+                                                   actor{self});
+  self->monitor(f);
+  self->send(f, 21);
+  self->receive(
+    [](int res) {
+      CAF_CHECK_EQUAL(res, 42);
+    }
+  );
+  self->receive(
+    [](const down_msg& dm) {
+      CAF_CHECK_EQUAL(dm.reason, exit_reason::user_shutdown);
+    },
+    after(std::chrono::seconds(5)) >> [] {
+      CAF_PRINTERR("context-switching actor did not time out");
+    }
+  );
+  anon_send_exit(d, exit_reason::user_shutdown);
+  self->await_all_other_actors_done();
+}
+
+void test_exception_in_fiber() {
+  scoped_actor self;
+  auto a = self->spawn<blocking_api + context_switching + monitored>(
+    [](blocking_actor* ptr) {
+      ptr->receive(
+        [](int) {
+          throw std::runtime_error("whatever");
+        }
+      );
+    }
+  );
+  self->send(a, 42);
+  self->receive(
+    [](const down_msg& dm) {
+      CAF_CHECK_EQUAL(dm.reason, exit_reason::unhandled_exception);
+    }
+  );
+}
+
+int main() {
+  CAF_TEST(test_context_switching);
+  test_many_blocking_actors();
+  test_sync_send_between_fibers();
+  test_exception_in_fiber();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,68 @@
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/singletons.hpp"
+#include "caf/detail/detached_thread_pool.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior adder() {
+  return {
+    [](int x, int y) {
+      return x + y;
+    }
+  };
+}
+
+void blocking_adder(blocking_actor* self) {
+  self->receive(
+    [](int x, int y) {
+      return x + y;
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+void test_detached_thread_pool() {
+  auto pool = detail::singletons::get_detached_thread_pool();
+  scoped_actor self;
+  for (int i = 0; i < 10; ++i) {
+    if (i > 0) {
+      // wait until the thread of the previous actor returned to the pool
+      auto deadline = std::chrono::steady_clock::now()
+                      + std::chrono::seconds(1);
+      while (pool->stats().idle_threads == 0
+             && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      CAF_CHECK(pool->stats().idle_threads > 0);
+    }
+    auto a = i % 2 == 0 ? spawn<detached>(adder)
+                        : spawn<detached + blocking_api>(blocking_adder);
+    self->sync_send(a, i, i).await(
+      [&](int res) {
+        CAF_CHECK_EQUAL(res, i + i);
+      }
+    );
+    anon_send_exit(a, exit_reason::user_shutdown);
+    self->await_all_other_actors_done();
+  }
+  auto stats = pool->stats();
+  // the timer and printer of the scheduler use the pool as well
+  CAF_CHECK(stats.hits + stats.misses >= 10);
+  CAF_CHECK(stats.hits >= 9);
+  CAF_CHECK(stats.idle_threads > 0);
+}
+
+int main() {
+  CAF_TEST(test_detached_thread_pool);
+  set_detached_thread_pool(4);
+  test_detached_thread_pool();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
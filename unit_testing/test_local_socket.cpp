@@ -0,0 +1,166 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+using calculator = typed_actor<replies_to<int>::with<int>>;
+
+behavior reporter(event_based_actor* self, const actor& buddy) {
+  return {
+    others >> [=] {
+      self->forward_to(buddy);
+    }
+  };
+}
+
+calculator::behavior_type doubler() {
+  return {
+    [](int x) {
+      return x * 2;
+    }
+  };
+}
+
+std::string socket_path(const char* name) {
+  return "/tmp/caf_test_" + std::to_string(getpid()) + "_" + name;
+}
+
+bool exists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+// leaves a socket file without a listening socket behind
+void make_stale_socket_file(const std::string& path) {
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sun_family = AF_UNIX;
+  strncpy(sa.sun_path, path.c_str(), sizeof(sa.sun_path) - 1);
+  CAF_CHECK_EQUAL(bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)), 0);
+  close(fd);
+}
+
+void run_client(const std::string& path1, const std::string& path2) {
+  auto a1 = io::remote_actor(path1);
+  auto a2 = io::typed_remote_actor<calculator>(path2);
+  CAF_CHECK(actor_cast<actor>(a2) != a1);
+  // lookups check the interface of the published actor
+  try {
+    io::remote_actor(path2);
+    CAF_FAILURE("unexpected: dynamically typed lookup of a typed actor");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  scoped_actor self;
+  self->sync_send(a2, 21).await(
+    [&](int x) {
+      CAF_CHECK_EQUAL(x, 42);
+      anon_send(a1, x);
+    }
+  );
+}
+
+} // namespace <anonymous>
+
+void test_local_socket(const char* app_path) {
+  scoped_actor self;
+  auto a1 = spawn(reporter, self);
+  auto a2 = spawn_typed(doubler);
+  auto path1 = socket_path("reporter");
+  auto path2 = socket_path("doubler");
+  // publishing replaces stale socket files of terminated processes
+  make_stale_socket_file(path1);
+  CAF_CHECK(exists(path1));
+  io::publish(a1, path1);
+  io::typed_publish(a2, path2);
+  // a path in use cannot be published again
+  try {
+    io::publish(a1, path2);
+    CAF_FAILURE("unexpected: published two actors at the same path");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  // connecting to a non-existing path fails
+  try {
+    io::remote_actor(socket_path("none"));
+    CAF_FAILURE("unexpected: connected to a non-existing path");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  auto child = run_program(self, app_path, "-c", path1, path2);
+  self->receive(
+    [](int x) {
+      CAF_CHECK_EQUAL(x, 42);
+    }
+  );
+  child.join();
+  self->receive(
+    [](const std::string& output) {
+      CAF_CHECK(output.find("ERROR") == std::string::npos);
+      CAF_PRINT("*** output of client program ***\n" << output);
+    }
+  );
+  // closing the acceptor removes the socket file
+  io::unpublish(a1);
+  CAF_CHECK(!exists(path1));
+  // the acceptor keeps a socket file another process put at its path
+  auto path3 = socket_path("replaced");
+  io::publish(a1, path3);
+  unlink(path3.c_str());
+  make_stale_socket_file(path3);
+  io::unpublish(a1);
+  CAF_CHECK(exists(path3));
+  unlink(path3.c_str());
+  anon_send_exit(a1, exit_reason::user_shutdown);
+  anon_send_exit(a2, exit_reason::user_shutdown);
+}
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_local_socket);
+  CAF_CHECK(caf_uses_requested_multiplexer());
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", arg_match) >> [](const std::string& p1, const std::string& p2) {
+      run_client(p1, p2);
+    },
+    on() >> [&] {
+      test_local_socket(argv[0]);
+    }
+  });
+  await_all_actors_done();
+  shutdown();
+  // the middleman removes the socket files of all its acceptors on shutdown
+  CAF_CHECK(!exists(socket_path("doubler")));
+  return CAF_TEST_RESULT();
+}
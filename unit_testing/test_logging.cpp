@@ -0,0 +1,171 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/logging.hpp"
+
+#ifndef CAF_LOG_LEVEL
+# error "test_logging requires CAF_LOG_LEVEL"
+#endif
+
+using namespace caf;
+using caf::detail::logging;
+
+namespace {
+
+// must be at least the capacity of the ring buffer of each thread
+constexpr int num_events = 1000;
+
+// grants access to the protected interface of the logger, i.e., allows
+// this test to run a logger without the singletons managing it
+struct logger_access : logging {
+  static logging* make() {
+    auto result = create_singleton();
+    (result->*&logger_access::initialize)();
+    return result;
+  }
+
+  static void stop_logger(logging* x) {
+    (x->*&logger_access::stop)();
+  }
+
+  static void dispose_logger(logging* x) {
+    (x->*&logger_access::dispose)();
+  }
+};
+
+// returns the names of all log files written by this process
+std::vector<std::string> log_files() {
+  std::vector<std::string> result;
+  auto prefix = "actor_log_" + std::to_string(getpid()) + "_";
+  auto dir = opendir(".");
+  if (!dir) {
+    return result;
+  }
+  while (auto entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+      result.push_back(std::move(name));
+    }
+  }
+  closedir(dir);
+  return result;
+}
+
+// counts the lines of all log files containing `str`
+int count_lines(const std::string& str) {
+  int result = 0;
+  for (auto& file : log_files()) {
+    std::ifstream in{file};
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.find(str) != std::string::npos) {
+        ++result;
+      }
+    }
+  }
+  return result;
+}
+
+void log_events(logging* logger, const char* tag) {
+  for (int i = 0; i < num_events; ++i) {
+    logging::stream() << tag << " " << i;
+    logger->log(CAF_INFO, "test", "log_events", __FILE__, __LINE__);
+  }
+}
+
+} // namespace <anonymous>
+
+void test_initial_level(int expected) {
+  CAF_CHECKPOINT();
+  CAF_CHECK_EQUAL(logging::level(), expected);
+}
+
+void test_accepts() {
+  CAF_CHECKPOINT();
+  auto initial = logging::level();
+  logging::level(CAF_INFO);
+  CAF_CHECK_EQUAL(logging::level(), std::min(CAF_INFO, CAF_LOG_LEVEL));
+  CAF_CHECK(logging::accepts(CAF_ERROR));
+  CAF_CHECK(logging::accepts(CAF_LOG_LEVEL < CAF_INFO ? CAF_LOG_LEVEL
+                                                      : CAF_INFO));
+  CAF_CHECK(!logging::accepts(CAF_DEBUG));
+  CAF_CHECK(!logging::accepts(CAF_TRACE));
+  // the runtime level cannot exceed the compile-time level
+  logging::level(CAF_TRACE + 1);
+  CAF_CHECK_EQUAL(logging::level(), CAF_LOG_LEVEL);
+  CAF_CHECK(!logging::accepts(CAF_LOG_LEVEL + 1));
+  logging::level(-1);
+  CAF_CHECK_EQUAL(logging::level(), CAF_ERROR);
+  CAF_CHECK(logging::accepts(CAF_ERROR));
+  CAF_CHECK(!logging::accepts(CAF_WARNING));
+  logging::level(initial);
+}
+
+void test_ring_buffer() {
+  CAF_CHECKPOINT();
+  auto logger = logger_access::make();
+  // fills the ring buffers of both threads several times
+  std::thread t{[=] { log_events(logger, "worker-event"); }};
+  log_events(logger, "main-event");
+  t.join();
+  logger_access::stop_logger(logger);
+  CAF_CHECK_EQUAL(count_lines("worker-event"), num_events);
+  CAF_CHECK_EQUAL(count_lines("main-event"), num_events);
+  // a stopped logger drops events instead of waiting for free slots
+  log_events(logger, "late-event");
+  CAF_CHECK_EQUAL(count_lines("late-event"), 0);
+  logger_access::dispose_logger(logger);
+  // a new logger starts over with a new ring buffer for this thread
+  logger = logger_access::make();
+  log_events(logger, "next-event");
+  logger_access::stop_logger(logger);
+  logger_access::dispose_logger(logger);
+  CAF_CHECK_EQUAL(count_lines("next-event"), num_events);
+  for (auto& file : log_files()) {
+    remove(file.c_str());
+  }
+}
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_logging);
+  // the unit tests pass the level expected for $CAF_LOG_LEVEL as argument
+  if (argc > 1) {
+    test_initial_level(atoi(argv[1]));
+  } else if (!getenv("CAF_LOG_LEVEL")) {
+    test_initial_level(CAF_LOG_LEVEL);
+  }
+  test_accepts();
+  test_ring_buffer();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -174,11 +174,157 @@ void test_arg_match() {
   CAF_CHECK_EQUAL(invoked(expr3, wrapped_int{42}, wrapped_int{1}), 0);
 }
 
+// behaviors with many cases use a dispatch index that must
+// preserve first-match semantics including wildcards
+void test_dispatch_index() {
+  int selected = -1;
+  auto sel = [&](int idx) {
+    return [=, &selected] {
+      selected = idx;
+    };
+  };
+  message_handler expr{
+    on(42) >> sel(0),
+    on<int>() >> sel(1),
+    on<double>() >> sel(2),
+    on<string>() >> sel(3),
+    on<int, int>() >> sel(4),
+    on(atom("foo"), any_vals) >> sel(5),
+    on<float>() >> sel(6),
+    on<int, string>() >> sel(7),
+    others >> sel(8),
+    on<char>() >> sel(9)
+  };
+  auto invoked_case = [&](message msg) {
+    selected = -1;
+    expr(msg);
+    return selected;
+  };
+  CAF_CHECK_EQUAL(invoked_case(make_message(42)), 0);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1)), 1);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1.)), 2);
+  CAF_CHECK_EQUAL(invoked_case(make_message("a")), 3);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1, 2)), 4);
+  CAF_CHECK_EQUAL(invoked_case(make_message(atom("foo"), 1)), 5);
+  CAF_CHECK_EQUAL(invoked_case(make_message(atom("bar"), 1)), 8);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1.f)), 6);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1, "a")), 7);
+  // the wildcard case precedes the case for char
+  CAF_CHECK_EQUAL(invoked_case(make_message('a')), 8);
+  CAF_CHECK_EQUAL(invoked_case(make_message(1, 2, 3)), 8);
+}
+
+// cases with leading atom constants are selected by the atom value
+void test_atom_dispatch() {
+  for (auto wildcard_first : {false, true}) {
+    int selected = -1;
+    auto sel = [&](int idx) {
+      return [=, &selected] {
+        selected = idx;
+      };
+    };
+    std::vector<message_handler> hs;
+    if (wildcard_first) {
+      hs.push_back(message_handler{on(hi_atom::value, any_vals) >> sel(10)});
+    }
+    hs.push_back(message_handler{
+      [&](get_atom) { selected = 0; },
+      [&](put_atom) { selected = 1; },
+      [&](get_atom, int) { selected = 2; },
+      [&](put_atom, int) { selected = 3; },
+      [&](ok_atom, int) { selected = 4; },
+      [&](error_atom, int) { selected = 5; },
+      [&](atom_value, int) { selected = 6; },
+      [&](join_atom) { selected = 7; },
+      on(leave_atom::value, any_vals) >> sel(8),
+      [&](int) { selected = 9; }
+    });
+    auto expr = hs.front();
+    for (size_t i = 1; i < hs.size(); ++i) {
+      expr = expr.or_else(hs[i]);
+    }
+    auto invoked_case = [&](message msg) {
+      selected = -1;
+      expr(msg);
+      return selected;
+    };
+    CAF_CHECK_EQUAL(invoked_case(make_message(get_atom::value)), 0);
+    CAF_CHECK_EQUAL(invoked_case(make_message(put_atom::value)), 1);
+    CAF_CHECK_EQUAL(invoked_case(make_message(get_atom::value, 1)), 2);
+    CAF_CHECK_EQUAL(invoked_case(make_message(put_atom::value, 1)), 3);
+    CAF_CHECK_EQUAL(invoked_case(make_message(ok_atom::value, 1)), 4);
+    CAF_CHECK_EQUAL(invoked_case(make_message(error_atom::value, 1)), 5);
+    CAF_CHECK_EQUAL(invoked_case(make_message(sys_atom::value, 1)), 6);
+    CAF_CHECK_EQUAL(invoked_case(make_message(join_atom::value)), 7);
+    CAF_CHECK_EQUAL(invoked_case(make_message(leave_atom::value, 1, 2)), 8);
+    CAF_CHECK_EQUAL(invoked_case(make_message(1)), 9);
+    CAF_CHECK_EQUAL(invoked_case(make_message(sys_atom::value)), -1);
+    CAF_CHECK_EQUAL(invoked_case(make_message(hi_atom::value)),
+                    wildcard_first ? 10 : -1);
+  }
+}
+
+// only a received message that is not shared moves its
+// content into rvalue reference parameters
+void test_move_out() {
+  using buf = vector<char>;
+  const char* received = nullptr;
+  auto take_buf = [&](buf x) { received = x.data(); };
+  behavior by_value{take_buf};
+  auto consume_buf = [&](buf&& x) {
+    buf tmp{std::move(x)};
+    received = tmp.data();
+  };
+  behavior by_rvalue{consume_buf};
+  behavior skipping{
+    [&](buf&& x) -> skip_message_t {
+      buf tmp{std::move(x)};
+      received = tmp.data();
+      return skip_message();
+    }
+  };
+  auto msg = make_message(buf(1024, 'a'));
+  auto payload = msg.get_as<buf>(0).data();
+  // the caller of apply() keeps using its message
+  msg.apply(message_handler{consume_buf});
+  CAF_CHECK(received != payload);
+  CAF_CHECK(msg.get_as<buf>(0).data() == payload);
+  msg.apply(message_handler{take_buf});
+  CAF_CHECK(received != payload);
+  CAF_CHECK(msg.get_as<buf>(0).data() == payload);
+  // a message sharing its content with another handle must remain intact
+  auto copy = msg;
+  by_rvalue.consume(msg);
+  CAF_CHECK(received != payload);
+  CAF_CHECK(copy.get_as<buf>(0).data() == payload);
+  by_value.consume(msg);
+  CAF_CHECK(received != payload);
+  CAF_CHECK(copy.get_as<buf>(0).data() == payload);
+  copy = message{};
+  // a skipped message is processed again later and thus remains intact
+  skipping.consume(msg);
+  CAF_CHECK(received != payload);
+  CAF_CHECK(msg.get_as<buf>(0).data() == payload);
+  // a received message that is not shared moves its content
+  by_rvalue.consume(msg);
+  CAF_CHECK(received == payload);
+  CAF_CHECK(msg.get_as<buf>(0).empty());
+  // ... into by-value parameters as well
+  msg = make_message(buf(1024, 'b'));
+  payload = msg.get_as<buf>(0).data();
+  by_value.consume(msg);
+  CAF_CHECK(received == payload);
+  CAF_CHECK(msg.get_as<buf>(0).empty());
+}
+
 int main() {
   CAF_TEST(test_match);
   test_atoms();
   test_custom_projections();
   test_arg_match();
+  test_dispatch_index();
+  test_atom_dispatch();
+  test_move_out();
   shutdown();
   return CAF_TEST_RESULT();
 }
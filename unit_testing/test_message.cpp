@@ -19,6 +19,8 @@
 
 #include "test.hpp"
 #include "caf/message.hpp"
+#include "caf/message_builder.hpp"
+#include "caf/mailbox_element.hpp"
 
 using std::cout;
 using std::endl;
@@ -118,6 +120,80 @@ void test_concat() {
                   to_string(m4));
 }
 
+namespace {
+
+int s_tracked_instances = 0;
+
+struct tracked {
+  tracked() {
+    ++s_tracked_instances;
+  }
+  tracked(const tracked&) {
+    ++s_tracked_instances;
+  }
+  ~tracked() {
+    --s_tracked_instances;
+  }
+};
+
+bool is_inlined(const mailbox_element* ptr, const detail::message_data* data) {
+  auto dist = reinterpret_cast<const char*>(ptr)
+              - reinterpret_cast<const char*>(data);
+  return dist > 0 && static_cast<size_t>(dist) < 2 * detail::mailbox_slot_size;
+}
+
+} // namespace <anonymous>
+
+message make_slotted_message() {
+  message_builder mb{detail::mailbox_slot};
+  mb.append(1).append(std::string("hello"));
+  return mb.move_to_message();
+}
+
+void test_mailbox_slot() {
+  auto msg = make_slotted_message();
+  auto data = msg.cvals().get();
+  auto ptr = mailbox_element::make(invalid_actor_addr, message_id::make(),
+                                   std::move(msg));
+  CAF_CHECK(is_inlined(ptr.get(), data));
+  // the element keeps the memory block alive after releasing its content
+  msg = std::move(ptr->msg);
+  ptr.reset();
+  CAF_CHECK_EQUAL(to_string(msg),
+                  to_string(make_message(1, std::string("hello"))));
+  // the slot was already claimed by the first element
+  ptr = mailbox_element::make(invalid_actor_addr, message_id::make(),
+                              std::move(msg));
+  CAF_CHECK(!is_inlined(ptr.get(), data));
+  ptr.reset();
+  // shared messages never use the slot
+  msg = make_slotted_message();
+  data = msg.cvals().get();
+  auto copy = msg;
+  ptr = mailbox_element::make(invalid_actor_addr, message_id::make(),
+                              std::move(msg));
+  CAF_CHECK(!is_inlined(ptr.get(), data));
+  ptr.reset();
+  copy = message{};
+  // the content can be destroyed before the element
+  msg = make_slotted_message();
+  data = msg.cvals().get();
+  ptr = mailbox_element::make(invalid_actor_addr, message_id::make(),
+                              std::move(msg));
+  CAF_CHECK(is_inlined(ptr.get(), data));
+  ptr->msg = message{};
+  ptr.reset();
+  // messages created by make_message do not reserve a slot
+  msg = make_message(1, tracked{});
+  data = msg.cvals().get();
+  ptr = mailbox_element::make(invalid_actor_addr, message_id::make(),
+                              std::move(msg));
+  CAF_CHECK(!is_inlined(ptr.get(), data));
+  CAF_CHECK_EQUAL(s_tracked_instances, 1);
+  ptr.reset();
+  CAF_CHECK_EQUAL(s_tracked_instances, 0);
+}
+
 int main() {
   CAF_TEST(message);
   test_drop();
@@ -130,6 +206,7 @@ int main() {
   test_extract_opts();
   test_type_token();
   test_concat();
+  test_mailbox_slot();
   shutdown();
   return CAF_TEST_RESULT();
 }
@@ -0,0 +1,139 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include <new>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iterator>
+
+#include "caf/all.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+#include "caf/detail/message_arena.hpp"
+
+using namespace caf;
+
+using detail::message_arena;
+
+namespace {
+
+std::atomic<size_t> s_allocations{0};
+
+using buffer = std::vector<char>;
+
+buffer serialize(const message& msg) {
+  buffer result;
+  binary_serializer bs{std::back_inserter(result)};
+  bs.write(msg, uniform_typeid<message>());
+  return result;
+}
+
+message deserialize(const buffer& buf) {
+  binary_deserializer bd{buf.data(), buf.size()};
+  message result;
+  bd.read(result, uniform_typeid<message>());
+  return result;
+}
+
+// deserializes all buffers and returns the number of heap allocations
+size_t count_allocations(const std::vector<buffer>& bufs,
+                         std::vector<message>& out, message_arena* arena) {
+  auto before = s_allocations.load();
+  for (auto& buf : bufs) {
+    if (arena) {
+      message_arena::scope guard{*arena};
+      out.push_back(deserialize(buf));
+    } else {
+      out.push_back(deserialize(buf));
+    }
+  }
+  return s_allocations.load() - before;
+}
+
+} // namespace <anonymous>
+
+void* operator new(size_t size) {
+  ++s_allocations;
+  auto result = malloc(size);
+  if (!result) {
+    throw std::bad_alloc{};
+  }
+  return result;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void test_allocation_count() {
+  constexpr size_t num_messages = 1000;
+  std::vector<buffer> bufs;
+  for (size_t i = 0; i < num_messages; ++i) {
+    bufs.push_back(serialize(make_message(ok_atom::value, static_cast<uint64_t>(i), 1.5)));
+  }
+  std::vector<message> heap_msgs;
+  std::vector<message> arena_msgs;
+  heap_msgs.reserve(num_messages);
+  arena_msgs.reserve(num_messages);
+  auto heap = count_allocations(bufs, heap_msgs, nullptr);
+  message_arena arena;
+  auto arena_allocs = count_allocations(bufs, arena_msgs, &arena);
+  CAF_PRINT("heap allocations for " << num_messages << " messages: "
+            << heap << " without arena, " << arena_allocs << " with arena");
+  CAF_CHECK(arena_allocs < heap);
+  CAF_CHECK(heap_msgs == arena_msgs);
+  CAF_CHECK((arena_msgs.back().match_elements<atom_value, uint64_t, double>()));
+  CAF_CHECK_EQUAL(arena_msgs.back().get_as<uint64_t>(1), num_messages - 1);
+}
+
+void test_chunk_lifetime() {
+  CAF_CHECK_EQUAL(message_arena::num_chunks(), 0);
+  std::vector<message> msgs;
+  auto buf = serialize(make_message(1, 2, 3));
+  { // lifetime scope of arena
+    message_arena arena;
+    for (int i = 0; i < 10; ++i) {
+      message_arena::scope guard{arena};
+      msgs.push_back(deserialize(buf));
+    }
+    CAF_CHECK_EQUAL(message_arena::num_chunks(), 1);
+  }
+  // messages keep their chunk alive after the arena has been destroyed
+  CAF_CHECK_EQUAL(message_arena::num_chunks(), 1);
+  CAF_CHECK(msgs.back() == make_message(1, 2, 3));
+  // messages can be released by any thread
+  std::thread t{[&] {
+    msgs.clear();
+  }};
+  t.join();
+  CAF_CHECK_EQUAL(message_arena::num_chunks(), 0);
+}
+
+int main() {
+  CAF_TEST(message_arena);
+  test_allocation_count();
+  test_chunk_lifetime();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
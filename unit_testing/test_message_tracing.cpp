@@ -0,0 +1,139 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior doubler() {
+  return {
+    [](int x) {
+      return x * 2;
+    }
+  };
+}
+
+behavior forwarder(event_based_actor* self, const actor& dest) {
+  return {
+    [=](int) {
+      self->forward_to(dest);
+    }
+  };
+}
+
+// sends a request through forwarder and doubler and awaits the result
+void run_pipeline(scoped_actor& self, const actor& first) {
+  self->send(first, 21);
+  self->receive(
+    [](int res) {
+      CAF_CHECK_EQUAL(res, 42);
+    }
+  );
+}
+
+const message_span* find_span(const std::vector<message_span>& xs,
+                              uint64_t trace_id, uint64_t parent_id) {
+  for (auto& x : xs) {
+    if (x.trace_id == trace_id && x.parent_id == parent_id) {
+      return &x;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace <anonymous>
+
+void test_message_tracing() {
+  scoped_actor self;
+  auto d = spawn(doubler);
+  auto f = spawn(forwarder, d);
+  set_message_tracing_rate(1.);
+  CAF_CHECK_EQUAL(message_tracing_rate(), 1.);
+  run_pipeline(self, f);
+  set_message_tracing_rate(0.);
+  auto spans = take_message_spans();
+  // find the root span: self -> forwarder
+  const message_span* root = nullptr;
+  for (auto& x : spans) {
+    if (x.parent_id == 0 && x.receiver == f.id()) {
+      root = &x;
+    }
+  }
+  CAF_CHECK(root != nullptr);
+  if (root) {
+    CAF_CHECK_EQUAL(root->sender, self->id());
+    CAF_CHECK(root->enqueued <= root->dequeued);
+    CAF_CHECK(root->dequeued <= root->completed);
+    // forwarder -> doubler
+    auto hop = find_span(spans, root->trace_id, root->span_id);
+    CAF_CHECK(hop != nullptr);
+    if (hop) {
+      CAF_CHECK_EQUAL(hop->receiver, d.id());
+      // doubler -> self
+      auto response = find_span(spans, root->trace_id, hop->span_id);
+      CAF_CHECK(response != nullptr);
+      if (response) {
+        CAF_CHECK_EQUAL(response->sender, d.id());
+        CAF_CHECK_EQUAL(response->receiver, self->id());
+      }
+    }
+  }
+  // messages are no longer traced after disabling tracing
+  run_pipeline(self, f);
+  CAF_CHECK(take_message_spans().empty());
+  // collect spans of a second run to a file
+  set_message_tracing_rate(1.);
+  run_pipeline(self, f);
+  set_message_tracing_rate(0.);
+  auto path = std::string{"test_message_tracing.json"};
+  auto collector = spawn_trace_collector(path);
+  self->monitor(collector);
+  self->send_exit(collector, exit_reason::user_shutdown);
+  self->receive(
+    [](const down_msg&) {
+      // nop
+    }
+  );
+  std::ifstream in{path};
+  std::string content{std::istreambuf_iterator<char>{in},
+                      std::istreambuf_iterator<char>{}};
+  CAF_CHECK(content.size() > 2 && content.front() == '[');
+  CAF_CHECK(content.find("\"ph\":\"X\"") != std::string::npos);
+  CAF_CHECK(content.find("]") != std::string::npos);
+  in.close();
+  std::remove(path.c_str());
+  self->send_exit(f, exit_reason::user_shutdown);
+  self->send_exit(d, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_message_tracing);
+  test_message_tracing();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
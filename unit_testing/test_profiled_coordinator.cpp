@@ -1,12 +1,99 @@
+#include <set>
+#include <cstdio>
+#include <algorithm>
+#include <sstream>
+
 #include "test.hpp"
 
+#include "caf/all.hpp"
 #include "caf/scheduler/profiled_coordinator.hpp"
 
 using namespace caf;
 
+using coordinator_type = scheduler::profiled_coordinator<>;
+
+namespace {
+
+constexpr const char* filename = "test_profiled_coordinator.bin";
+
+} // namespace <anonymous>
+
+void test_binary_format() {
+  coordinator_type::record x;
+  x.clock = coordinator_type::usec{42};
+  x.is_actor = true;
+  x.id = 7;
+  x.worker = 3;
+  x.resumes = 100;
+  x.value.time = coordinator_type::usec{1000};
+  x.value.usr = coordinator_type::usec{600};
+  x.value.sys = coordinator_type::usec{200};
+  std::stringstream buf;
+  coordinator_type::write_binary(buf, x);
+  coordinator_type::record y;
+  CAF_CHECK(coordinator_type::read_binary(buf, y));
+  CAF_CHECK(y.clock == x.clock);
+  CAF_CHECK(y.is_actor);
+  CAF_CHECK_EQUAL(y.id, 7);
+  CAF_CHECK_EQUAL(y.worker, 3);
+  CAF_CHECK_EQUAL(y.resumes, 100);
+  CAF_CHECK(y.value.time == x.value.time);
+  CAF_CHECK(y.value.usr == x.value.usr);
+  CAF_CHECK(y.value.sys == x.value.sys);
+  std::stringstream garbage{"not a profiler output"};
+  std::ostringstream out;
+  CAF_CHECK(!coordinator_type::decode(garbage, out));
+}
+
+void test_profiled_coordinator() {
+  set_scheduler(new coordinator_type{filename, coordinator_type::msec{10}, 4,
+                                     std::numeric_limits<size_t>::max(),
+                                     coordinator_type::output_format::binary});
+  { // lifetime scope of self
+    scoped_actor self;
+    auto adder = spawn([]() -> behavior {
+      return {
+        [](int x, int y) {
+          return x + y;
+        }
+      };
+    });
+    for (int i = 0; i < 100; ++i) {
+      self->sync_send(adder, i, i).await(
+        [&](int res) {
+          CAF_CHECK_EQUAL(res, i + i);
+        }
+      );
+    }
+    self->send_exit(adder, exit_reason::user_shutdown);
+  }
+  await_all_actors_done();
+  shutdown();
+  std::ifstream in{filename, std::ios::binary};
+  std::ostringstream out;
+  CAF_CHECK(coordinator_type::decode(in, out));
+  auto str = out.str();
+  // expect at least one record per worker in addition to the header
+  CAF_CHECK(std::count(str.begin(), str.end(), '\n') > 4);
+  CAF_CHECK(str.find("actor") != std::string::npos);
+  // each worker writes its final state on shutdown, even if it was idle
+  in.clear();
+  in.seekg(sizeof(coordinator_type::binary_magic));
+  std::set<size_t> flushed_workers;
+  coordinator_type::record r;
+  while (coordinator_type::read_binary(in, r)) {
+    if (!r.is_actor) {
+      flushed_workers.insert(r.worker);
+    }
+  }
+  CAF_CHECK_EQUAL(flushed_workers.size(), 4);
+  in.close();
+  std::remove(filename);
+}
+
 int main() {
   CAF_TEST(test_profiled_coordinator);
-  set_scheduler(new scheduler::profiled_coordinator<>{"/dev/null"});
-  shutdown();
+  test_binary_format();
+  test_profiled_coordinator();
   return CAF_TEST_RESULT();
 }
@@ -414,6 +414,7 @@ void test_remote_actor(const char* app_path, bool run_remote_actor) {
 
 int main(int argc, char** argv) {
   CAF_TEST(test_remote_actor);
+  CAF_CHECK(caf_uses_requested_multiplexer());
   announce<actor_vector>("actor_vector");
   cout << "this node is: " << to_string(caf::detail::singletons::get_node_id())
        << endl;
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+
+using std::chrono::milliseconds;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+
+namespace {
+
+behavior dummy() {
+  return {
+    others >> [] {
+      // nop
+    }
+  };
+}
+
+// a listening socket that never accepts connections; its backlog is
+// exhausted by the constructor, causing further SYNs to get dropped
+class blackhole {
+ public:
+  blackhole() {
+    sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    m_listener = socket(AF_INET, SOCK_STREAM, 0);
+    bind(m_listener, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+    listen(m_listener, 0);
+    socklen_t len = sizeof(sa);
+    getsockname(m_listener, reinterpret_cast<sockaddr*>(&sa), &len);
+    m_port = ntohs(sa.sin_port);
+    for (int i = 0; i < 4; ++i) {
+      auto fd = socket(AF_INET, SOCK_STREAM, 0);
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+      connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+      m_fillers.push_back(fd);
+    }
+    std::this_thread::sleep_for(milliseconds(100));
+  }
+
+  ~blackhole() {
+    for (auto fd : m_fillers) {
+      close(fd);
+    }
+    close(m_listener);
+  }
+
+  uint16_t port() const {
+    return m_port;
+  }
+
+ private:
+  int m_listener;
+  uint16_t m_port;
+  std::vector<int> m_fillers;
+};
+
+} // namespace <anonymous>
+
+void test_remote_connect() {
+  auto d = spawn(dummy);
+  auto port = io::publish(d, 0);
+  auto mm = io::middleman::instance();
+  mm->connect_timeout(milliseconds(1000));
+  CAF_CHECK_EQUAL(mm->connect_timeout().count(), 1000);
+  blackhole bh;
+  auto start = steady_clock::now();
+  auto elapsed = [&] {
+    return duration_cast<milliseconds>(steady_clock::now() - start).count();
+  };
+  // connect to the blackhole in the background
+  std::thread t{[&] {
+    try {
+      io::remote_actor("127.0.0.1", bh.port());
+      CAF_FAILURE("unexpected: connected to blackhole");
+    } catch (network_error& err) {
+      CAF_CHECK(std::string{err.what()}.find("timed out") != std::string::npos);
+    }
+  }};
+  std::this_thread::sleep_for(milliseconds(100));
+  // pending connects must not stall other requests
+  auto ra = io::remote_actor("127.0.0.1", port);
+  CAF_CHECK(ra == d);
+  CAF_CHECK(elapsed() < 900);
+  // host names are resolved in the background as well
+  ra = io::remote_actor("localhost", port);
+  CAF_CHECK(ra == d);
+  CAF_CHECK(elapsed() < 900);
+  // refused connections fail immediately
+  try {
+    io::remote_actor("127.0.0.1", bh.port() == 1 ? 2 : 1);
+    CAF_FAILURE("unexpected: connected to unused port");
+  } catch (network_error&) {
+    CAF_CHECK(elapsed() < 900);
+  }
+  t.join();
+  CAF_CHECK(elapsed() >= 1000);
+  anon_send_exit(d, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_remote_connect);
+  CAF_CHECK(caf_uses_requested_multiplexer());
+  test_remote_connect();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+constexpr size_t num_concurrent_lookups = 4;
+
+using calculator = typed_actor<replies_to<int>::with<int>>;
+
+behavior reporter(event_based_actor* self, const actor& buddy) {
+  return {
+    others >> [=] {
+      self->forward_to(buddy);
+    }
+  };
+}
+
+calculator::behavior_type doubler() {
+  return {
+    [](int x) {
+      return x * 2;
+    }
+  };
+}
+
+// counts TCP sockets of this machine connected to `port`, including
+// sockets in TIME_WAIT that have been closed recently
+int connections_to(uint16_t port) {
+  std::ifstream in{"/proc/net/tcp"};
+  std::string line;
+  std::getline(in, line); // skip header
+  int result = 0;
+  while (std::getline(in, line)) {
+    std::istringstream iss{line};
+    std::string slot;
+    std::string local;
+    std::string remote;
+    iss >> slot >> local >> remote;
+    auto pos = remote.find(':');
+    if (pos != std::string::npos
+        && std::stoul(remote.substr(pos + 1), nullptr, 16) == port) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+void run_client(uint16_t port1, uint16_t port2) {
+  // concurrent lookups share a single connection
+  std::vector<actor> results(num_concurrent_lookups);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_concurrent_lookups; ++i) {
+    threads.emplace_back([&, i] {
+      results[i] = io::remote_actor("127.0.0.1", port1);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto a1 = results.front();
+  for (auto& x : results) {
+    CAF_CHECK(x == a1);
+  }
+  // a different port may belong to a different node, i.e., the first
+  // lookup connects while further lookups re-use known connections
+  auto a2 = io::typed_remote_actor<calculator>("127.0.0.1", port2);
+  CAF_CHECK(actor_cast<actor>(a2) != a1);
+  CAF_CHECK(io::remote_actor("127.0.0.1", port1) == a1);
+  CAF_CHECK(io::typed_remote_actor<calculator>("127.0.0.1", port2) == a2);
+  // lookups via an existing connection still check the interface
+  try {
+    io::remote_actor("127.0.0.1", port2);
+    CAF_FAILURE("unexpected: dynamically typed lookup of a typed actor");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  scoped_actor self;
+  self->sync_send(a2, 21).await(
+    [](int x) {
+      CAF_CHECK_EQUAL(x, 42);
+    }
+  );
+  anon_send(a1, connections_to(port1), connections_to(port2));
+}
+
+} // namespace <anonymous>
+
+void test_remote_lookup(const char* app_path) {
+  scoped_actor self;
+  auto a1 = spawn(reporter, self);
+  auto a2 = spawn_typed(doubler);
+  auto port1 = io::publish(a1, 0, "127.0.0.1");
+  auto port2 = io::typed_publish(a2, 0, "127.0.0.1");
+  auto child = run_program(self, app_path, "-c", port1, port2);
+  self->receive(
+    [&](int connections1, int connections2) {
+      CAF_CHECK_EQUAL(connections1, 1);
+      CAF_CHECK_EQUAL(connections2, 1);
+    }
+  );
+  child.join();
+  self->receive(
+    [](const std::string& output) {
+      CAF_CHECK(output.find("ERROR") == std::string::npos);
+      CAF_PRINT("*** output of client program ***\n" << output);
+    }
+  );
+  anon_send_exit(a1, exit_reason::user_shutdown);
+  anon_send_exit(a2, exit_reason::user_shutdown);
+}
+
+int main(int argc, char** argv) {
+  CAF_TEST(test_remote_lookup);
+  message_builder{argv + 1, argv + argc}.apply({
+    on("-c", spro<uint16_t>, spro<uint16_t>) >> [](uint16_t p1, uint16_t p2) {
+      run_client(p1, p2);
+    },
+    on() >> [&] {
+      test_remote_lookup(argv[0]);
+    }
+  });
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
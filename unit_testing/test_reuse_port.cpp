@@ -0,0 +1,116 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <thread>
+#include <vector>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior dummy() {
+  return {
+    others >> [] {
+      // nop
+    }
+  };
+}
+
+// opens `num` raw TCP connections to `port` and returns how many succeeded
+size_t connection_storm(uint16_t port, size_t num) {
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sa.sin_port = htons(port);
+  std::vector<int> fds;
+  size_t connected = 0;
+  for (size_t i = 0; i < num; ++i) {
+    auto fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) == 0) {
+      ++connected;
+    }
+    fds.push_back(fd);
+  }
+  for (auto fd : fds) {
+    close(fd);
+  }
+  return connected;
+}
+
+} // namespace <anonymous>
+
+void test_reuse_port() {
+  auto mm = io::middleman::instance();
+  mm->acceptors_per_port(4);
+  CAF_CHECK_EQUAL(mm->acceptors_per_port(), 4);
+  auto d = spawn(dummy);
+  auto port = io::publish(d, 0);
+  CAF_CHECKPOINT();
+  CAF_CHECK_EQUAL(connection_storm(port, 200), 200);
+  // all acceptors forward connections to the published actor
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 8; ++i) {
+    clients.emplace_back([=] {
+      CAF_CHECK(io::remote_actor("127.0.0.1", port) == d);
+    });
+  }
+  for (auto& t : clients) {
+    t.join();
+  }
+  // other actors cannot join the port, but the published actor can
+  auto d2 = spawn(dummy);
+  try {
+    io::publish(d2, port);
+    CAF_FAILURE("unexpected: published two actors at the same port!");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  CAF_CHECK_EQUAL(io::publish(d, port), port);
+  anon_send_exit(d2, exit_reason::user_shutdown);
+  // unpublishing closes all acceptors of the port
+  io::unpublish(d, port);
+  try {
+    io::remote_actor("127.0.0.1", port);
+    CAF_FAILURE("unexpected: remote actor succeeded!");
+  } catch (network_error&) {
+    CAF_CHECKPOINT();
+  }
+  mm->acceptors_per_port(1);
+  anon_send_exit(d, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_reuse_port);
+  test_reuse_port();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/single_reader_queue.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct iint {
+  iint* next;
+  iint* prev;
+  int value;
+  iint(int val = 0) : next(nullptr), prev(nullptr), value(val) {
+    // nop
+  }
+};
+
+using iint_queue = detail::single_reader_queue<iint>;
+
+} // namespace <anonymous>
+
+void test_adaptive_spin_count() {
+  CAF_CHECKPOINT();
+  iint_queue q;
+  std::mutex mtx;
+  std::condition_variable cv;
+  auto expected = iint_queue::min_spin_count;
+  CAF_CHECK_EQUAL(q.spin_count(), expected);
+  // finding data while spinning doubles the number of polls
+  for (int i = 0; i < 10; ++i) {
+    q.enqueue(new iint(i));
+    q.synchronized_await(mtx, cv);
+    expected = std::min(expected * 2, iint_queue::max_spin_count);
+    CAF_CHECK_EQUAL(q.spin_count(), expected);
+    delete q.try_pop();
+  }
+  CAF_CHECK_EQUAL(q.spin_count(), iint_queue::max_spin_count);
+  // spinning in vain halves the number of polls
+  for (int i = 0; i < 10; ++i) {
+    CAF_CHECK(!q.synchronized_await(mtx, cv, std::chrono::steady_clock::now()));
+    expected = std::max(expected / 2, iint_queue::min_spin_count);
+    CAF_CHECK_EQUAL(q.spin_count(), expected);
+  }
+  CAF_CHECK_EQUAL(q.spin_count(), iint_queue::min_spin_count);
+}
+
+template <class Await>
+void test_synchronized_await(Await await) {
+  CAF_CHECKPOINT();
+  iint_queue q;
+  std::mutex mtx;
+  std::condition_variable cv;
+  int value = 0;
+  std::thread reader{[&] {
+    CAF_CHECK(await(q, mtx, cv));
+    auto ptr = q.try_pop();
+    CAF_CHECK(ptr != nullptr);
+    if (ptr) {
+      value = ptr->value;
+      delete ptr;
+    }
+  }};
+  // enqueue only after the reader gave up spinning and blocked
+  while (!q.blocked()) {
+    std::this_thread::yield();
+  }
+  CAF_CHECK(q.synchronized_enqueue(mtx, cv, new iint(42)));
+  reader.join();
+  CAF_CHECK_EQUAL(value, 42);
+}
+
+int main() {
+  CAF_TEST(test_single_reader_queue);
+  test_adaptive_spin_count();
+  test_synchronized_await([](iint_queue& q, std::mutex& mtx,
+                             std::condition_variable& cv) {
+    q.synchronized_await(mtx, cv);
+    return true;
+  });
+  test_synchronized_await([](iint_queue& q, std::mutex& mtx,
+                             std::condition_variable& cv) {
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    return q.synchronized_await(mtx, cv, timeout);
+  });
+  shutdown();
+  return CAF_TEST_RESULT();
+}
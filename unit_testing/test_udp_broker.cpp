@@ -0,0 +1,262 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using hello_atom = atom_constant<atom("hello")>;
+
+constexpr size_t max_size = 64;
+constexpr size_t burst_size = 100;
+
+// echoes datagrams, answers "burst" with `burst_size` datagrams,
+// and greets the client on `hello_atom`
+behavior echoing(broker* self, const actor& buddy) {
+  auto res = self->add_udp_datagram_servant(uint16_t{0});
+  auto hdl = res.first;
+  self->max_datagram_size(hdl, max_size);
+  self->send(buddy, res.second);
+  auto greeted = std::make_shared<endpoint_handle>();
+  return {
+    [=](const new_datagram_msg& msg) {
+      CAF_CHECK(msg.handle == hdl);
+      std::string str(msg.buf.begin(), msg.buf.end());
+      if (*greeted != endpoint_handle{}) {
+        // datagrams from a known endpoint carry the same handle
+        CAF_CHECK(msg.endpoint == *greeted);
+      }
+      if (str == "burst") {
+        // more datagrams than fit into a single batch
+        for (size_t i = 0; i < burst_size; ++i) {
+          auto reply = "r" + std::to_string(i);
+          self->write(hdl, msg.endpoint, reply.size(), reply.data());
+        }
+      } else if (str == "close") {
+        self->close(hdl);
+        CAF_CHECK(!self->valid(hdl));
+        self->send(buddy, ok_atom::value);
+      } else {
+        self->write(hdl, msg.endpoint, msg.buf.size(), msg.buf.data());
+      }
+    },
+    [=](hello_atom, uint16_t port) {
+      *greeted = self->add_udp_endpoint(hdl, "127.0.0.1", port);
+      std::string str = "hello";
+      self->write(hdl, *greeted, str.size(), str.data());
+      self->flush(hdl);
+    }
+  };
+}
+
+// limits learned endpoints to one and answers each datagram with the
+// position of its endpoint handle in the list of all handles seen so far
+behavior forgetful(broker* self, const actor& buddy) {
+  auto res = self->add_udp_datagram_servant(uint16_t{0});
+  auto hdl = res.first;
+  self->max_udp_endpoints(hdl, 1);
+  self->send(buddy, res.second);
+  auto seen = std::make_shared<std::vector<endpoint_handle>>();
+  auto index_of = [=](endpoint_handle x) {
+    auto i = std::find(seen->begin(), seen->end(), x);
+    if (i == seen->end()) {
+      seen->push_back(x);
+      return std::to_string(seen->size() - 1);
+    }
+    return std::to_string(i - seen->begin());
+  };
+  return {
+    [=](const new_datagram_msg& msg) {
+      std::string str(msg.buf.begin(), msg.buf.end());
+      std::string lost = "lost";
+      if (str == "probe") {
+        // the first learned endpoint has been evicted, the added one not
+        self->write(hdl, seen->at(1), lost.size(), lost.data());
+        std::string pinned = "pinned";
+        self->write(hdl, seen->at(0), pinned.size(), pinned.data());
+        self->write(hdl, msg.endpoint, str.size(), str.data());
+      } else if (str == "release") {
+        self->release_udp_endpoint(hdl, msg.endpoint);
+        self->write(hdl, msg.endpoint, lost.size(), lost.data());
+      } else {
+        auto reply = index_of(msg.endpoint);
+        self->write(hdl, msg.endpoint, reply.size(), reply.data());
+      }
+    },
+    [=](hello_atom, uint16_t port) {
+      auto ep = self->add_udp_endpoint(hdl, "127.0.0.1", port);
+      auto reply = index_of(ep);
+      self->write(hdl, ep, reply.size(), reply.data());
+      self->flush(hdl);
+    }
+  };
+}
+
+class udp_client {
+ public:
+  udp_client(uint16_t server_port) {
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    CAF_CHECK(m_fd >= 0);
+    timeval tv{5, 0};
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    memset(&m_server, 0, sizeof(m_server));
+    m_server.sin_family = AF_INET;
+    m_server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    m_server.sin_port = htons(server_port);
+    // bind to a local port by sending nothing yet
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CAF_CHECK(bind(m_fd, reinterpret_cast<sockaddr*>(&local),
+                   sizeof(local)) == 0);
+  }
+
+  ~udp_client() {
+    close(m_fd);
+  }
+
+  uint16_t port() const {
+    sockaddr_in sa;
+    socklen_t len = sizeof(sa);
+    getsockname(m_fd, reinterpret_cast<sockaddr*>(&sa), &len);
+    return ntohs(sa.sin_port);
+  }
+
+  void send(const std::string& str) {
+    auto res = sendto(m_fd, str.data(), str.size(), 0,
+                      reinterpret_cast<sockaddr*>(&m_server),
+                      sizeof(m_server));
+    CAF_CHECK_EQUAL(res, static_cast<ssize_t>(str.size()));
+  }
+
+  std::string receive() {
+    char buf[1024];
+    auto res = recv(m_fd, buf, sizeof(buf), 0);
+    if (res < 0) {
+      CAF_FAILURE("receive timed out");
+      return "";
+    }
+    return std::string(buf, static_cast<size_t>(res));
+  }
+
+ private:
+  int m_fd;
+  sockaddr_in m_server;
+};
+
+} // namespace <anonymous>
+
+void test_udp_broker() {
+  scoped_actor self;
+  auto server = spawn_io(echoing, self);
+  uint16_t port = 0;
+  self->receive(
+    [&](uint16_t x) {
+      port = x;
+    }
+  );
+  CAF_CHECK(port != 0);
+  udp_client client{port};
+  // the broker can send to endpoints it did not receive datagrams from
+  self->send(server, hello_atom::value, client.port());
+  CAF_CHECK_EQUAL(client.receive(), "hello");
+  client.send("echo");
+  CAF_CHECK_EQUAL(client.receive(), "echo");
+  // datagrams exceeding the maximum size are dropped
+  client.send(std::string(max_size + 1, 'x'));
+  client.send(std::string(max_size, 'y'));
+  CAF_CHECK_EQUAL(client.receive(), std::string(max_size, 'y'));
+  // replies exceeding a batch arrive complete and in order
+  client.send("burst");
+  for (size_t i = 0; i < burst_size; ++i) {
+    CAF_CHECK_EQUAL(client.receive(), "r" + std::to_string(i));
+  }
+  client.send("close");
+  self->receive(
+    [](ok_atom) {
+      // nop
+    }
+  );
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+void test_endpoint_eviction() {
+  scoped_actor self;
+  auto server = spawn_io(forgetful, self);
+  uint16_t port = 0;
+  self->receive(
+    [&](uint16_t x) {
+      port = x;
+    }
+  );
+  CAF_CHECK(port != 0);
+  udp_client a{port};
+  udp_client b{port};
+  udp_client c{port};
+  // added endpoints do not count towards the limit
+  self->send(server, hello_atom::value, c.port());
+  CAF_CHECK_EQUAL(c.receive(), "0");
+  a.send("x");
+  CAF_CHECK_EQUAL(a.receive(), "1");
+  a.send("x");
+  CAF_CHECK_EQUAL(a.receive(), "1");
+  // learning the endpoint of b evicts the endpoint of a
+  b.send("x");
+  CAF_CHECK_EQUAL(b.receive(), "2");
+  b.send("probe");
+  CAF_CHECK_EQUAL(b.receive(), "probe");
+  CAF_CHECK_EQUAL(c.receive(), "pinned");
+  // a receives no "lost" and gets a new handle
+  a.send("x");
+  CAF_CHECK_EQUAL(a.receive(), "3");
+  // released endpoints drop datagrams as well
+  a.send("release");
+  a.send("x");
+  CAF_CHECK_EQUAL(a.receive(), "4");
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+int main() {
+  CAF_TEST(test_udp_broker);
+  CAF_CHECK(caf_uses_requested_multiplexer());
+  test_udp_broker();
+  test_endpoint_eviction();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}
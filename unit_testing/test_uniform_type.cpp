@@ -197,10 +197,15 @@ int main() {
     check_types(append(expected,
                        "caf::io::accept_handle",
                        "caf::io::acceptor_closed_msg",
+                       "caf::io::connection_backpressure_msg",
                        "caf::io::connection_handle",
                        "caf::io::connection_closed_msg",
+                       "caf::io::datagram_handle",
+                       "caf::io::datagram_servant_closed_msg",
+                       "caf::io::endpoint_handle",
                        "caf::io::new_connection_msg",
-                       "caf::io::new_data_msg"));
+                       "caf::io::new_data_msg",
+                       "caf::io::new_datagram_msg"));
     CAF_CHECKPOINT();
   }
   // check whether enums can be announced as members
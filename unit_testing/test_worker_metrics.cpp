@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2015                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/detail/singletons.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior testee(event_based_actor* self) {
+  return {
+    [=](int x) {
+      if (x == 0) {
+        self->quit();
+      }
+      return x;
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+void test_worker_metrics() {
+  auto sched = detail::singletons::get_scheduling_coordinator();
+  {
+    scoped_actor self;
+    std::vector<actor> testees;
+    for (int i = 0; i < 100; ++i) {
+      testees.push_back(spawn(testee));
+    }
+    for (int i = 1; i <= 10; ++i) {
+      for (auto& t : testees) {
+        self->send(t, i);
+      }
+    }
+    for (auto& t : testees) {
+      self->send(t, 0);
+    }
+    int i = 0;
+    self->receive_for(i, 1100)(
+      [](int) {
+        // nop
+      }
+    );
+    self->await_all_other_actors_done();
+  }
+  // let the workers run out of work to record time spent polling
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto xs = sched->worker_metrics_snapshot();
+  CAF_CHECK_EQUAL(xs.size(), sched->num_workers());
+  uint64_t jobs_run = 0;
+  uint64_t done = 0;
+  std::chrono::nanoseconds poll_time{0};
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto& x = xs[i];
+    CAF_CHECK_EQUAL(x.id, i);
+    CAF_CHECK(x.steal_successes <= x.steal_attempts);
+    CAF_CHECK_EQUAL(x.jobs_run, x.resumed_later + x.awaiting_message + x.done);
+    CAF_CHECK_EQUAL(x.queue_size, 0);
+    jobs_run += x.jobs_run;
+    done += x.done;
+    for (auto& t : x.poll_time) {
+      poll_time += t;
+    }
+  }
+  CAF_CHECK(jobs_run >= 100);
+  CAF_CHECK(done >= 100);
+  CAF_CHECK(poll_time.count() > 0);
+}
+
+int main() {
+  CAF_TEST(test_worker_metrics);
+  test_worker_metrics();
+  await_all_actors_done();
+  shutdown();
+  return CAF_TEST_RESULT();
+}